@@ -1,7 +1,7 @@
 // FSTArray.h
 // A. Harrison Owen
 // Started: 2021-10-15
-// Updated: 2021-10-28
+// Updated: 2026-10-19
 //
 // For CS 311 Fall 2021
 // Frightfully smart array of int
@@ -14,8 +14,427 @@
 #include <algorithm>
 // For std::copy
 // For std::swap
+// For std::equal
+// For std::min
+// For std::lexicographical_compare
+// For std::lexicographical_compare_three_way
 #include <stdexcept>
 // For std::out_of_range
+// For std::logic_error
+#include <iterator>
+// For std::random_access_iterator_tag
+#include <functional>
+// For std::less
+#include <memory>
+// For std::addressof
+#include <type_traits>
+// For std::remove_const_t
+// For std::enable_if_t
+// For std::is_trivially_copyable_v
+// For std::is_trivial_v
+// For std::is_constant_evaluated
+// For std::has_unique_object_representations_v
+#include <cstring>
+// For std::memcmp
+#if __cplusplus >= 202002L
+#include <compare>
+// For std::three_way_comparable
+// For std::weak_ordering
+#endif
+#ifdef FSTARRAY_BUFFER_CACHE
+#include "fstbuffercache.h"
+// For class template FSTBufferCache
+#endif
+#ifdef FSTARRAY_REGISTRY
+#include "fstregistry.h"
+// For class FSTRegistry
+#include <typeinfo>
+// For typeid
+#endif
+
+
+// constexpr support
+// Under C++20, every member of FSTArray (and of its hardening-mode
+//  iterator) is constexpr, so arrays may be made, resized, and modified
+//  during constant evaluation, e.g., to compute a table at compile time.
+//  As for any C++20 constexpr allocation, the array must be destroyed
+//  before the evaluation ends; copy results out to an FSTFixedArray
+//  (fstfixedarray.h) or a scalar to keep them. During constant
+//  evaluation, buffers are value-initialized and the buffer cache is
+//  not used. Under C++17, or in registry mode (below), FSTARRAY_CONSTEXPR
+//  expands to nothing.
+
+#if __cplusplus >= 202002L && !defined(FSTARRAY_REGISTRY)
+#define FSTARRAY_CONSTEXPR constexpr
+#else
+#define FSTARRAY_CONSTEXPR
+#endif
+
+
+// Hardening mode
+// Define FSTARRAY_HARDENED before including this header (or on the
+//  compiler command line) to have FSTArray check its preconditions:
+//  indices passed to operator[], iterators passed to insert & erase,
+//  and dereferenced iterators. Iterators then carry a generation
+//  count, so use of an iterator invalidated by a later modification of
+//  the array is detected. Failed checks throw std::out_of_range (bad
+//  index or position) or std::logic_error (stale iterator).
+// With FSTARRAY_HARDENED undefined, iterators are raw pointers and the
+//  checking functions are empty, so no code is generated for them.
+
+
+// Buffer cache mode
+// Define FSTARRAY_BUFFER_CACHE to have FSTArray objects of trivial
+//  type take buffers from, and return them to, a thread-local cache
+//  (see fstbuffercache.h) instead of calling new [] & delete [] each
+//  time. Capacities are then rounded up to powers of two, so buffers
+//  fit the cache's capacity classes. Use FSTBufferCache<T>::local() to
+//  set limits, turn the cache off, or flush it.
+//  Arrays that outlive their thread's cache (e.g., globals, destroyed
+//  after the main thread's cache) free buffers with delete [] instead.
+
+
+// Registry mode
+// Define FSTARRAY_REGISTRY to have every FSTArray object add itself to
+//  a global registry (see fstregistry.h) while it lives. Then
+//  FSTRegistry::global().report(std::cout) shows how much allocated
+//  capacity is slack, a histogram of size/capacity ratios, and the
+//  arrays wasting the most; shrinkIdle() gives slack back. Each ctor &
+//  dctor then takes a mutex, and FSTArray is not constexpr. Off by
+//  default: with FSTARRAY_REGISTRY undefined, nothing is registered.
+
+#ifdef FSTARRAY_HARDENED
+
+// *********************************************************************
+// class FSTArrayCheckedIter - Class definition
+// *********************************************************************
+
+
+// class FSTArrayCheckedIter
+// Random-access iterator for FSTArray in hardening mode. Holds a
+//  pointer to its array, a pointer to an item, and the array's
+//  generation count when the iterator was made.
+// Invariants:
+//     _owner == nullptr, or _owner points to the array this iterator
+//      was obtained from.
+// Requirements on Types:
+//     Container is FSTArray<...>; Value is Container::value_type,
+//      possibly const.
+template <typename Container, typename Value>
+class FSTArrayCheckedIter {
+
+    // Other instantiation, for iterator -> const_iterator conversion
+    template <typename C, typename V>
+    friend class FSTArrayCheckedIter;
+
+// ***** FSTArrayCheckedIter: types *****
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_const_t<Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value *;
+    using reference = Value &;
+    using generation_type = typename Container::generation_type;
+
+// ***** FSTArrayCheckedIter: ctors *****
+public:
+
+    // Default ctor
+    // Makes a singular iterator; it may not be dereferenced.
+    // No-Throw Guarantee
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter() noexcept
+        :_owner(nullptr),
+         _ptr(nullptr),
+         _generation(0)
+    {}
+
+    // Ctor from owner & pointer
+    // Used by FSTArray only.
+    // No-Throw Guarantee
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter(const Container * owner,
+                                           Value * ptr) noexcept
+        :_owner(owner),
+         _ptr(ptr),
+         _generation(owner->_generation)
+    {}
+
+    // Converting ctor: iterator -> const_iterator
+    // No-Throw Guarantee
+    template <typename OtherValue,
+              typename = std::enable_if_t<
+                  std::is_const_v<Value>
+               && std::is_same_v<OtherValue, value_type>>>
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter(
+        const FSTArrayCheckedIter<Container, OtherValue> & other) noexcept
+        :_owner(other._owner),
+         _ptr(other._ptr),
+         _generation(other._generation)
+    {}
+
+// ***** FSTArrayCheckedIter: general public functions *****
+public:
+
+    // check
+    // Throws std::logic_error if this iterator is singular or has been
+    //  invalidated; throws std::out_of_range if it does not point into
+    //  [begin(), end()) of its array -- or [begin(), end()] when
+    //  allowEnd.
+    // Strong Guarantee
+    FSTARRAY_CONSTEXPR void check(bool allowEnd) const
+    {
+        if (_owner == nullptr)
+            throw std::logic_error("FSTArray: singular iterator");
+        if (_generation != _owner->_generation)
+            throw std::logic_error("FSTArray: invalidated iterator");
+        const Value * first = _owner->_data;
+        const Value * last = first + _owner->_size;
+        if (_ptr < first || _ptr > last || (_ptr == last && !allowEnd))
+            throw std::out_of_range("FSTArray: iterator out of range");
+    }
+
+    // owner
+    // Return pointer to the array this iterator belongs to.
+    // No-Throw Guarantee
+    FSTARRAY_CONSTEXPR const Container * owner() const noexcept
+    {
+        return _owner;
+    }
+
+// ***** FSTArrayCheckedIter: dereference operators *****
+public:
+
+    // operator* & operator->
+    // Strong Guarantee
+    FSTARRAY_CONSTEXPR reference operator*() const
+    {
+        check(false);
+        return *_ptr;
+    }
+
+    FSTARRAY_CONSTEXPR pointer operator->() const
+    {
+        check(false);
+        return _ptr;
+    }
+
+    // operator[]
+    // Strong Guarantee
+    FSTARRAY_CONSTEXPR reference operator[](difference_type n) const
+    {
+        return *(*this + n);
+    }
+
+// ***** FSTArrayCheckedIter: arithmetic operators *****
+public:
+
+    // No-Throw Guarantee for all of these; checking is done on use.
+
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter & operator++() noexcept
+    {
+        ++_ptr;
+        return *this;
+    }
+
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter operator++(int) noexcept
+    {
+        auto save = *this;
+        ++_ptr;
+        return save;
+    }
+
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter & operator--() noexcept
+    {
+        --_ptr;
+        return *this;
+    }
+
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter operator--(int) noexcept
+    {
+        auto save = *this;
+        --_ptr;
+        return save;
+    }
+
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter & operator+=(difference_type n)
+        noexcept
+    {
+        _ptr += n;
+        return *this;
+    }
+
+    FSTARRAY_CONSTEXPR FSTArrayCheckedIter & operator-=(difference_type n)
+        noexcept
+    {
+        _ptr -= n;
+        return *this;
+    }
+
+    friend FSTARRAY_CONSTEXPR FSTArrayCheckedIter operator+(
+        FSTArrayCheckedIter it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend FSTARRAY_CONSTEXPR FSTArrayCheckedIter operator+(
+        difference_type n, FSTArrayCheckedIter it) noexcept
+    {
+        return it += n;
+    }
+
+    friend FSTARRAY_CONSTEXPR FSTArrayCheckedIter operator-(
+        FSTArrayCheckedIter it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    // Difference & comparisons work between iterator & const_iterator.
+    template <typename OtherValue>
+    FSTARRAY_CONSTEXPR difference_type operator-(
+        const FSTArrayCheckedIter<Container, OtherValue> & other) const
+        noexcept
+    {
+        return _ptr - other._ptr;
+    }
+
+    template <typename OtherValue>
+    FSTARRAY_CONSTEXPR bool operator==(
+        const FSTArrayCheckedIter<Container, OtherValue> & other) const
+        noexcept
+    {
+        return _ptr == other._ptr;
+    }
+
+    template <typename OtherValue>
+    FSTARRAY_CONSTEXPR bool operator!=(
+        const FSTArrayCheckedIter<Container, OtherValue> & other) const
+        noexcept
+    {
+        return _ptr != other._ptr;
+    }
+
+    template <typename OtherValue>
+    FSTARRAY_CONSTEXPR bool operator<(
+        const FSTArrayCheckedIter<Container, OtherValue> & other) const
+        noexcept
+    {
+        return _ptr < other._ptr;
+    }
+
+    template <typename OtherValue>
+    FSTARRAY_CONSTEXPR bool operator>(
+        const FSTArrayCheckedIter<Container, OtherValue> & other) const
+        noexcept
+    {
+        return _ptr > other._ptr;
+    }
+
+    template <typename OtherValue>
+    FSTARRAY_CONSTEXPR bool operator<=(
+        const FSTArrayCheckedIter<Container, OtherValue> & other) const
+        noexcept
+    {
+        return _ptr <= other._ptr;
+    }
+
+    template <typename OtherValue>
+    FSTARRAY_CONSTEXPR bool operator>=(
+        const FSTArrayCheckedIter<Container, OtherValue> & other) const
+        noexcept
+    {
+        return _ptr >= other._ptr;
+    }
+
+// ***** FSTArrayCheckedIter: data members *****
+private:
+
+    const Container * _owner;       // Array we iterate over
+    Value *           _ptr;         // Item we point to
+    generation_type   _generation;  // _owner->_generation when made
+
+};  // End class FSTArrayCheckedIter
+
+#endif  //#ifdef FSTARRAY_HARDENED
+
+// *********************************************************************
+// Shrink policies
+// *********************************************************************
+
+
+// A shrink policy is the optional second template argument of FSTArray.
+// It decides whether the array gives back capacity after it gets
+// smaller (resize, erase, unordered_erase, erase_if, pop_back). It has:
+//     static constexpr bool shrinks;
+//         false: never shrink; no code is generated for it.
+//     static constexpr std::size_t target(std::size_t size,
+//                                         std::size_t capacity) noexcept;
+//         Return the capacity to shrink to, or capacity for none.
+// Shrinking uses the same reallocation as growth. If that throws, the
+// array keeps its larger buffer and the operation still succeeds.
+
+
+// struct FSTNoShrink
+// Never shrink: resize smaller, erase & pop_back keep the buffer (and
+//  item addresses). The default.
+struct FSTNoShrink {
+    static constexpr bool shrinks = false;
+
+    static constexpr std::size_t target(std::size_t,
+                                        std::size_t capacity) noexcept
+    {
+        return capacity;
+    }
+};
+
+
+// struct FSTShrinkBelow
+// Shrink when size < capacity/divisor, to max(2*size, minCapacity):
+//  the capacity growth from that size would give. Since growth doubles
+//  when size reaches capacity, and shrinking needs size to fall below
+//  a quarter (for divisor 4) of it, at least capacity/4 operations
+//  separate any two reallocations. So push_back & pop_back stay
+//  amortized O(1), and alternating them cannot thrash.
+// Requirements on Types:
+//     divisor >= 3 (so a shrunk array is not at once due for another).
+template <std::size_t divisor=4, std::size_t minCapacity=16>
+struct FSTShrinkBelow {
+    static_assert(divisor >= 3, "FSTShrinkBelow divisor must be >= 3");
+
+    static constexpr bool shrinks = true;
+
+    static constexpr std::size_t target(std::size_t size,
+                                        std::size_t capacity) noexcept
+    {
+        if (capacity <= minCapacity || size >= capacity / divisor)
+            return capacity;
+        std::size_t want = 2 * size;
+        return want < minCapacity ? minCapacity : want;
+    }
+};
+
+// Shrink to half capacity (or less) below a quarter full
+using FSTShrinkQuarter = FSTShrinkBelow<4>;
+
+
+// Comparison helpers
+// BYTEWISE_EQUAL<T>: == on T compares bytes (integers, enums &
+//  pointers with no padding bits), so arrays of T may be compared with
+//  std::memcmp. BYTE_ORDERED<T>: likewise for < (1-byte unsigned
+//  types, which memcmp orders as unsigned char).
+namespace fst_array_detail {
+
+    template <typename T>
+    constexpr bool BYTEWISE_EQUAL =
+        (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)
+     && std::has_unique_object_representations_v<T>;
+
+    template <typename T>
+    constexpr bool BYTE_ORDERED =
+        std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 1
+     && std::has_unique_object_representations_v<T>;
+
+}  // End namespace fst_array_detail
+
 
 // *********************************************************************
 // class FSTArray - Class definition
@@ -32,7 +451,8 @@
 //      _capacity == 0, in which case _data may be nullptr.
 //
 // value_type = value type of array elements
-template <typename valType>
+// shrinkPolicy = when to give back capacity (see "Shrink policies")
+template <typename valType, typename shrinkPolicy=FSTNoShrink>
 class FSTArray {
 
 // ***** FSTArray: types *****
@@ -42,10 +462,22 @@ public:
     using value_type = valType;
     // size_type: type of sizes & indices
     using size_type = std::size_t;
+    // shrink_policy: when to give back capacity
+    using shrink_policy = shrinkPolicy;
 
     // iterator, const_iterator: random-access iterator types
+    // Raw pointers, except in hardening mode (see top of file).
+#ifdef FSTARRAY_HARDENED
+    using generation_type = unsigned long;
+    using iterator = FSTArrayCheckedIter<FSTArray, value_type>;
+    using const_iterator = FSTArrayCheckedIter<FSTArray, const value_type>;
+
+    friend iterator;
+    friend const_iterator;
+#else
     using iterator = value_type *;
     using const_iterator = const value_type *;
+#endif
 
 // ***** FSTArray: internal-use constants *****
 private:
@@ -58,35 +490,38 @@ public:
 
     // Default ctor & ctor from size
     // Strong Guarantee
-    explicit FSTArray(size_type size=0)
-        :_capacity(std::max(size, size_type(DEFAULT_CAP))),
+    FSTARRAY_CONSTEXPR explicit FSTArray(size_type size=0)
+        :_capacity(_roundCapacity(std::max(size, size_type(DEFAULT_CAP)))),
             // _capacity must be declared before _data
          _size(size),
          _data(_capacity == 0 ? nullptr
-                              : new value_type[_capacity])
-    {}
+                              : _allocate(_capacity))
+    {
+        _register();
+    }
 
     // Copy ctor
     // Strong Guarantee
-    FSTArray(const FSTArray & other):
+    FSTARRAY_CONSTEXPR FSTArray(const FSTArray & other):
         _capacity(other._capacity),
         _size(other._size),
         _data(other._capacity == 0 ? nullptr
-            : new value_type[other._capacity])
+            : _allocate(other._capacity))
     {
         try {
             std::copy(other.begin(), other.end(), begin());
         }
         catch(...){
             //if it fails and exits...delete this pointer?
-            delete [] _data;
+            _deallocate(_data, _capacity);
             throw;
         }
+        _register();
     }
 
     // Move ctor
     // No-Throw Guarantee
-    FSTArray(FSTArray && other) noexcept
+    FSTARRAY_CONSTEXPR FSTArray(FSTArray && other) noexcept
             :_capacity(other._capacity),
              _size(other._size),
              _data(other._data)
@@ -94,11 +529,13 @@ public:
         other._capacity = 0;
         other._size = 0;
         other._data = nullptr;
+        other._invalidate();
+        _register();
     }
 
     // Copy assignment operator
     // No-throw Guarantee
-    FSTArray & operator=(const FSTArray & other)
+    FSTARRAY_CONSTEXPR FSTArray & operator=(const FSTArray & other)
     {
         FSTArray copyRhs(other);
         swap(copyRhs);
@@ -107,17 +544,38 @@ public:
 
     // Move assignment operator
     // No-Throw Guarantee
-    FSTArray & operator=(FSTArray && other) noexcept
+    FSTARRAY_CONSTEXPR FSTArray & operator=(FSTArray && other) noexcept
     {
         swap(other);
         return *this; // DUMMY
     }
 
+    // Ctor & op= from expression
+    // For lazy arithmetic expressions (fstarray_expr.h): evaluates expr
+    //  in one pass into this array's buffer. Guarantees as for
+    //  FSTExpr::assignTo.
+    template <typename Expr,
+              typename = typename Expr::fst_expression_tag>
+    FSTArray(const Expr & expr)
+        :FSTArray(expr.size())
+    {
+        expr.assignTo(*this);
+    }
+
+    template <typename Expr,
+              typename = typename Expr::fst_expression_tag>
+    FSTArray & operator=(const Expr & expr)
+    {
+        expr.assignTo(*this);
+        return *this;
+    }
+
     // Dctor
     // No-Throw Guarantee
-    ~FSTArray()
+    FSTARRAY_CONSTEXPR ~FSTArray()
     {
-        delete [] _data;
+        _unregister();
+        _deallocate(_data, _capacity);
     }
 
 // ***** FSTArray: general public operators *****
@@ -125,27 +583,48 @@ public:
 
     // operator[] - non-const & const
     // Pre:
-    //     index must be non-zero
-    //     index must not be greater than size of array
+    //     index must be less than size of array
+    //      (checked in hardening mode)
     // No-Throw Guarantee
     // Exception Neutral
-    value_type & operator[](size_type index)
+    FSTARRAY_CONSTEXPR value_type & operator[](size_type index)
     {
+        _checkIndex(index);
         return _data[index];
     }
 
-    const value_type & operator[](size_type index) const
+    FSTARRAY_CONSTEXPR const value_type & operator[](size_type index) const
     {
+        _checkIndex(index);
         return _data[index];
     }
 
 // ***** FSTArray: general public functions *****
 public:
 
+    // at - non-const & const
+    // Like operator[], but always checks index.
+    // Throws std::out_of_range if index >= size().
+    // Strong Guarantee
+    // Exception neutral
+    FSTARRAY_CONSTEXPR value_type & at(size_type index)
+    {
+        if (index >= _size)
+            throw std::out_of_range("FSTArray::at: index out of range");
+        return _data[index];
+    }
+
+    FSTARRAY_CONSTEXPR const value_type & at(size_type index) const
+    {
+        if (index >= _size)
+            throw std::out_of_range("FSTArray::at: index out of range");
+        return _data[index];
+    }
+
     // size
     // No-Throw Guarantee
     // Exception neutral
-    [[nodiscard]] size_type size() const noexcept
+    [[nodiscard]] FSTARRAY_CONSTEXPR size_type size() const noexcept
     {
         return _size;
     }
@@ -153,31 +632,42 @@ public:
     // empty
     // No-Throw Guarantee
     // Exception neutral
-    [[maybe_unused]] [[nodiscard]] bool empty() const noexcept
+    [[maybe_unused]] [[nodiscard]] FSTARRAY_CONSTEXPR bool empty() const
+        noexcept
     {
         return size() == 0;
     }
 
+    // capacity
+    // Number of items the array can hold before resize reallocates.
+    //  Note that resize reallocates when the new size reaches capacity.
+    // No-Throw Guarantee
+    // Exception neutral
+    [[nodiscard]] FSTARRAY_CONSTEXPR size_type capacity() const noexcept
+    {
+        return _capacity;
+    }
+
     // begin - non-const & const
     // No-Throw Guarantee
     // Exception neutral
-    iterator begin() noexcept
+    FSTARRAY_CONSTEXPR iterator begin() noexcept
     {
-        return _data;
+        return _makeIter(_data);
     }
-    const_iterator begin() const noexcept
+    FSTARRAY_CONSTEXPR const_iterator begin() const noexcept
     {
-        return _data;
+        return _makeIter(_data);
     }
 
     // end - non-const & const
     // No-Throw Guarantee
     // Exception neutral
-    iterator end() noexcept
+    FSTARRAY_CONSTEXPR iterator end() noexcept
     {
         return begin() + size();
     }
-    const_iterator end() const noexcept
+    FSTARRAY_CONSTEXPR const_iterator end() const noexcept
     {
         return begin() + size();
     }
@@ -188,43 +678,48 @@ public:
 // Exception neutral
 // Pre:
 //     newsize must be non-zero
-    void resize(size_type newsize)
+    FSTARRAY_CONSTEXPR void resize(size_type newsize)
     {
+        bool smaller = newsize < _size;
         if(newsize >= _capacity) {
-            _capacity = 2*newsize;
-            auto *newArray = new value_type[_capacity];
-            try {
-                std::copy(_data, _data+size(), newArray);
-                //clean up _data ptr
-                delete[] _data;
-                _data = newArray;
-            }
-            catch(...){
-                // if copy fails, delete newArray pointer and exit
-                // copy should not destroy original data
-                delete[] newArray;
-                throw;
-            }
+            _reallocate(_roundCapacity(2*newsize));
         }
         _size = newsize;
+        _invalidate();
+        // Only shrinking may give space back, so that growth (and
+        //  push_back) keeps capacity from reserve
+        if (smaller)
+            _maybeShrink();
 
     }
 
 
 // insert
-// Strong Guarantee
+// Strong Guarantee, except: if pos != end() and swapping two items
+//  throws, Basic Guarantee only
 // Exception neutral
 // Pre:
 //     iterator must be non-zero and smaller than size
-    iterator insert(iterator pos, const value_type & item)
+    FSTARRAY_CONSTEXPR iterator insert(iterator pos, const value_type & item)
     {
+        _checkIterator(pos, true);
         // if data is reallocated, then we will have to
         // save distance from iterator to begin()
         auto tempPosition = pos - begin();
+        // item may be one of ours; resize may then free it
+        auto oldSize = size();
+        auto itemIndex = _indexOf(item);
         resize(size()+1);
-        *(end()-1) = item;
+        try {
+            *(end()-1) = (itemIndex < oldSize) ? _data[itemIndex] : item;
+        }
+        catch(...){
+            // undo the resize; a reallocation is harmless
+            --_size;
+            throw;
+        }
 
-        if(tempPosition != size()){
+        if(size_type(tempPosition) != size()){
             std::rotate(begin()+tempPosition, end()-1, end());
         }
 
@@ -233,10 +728,13 @@ public:
 
 
 // erase
-// Strong Guarantee
+// Strong Guarantee, except: if pos != end()-1 and swapping two items
+//  throws, Basic Guarantee only
 // Exception neutral
-    iterator erase(iterator pos)
+    FSTARRAY_CONSTEXPR iterator erase(iterator pos)
     {
+        _checkIterator(pos, false);
+        auto tempPosition = pos - begin();
         try {
             if (pos != end()) {
                 std::rotate(pos, pos + 1, end());
@@ -246,24 +744,122 @@ public:
             throw;
         }
         _size--;
-        return pos;
+        _invalidate();
+        _maybeShrink();
+        // pos may now be stale; hand back a fresh iterator
+        return begin() + tempPosition;
+    }
+
+
+    // unordered_erase
+    // Remove the item at pos by copying the last item into its place.
+    // Order of the remaining items is not preserved. O(1).
+    // Pre:
+    //     pos is dereferenceable (checked in hardening mode)
+    // Strong Guarantee
+    // Exception neutral
+    FSTARRAY_CONSTEXPR iterator unordered_erase(iterator pos)
+    {
+        _checkIterator(pos, false);
+        auto tempPosition = pos - begin();
+        if (pos != end()-1)
+            *pos = *(end()-1);  // Only this can throw; nothing changed yet
+        --_size;
+        _invalidate();
+        _maybeShrink();
+        return begin()+tempPosition;
+    }
+
+    // erase_if
+    // Remove every item for which pred returns true, keeping the order
+    //  of the others. Single pass: pred is called once per item, and
+    //  each surviving item is written at most once. Trivially copyable
+    //  items are compacted without branching on pred.
+    // Returns the number of items removed.
+    // Basic Guarantee: if pred or a copy throws, the items already
+    //  judged are removed or kept as pred said, and the rest are kept.
+    // Exception neutral
+    template <typename Pred>
+    FSTARRAY_CONSTEXPR size_type erase_if(Pred pred)
+    {
+        size_type in = 0;   // Next item to judge
+        size_type out = 0;  // Next place for a surviving item
+        try {
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                // Always write; advance only past survivors
+                for (; in < _size; ++in) {
+                    value_type item = _data[in];
+                    _data[out] = item;
+                    out += size_type(!pred(item));
+                }
+            }
+            else {
+                for (; in < _size; ++in) {
+                    if (!pred(_data[in])) {
+                        if (out != in)
+                            _data[out] = _data[in];
+                        ++out;
+                    }
+                }
+            }
+        }
+        catch(...){
+            // keep the unjudged items after the survivors
+            _size = std::copy(_data+in, _data+_size, _data+out) - _data;
+            _invalidate();
+            throw;
+        }
+        size_type removed = _size - out;
+        _size = out;
+        _invalidate();
+        _maybeShrink();
+        return removed;
     }
 
+    // shrink_to_fit
+    // Reduce capacity to size() (rounded up to a power of two in buffer
+    //  cache mode), releasing the rest. A later push_back reallocates.
+    //  Does nothing if capacity is already that small.
+    // Strong Guarantee
+    // Exception neutral
+    FSTARRAY_CONSTEXPR void shrink_to_fit()
+    {
+        auto newCapacity = _roundCapacity(_size);
+        if (newCapacity < _capacity)
+            _reallocate(newCapacity);
+    }
+
+    // reserve
+    // Make capacity at least newCapacity, so that the array can grow to
+    //  size newCapacity-1 without reallocating (resize reallocates when
+    //  the new size reaches capacity). Does nothing if capacity is
+    //  already that large. Growth keeps the space; a shrink policy may
+    //  give it back only on a later operation that makes the array
+    //  smaller (resize smaller, erase, pop_back, ...).
+    // Strong Guarantee
+    // Exception neutral
+    FSTARRAY_CONSTEXPR void reserve(size_type newCapacity)
+    {
+        if (newCapacity > _capacity)
+            _reallocate(_roundCapacity(newCapacity));
+    }
 
 // swap
 // No-throw Guarantee
 // Exception neutral
-    void swap(FSTArray & other) noexcept
+    FSTARRAY_CONSTEXPR void swap(FSTArray & other) noexcept
     {
             std::swap(_data, other._data);
             std::swap(_size, other._size);
             std::swap(_capacity, other._capacity);
+            _invalidate();
+            other._invalidate();
     }
 
     // push_back
     // Strong Guarantee
     // Exception neutral
-    void push_back(const value_type & item)
+    FSTARRAY_CONSTEXPR void push_back(const value_type & item)
     {
         insert(end(), item);
     }
@@ -271,11 +867,377 @@ public:
     // pop_back
     // Strong Guarantee
     // Exception neutral
-    void pop_back()
+    FSTARRAY_CONSTEXPR void pop_back()
     {
         erase(end()-1);
     }
 
+// ***** FSTArray: comparisons *****
+public:
+
+    // operator==, operator!=
+    // Equal if same size & items equal, in order. Items of integer,
+    //  enum & pointer types are compared with std::memcmp, which the C
+    //  library vectorizes; others with operator==.
+    // Requirements on Types:
+    //     value_type has operator==.
+    // Exception neutral
+    friend FSTARRAY_CONSTEXPR bool operator==(const FSTArray & a,
+                                              const FSTArray & b)
+    {
+        if (a._size != b._size)
+            return false;
+        if constexpr (fst_array_detail::BYTEWISE_EQUAL<value_type>)
+        {
+            if (!_constantEvaluated())
+                return a._size == 0
+                    || std::memcmp(a._data, b._data,
+                                   a._size * sizeof(value_type)) == 0;
+        }
+        return std::equal(a._data, a._data + a._size, b._data);
+    }
+
+#if __cplusplus >= 202002L
+    // operator<=>
+    // Lexicographic order, by items' operator<=> (or operator<, for
+    //  items without one, giving std::weak_ordering). <, >, <=, >= & !=
+    //  are rewritten in terms of this & operator==. Arrays of 1-byte
+    //  unsigned items are compared with std::memcmp.
+    // Requirements on Types:
+    //     value_type has operator<=> or operator<.
+    // Exception neutral
+    friend FSTARRAY_CONSTEXPR auto operator<=>(const FSTArray & a,
+                                               const FSTArray & b)
+    {
+        if constexpr (std::three_way_comparable<value_type>)
+        {
+            if constexpr (fst_array_detail::BYTE_ORDERED<value_type>)
+            {
+                if (!_constantEvaluated())
+                {
+                    size_type n = std::min(a._size, b._size);
+                    int c = n == 0 ? 0 : std::memcmp(a._data, b._data, n);
+                    if (c != 0)
+                        return c <=> 0;
+                    return a._size <=> b._size;
+                }
+            }
+            return std::lexicographical_compare_three_way(
+                a._data, a._data + a._size, b._data, b._data + b._size);
+        }
+        else
+        {
+            size_type n = std::min(a._size, b._size);
+            for (size_type i = 0; i < n; ++i)
+            {
+                if (a._data[i] < b._data[i])
+                    return std::weak_ordering::less;
+                if (b._data[i] < a._data[i])
+                    return std::weak_ordering::greater;
+            }
+            return std::weak_ordering(a._size <=> b._size);
+        }
+    }
+#else
+    // operator!=
+    // Under C++20, rewritten as !(a == b).
+    friend bool operator!=(const FSTArray & a,
+                           const FSTArray & b)
+    {
+        return !(a == b);
+    }
+
+    // operator<, operator>, operator<=, operator>=
+    // Lexicographic order, by items' operator<.
+    // Requirements on Types:
+    //     value_type has operator<.
+    // Exception neutral
+    friend bool operator<(const FSTArray & a,
+                          const FSTArray & b)
+    {
+        return std::lexicographical_compare(a._data, a._data + a._size,
+                                            b._data, b._data + b._size);
+    }
+
+    friend bool operator>(const FSTArray & a,
+                          const FSTArray & b)
+    {
+        return b < a;
+    }
+
+    friend bool operator<=(const FSTArray & a,
+                           const FSTArray & b)
+    {
+        return !(b < a);
+    }
+
+    friend bool operator>=(const FSTArray & a,
+                           const FSTArray & b)
+    {
+        return !(a < b);
+    }
+#endif
+
+// ***** FSTArray: allocation helpers *****
+private:
+
+    // All buffers are obtained & released through these, so that the
+    // buffer cache (FSTARRAY_BUFFER_CACHE) can intercept them. Without
+    // the cache they are plain new [] & delete [].
+
+    // _roundCapacity
+    // Return capacity to actually allocate for a wanted capacity.
+    // No-Throw Guarantee
+    static FSTARRAY_CONSTEXPR size_type _roundCapacity(size_type cap) noexcept
+    {
+#ifdef FSTARRAY_BUFFER_CACHE
+        if constexpr (std::is_trivial_v<value_type>)
+            return FSTBufferCache<value_type>::roundCapacity(cap);
+#endif
+        return cap;
+    }
+
+    // _allocate
+    // Return a buffer of cap items.
+    // Strong Guarantee
+    // Exception neutral
+    static FSTARRAY_CONSTEXPR value_type * _allocate(size_type cap)
+    {
+        if (_constantEvaluated())
+            return new value_type[cap]();  // No indeterminate values
+#ifdef FSTARRAY_BUFFER_CACHE
+        if constexpr (std::is_trivial_v<value_type>) {
+            auto * cache = FSTBufferCache<value_type>::localIfAlive();
+            auto * buf = cache == nullptr ? nullptr : cache->take(cap);
+            if (buf != nullptr)
+                return buf;
+        }
+#endif
+        return new value_type[cap];
+    }
+
+    // _deallocate
+    // Release a buffer of cap items from _allocate; buf may be nullptr.
+    // No-Throw Guarantee
+    static FSTARRAY_CONSTEXPR void _deallocate(
+        value_type * buf,
+        [[maybe_unused]] size_type cap) noexcept
+    {
+#ifdef FSTARRAY_BUFFER_CACHE
+        if (_constantEvaluated()) {
+            delete [] buf;
+            return;
+        }
+        if constexpr (std::is_trivial_v<value_type>) {
+            // After the thread's cache is destroyed (e.g., for a global
+            //  array), free the buffer directly
+            auto * cache = FSTBufferCache<value_type>::localIfAlive();
+            if (buf != nullptr && cache != nullptr && cache->give(buf, cap))
+                return;
+        }
+#endif
+        delete [] buf;
+    }
+
+    // _indexOf
+    // Return the index of item if it is one of our items; otherwise,
+    //  return _size. Lets insert keep using item after reallocating.
+    // No-Throw Guarantee
+    FSTARRAY_CONSTEXPR size_type _indexOf(const value_type & item) const
+        noexcept
+    {
+        const value_type * p = std::addressof(item);
+        if (_constantEvaluated()) {
+            // Only == may compare unrelated pointers here
+            for (size_type i = 0; i < _size; ++i) {
+                if (_data + i == p)
+                    return i;
+            }
+            return _size;
+        }
+        std::less<const value_type *> before;
+        if (before(p, _data) || !before(p, _data + _size))
+            return _size;
+        return size_type(p - _data);
+    }
+
+    // _reallocate
+    // Move our items to a new buffer of newCapacity items; release the
+    //  old one. The only place an existing buffer is replaced.
+    // Pre:
+    //     newCapacity >= _size.
+    // Strong Guarantee
+    // Exception neutral
+    FSTARRAY_CONSTEXPR void _reallocate(size_type newCapacity)
+    {
+        // _capacity is only updated once nothing else can throw
+        auto *newArray = newCapacity == 0 ? nullptr
+                                          : _allocate(newCapacity);
+        try {
+            if (newArray != nullptr)
+                std::copy(_data, _data+_size, newArray);
+        }
+        catch(...){
+            // copy should not destroy original data
+            _deallocate(newArray, newCapacity);
+            throw;
+        }
+        _deallocate(_data, _capacity);
+        _data = newArray;
+        _capacity = newCapacity;
+        _invalidate();
+    }
+
+    // _maybeShrink
+    // Reallocate to the capacity the shrink policy asks for, if smaller.
+    //  If that fails, keep the current buffer.
+    // No-Throw Guarantee
+    FSTARRAY_CONSTEXPR void _maybeShrink() noexcept
+    {
+        if constexpr (shrink_policy::shrinks) {
+            // Compare after rounding, or the buffer cache's rounding can
+            //  turn a shrink into a reallocation to the same capacity
+            auto target = _roundCapacity(
+                shrink_policy::target(_size, _capacity));
+            if (target < _capacity) {
+                try {
+                    _reallocate(target);
+                }
+                catch(...){
+                    // shrinking is only an optimization
+                }
+            }
+        }
+    }
+
+    // _constantEvaluated
+    // Return true during constant evaluation (C++20 only).
+    // No-Throw Guarantee
+    static FSTARRAY_CONSTEXPR bool _constantEvaluated() noexcept
+    {
+#ifdef __cpp_lib_is_constant_evaluated
+        return std::is_constant_evaluated();
+#else
+        return false;
+#endif
+    }
+
+// ***** FSTArray: hardening-mode helpers *****
+private:
+
+    // These check preconditions & track invalidation when
+    // FSTARRAY_HARDENED is defined. Otherwise they do nothing, and
+    // inline away entirely.
+
+    // _checkIndex
+    // Throws std::out_of_range if hardened and index >= size().
+    FSTARRAY_CONSTEXPR void _checkIndex([[maybe_unused]] size_type index) const
+    {
+#ifdef FSTARRAY_HARDENED
+        if (index >= _size)
+            throw std::out_of_range("FSTArray: index out of range");
+#endif
+    }
+
+    // _checkIterator
+    // If hardened, throws unless pos is a valid iterator into *this,
+    //  dereferenceable unless allowEnd.
+    FSTARRAY_CONSTEXPR void _checkIterator(
+        [[maybe_unused]] const_iterator pos,
+        [[maybe_unused]] bool allowEnd) const
+    {
+#ifdef FSTARRAY_HARDENED
+        if (pos.owner() != this)
+            throw std::logic_error("FSTArray: iterator from another array");
+        pos.check(allowEnd);
+#endif
+    }
+
+    // _invalidate
+    // Mark all existing iterators into *this as stale (if hardened).
+    // No-Throw Guarantee
+    FSTARRAY_CONSTEXPR void _invalidate() noexcept
+    {
+#ifdef FSTARRAY_HARDENED
+        ++_generation;
+#endif
+    }
+
+    // _makeIter - non-const & const
+    // Wrap a pointer into our array as an iterator.
+    // No-Throw Guarantee
+    FSTARRAY_CONSTEXPR iterator _makeIter(value_type * ptr) noexcept
+    {
+#ifdef FSTARRAY_HARDENED
+        return iterator(this, ptr);
+#else
+        return ptr;
+#endif
+    }
+
+    FSTARRAY_CONSTEXPR const_iterator _makeIter(const value_type * ptr) const
+        noexcept
+    {
+#ifdef FSTARRAY_HARDENED
+        return const_iterator(this, ptr);
+#else
+        return ptr;
+#endif
+    }
+
+// ***** FSTArray: registry-mode helpers *****
+private:
+
+    // These add *this to, and remove it from, the global registry when
+    // FSTARRAY_REGISTRY is defined. Otherwise they do nothing.
+
+    // _register, _unregister
+    // No-Throw Guarantee
+    FSTARRAY_CONSTEXPR void _register() noexcept
+    {
+#ifdef FSTARRAY_REGISTRY
+        _registryNode.owner = this;
+        _registryNode.type = &_registryType;
+        FSTRegistry::global().add(_registryNode);
+#endif
+    }
+
+    FSTARRAY_CONSTEXPR void _unregister() noexcept
+    {
+#ifdef FSTARRAY_REGISTRY
+        FSTRegistry::global().remove(_registryNode);
+#endif
+    }
+
+#ifdef FSTARRAY_REGISTRY
+    // _registryShrink
+    // Shrink the array at p to capacity cap (>= its size), for
+    //  FSTRegistry::shrinkIdle. Returns false if reallocation failed.
+    // No-Throw Guarantee
+    static bool _registryShrink(void * p, size_type cap) noexcept
+    {
+        auto & arr = *static_cast<FSTArray *>(p);
+        try {
+            arr._reallocate(arr._roundCapacity(std::max(cap, arr._size)));
+        }
+        catch(...){
+            return false;
+        }
+        return true;
+    }
+
+    // Type-erased accessors for the registry
+    static inline const FSTRegistryType _registryType = {
+        typeid(value_type).name(),
+        sizeof(value_type),
+        [](const void * p)
+            { return static_cast<const FSTArray *>(p)->_size; },
+        [](const void * p)
+            { return static_cast<const FSTArray *>(p)->_capacity; },
+        _registryShrink
+    };
+#endif
+
 // ***** FSTArray: data members *****
 private:
 
@@ -283,6 +1245,12 @@ private:
     size_type    _capacity;  // Size of our allocated array
     size_type    _size;      // Size of client's data
     value_type * _data;      // Pointer to our array
+#ifdef FSTARRAY_HARDENED
+    generation_type _generation = 0;  // Bumped on each invalidation
+#endif
+#ifdef FSTARRAY_REGISTRY
+    FSTRegistryNode _registryNode;    // Our link in the registry
+#endif
 
 };  // End class FSTArray
 
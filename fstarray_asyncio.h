@@ -0,0 +1,701 @@
+// fstarray_asyncio.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Asynchronous save & load of FSTArray buffers, on a thread pool, with
+//  optional direct I/O
+
+#ifndef FILE_FSTARRAY_ASYNCIO_H_INCLUDED
+#define FILE_FSTARRAY_ASYNCIO_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <cstdlib>
+// For std::aligned_alloc
+// For std::free
+#include <cstring>
+// For std::memcpy
+// For std::memset
+#include <algorithm>
+// For std::min
+// For std::max
+#include <atomic>
+// For std::atomic
+#include <condition_variable>
+// For std::condition_variable
+#include <deque>
+// For std::deque
+#include <exception>
+// For std::exception_ptr
+#include <functional>
+// For std::function
+#include <future>
+// For std::future
+// For std::promise
+#include <memory>
+// For std::shared_ptr
+// For std::make_shared
+// For std::unique_ptr
+#include <new>
+// For std::bad_alloc
+#include <mutex>
+// For std::mutex
+// For std::lock_guard
+// For std::unique_lock
+#include <stdexcept>
+// For std::runtime_error
+#include <string>
+// For std::string
+#include <system_error>
+// For std::system_error
+#include <thread>
+// For std::thread
+#include <type_traits>
+// For std::is_trivially_copyable_v
+#include <utility>
+// For std::move
+#include <vector>
+// For std::vector
+#include <unistd.h>
+// For pwrite
+// For pread
+// For close
+// For ftruncate
+#include <fcntl.h>
+// For open
+#include <sys/stat.h>
+// For fstat
+#include <cerrno>
+// For errno
+
+// Asynchronous save & load (POSIX systems):
+//     fstSaveAsync(std::move(a), path [, options])
+//         Write a's items to file path, as raw bytes (the format of
+//         fstReadBinary, fstarray_io.h). Returns a std::future that
+//         gives a back when the write is done.
+//     fstLoadAsync<T>(path [, options])
+//         Read a file of raw T items. Returns a std::future of an
+//         FSTArray<T> holding them.
+// The array is moved into the operation: while I/O is in flight, no
+//  one else can resize or free the buffer it is writing from. The
+//  caller's only costs are the move and queueing one task. Opening the
+//  file, the chunked writes or reads (FSTIoOptions::chunkBytes each, in
+//  parallel on the pool's threads), and closing all happen on FSTIoPool.
+// Errors: the future's get() throws. For a load, this is
+//  std::system_error or std::runtime_error. For a save, it is
+//  FSTIoError<Array>, which holds the array, so that a failed save does
+//  not lose data.
+// Direct I/O (options.direct): the file is opened with O_DIRECT, and
+//  data goes through page-aligned bounce buffers, since an FSTArray
+//  buffer has no particular alignment. The last write is padded to the
+//  alignment, and the file is truncated to its true size afterwards.
+//  File systems that refuse O_DIRECT (e.g., tmpfs) get buffered I/O.
+
+
+// *********************************************************************
+// struct FSTIoOptions & class FSTIoError
+// *********************************************************************
+
+
+// struct FSTIoOptions
+// Settings for fstSaveAsync & fstLoadAsync.
+struct FSTIoOptions {
+    bool        direct = false;                  // Use O_DIRECT
+    std::size_t chunkBytes = std::size_t(4) << 20;  // Bytes per request
+};
+
+
+// class FSTIoError
+// Exception from a failed fstSaveAsync: the error message, and the
+//  array that was being saved.
+// Requirements on Types:
+//     Array is an FSTArray type.
+template <typename Array>
+class FSTIoError : public std::runtime_error {
+
+public:
+
+    FSTIoError(const std::string & what,
+               std::shared_ptr<Array> arr)
+        :std::runtime_error(what),
+         _array(std::move(arr))
+    {}
+
+    // array
+    // Return the array whose save failed; move from it to keep it.
+    // No-Throw Guarantee
+    Array & array() const noexcept
+    {
+        return *_array;
+    }
+
+private:
+
+    std::shared_ptr<Array> _array;  // Shared, since exceptions are copied
+
+};  // End class FSTIoError
+
+
+// *********************************************************************
+// class FSTIoPool - Class definition
+// *********************************************************************
+
+
+// class FSTIoPool
+// Fixed set of threads running queued tasks in FIFO order; used for
+//  asynchronous I/O. global() is the pool the fstSaveAsync &
+//  fstLoadAsync use. Tasks must not throw, and must not wait for other
+//  tasks.
+// The dctor runs the tasks still queued (including any they queue),
+//  then joins the threads.
+// Invariants:
+//     _threads are running, until the dctor.
+class FSTIoPool {
+
+// ***** FSTIoPool: ctors, dctor *****
+public:
+
+    // Ctor from number of threads
+    // Strong Guarantee
+    explicit FSTIoPool(std::size_t threads)
+        :_stopping(false)
+    {
+        try
+        {
+            for (std::size_t i = 0; i < std::max(threads, std::size_t(1));
+                 ++i)
+                _threads.emplace_back([this]() { _run(); });
+        }
+        catch (...)
+        {
+            _stop();
+            throw;
+        }
+    }
+
+    FSTIoPool(const FSTIoPool &) = delete;
+    FSTIoPool & operator=(const FSTIoPool &) = delete;
+
+    // Dctor
+    ~FSTIoPool()
+    {
+        _stop();
+    }
+
+// ***** FSTIoPool: general public functions *****
+public:
+
+    // global
+    // Return the pool for asynchronous I/O: 4 threads, enough to keep
+    //  a few requests in flight on one device.
+    static FSTIoPool & global()
+    {
+        static FSTIoPool pool(4);
+        return pool;
+    }
+
+    // submit
+    // Queue task to run on a pool thread.
+    // Strong Guarantee
+    void submit(std::function<void ()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.push_back(std::move(task));
+        }
+        _ready.notify_one();
+    }
+
+// ***** FSTIoPool: internal-use functions *****
+private:
+
+    // _run
+    // Body of each pool thread.
+    void _run() noexcept
+    {
+        for (;;)
+        {
+            std::function<void ()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _ready.wait(lock, [this]()
+                            { return _stopping || !_tasks.empty(); });
+                if (_tasks.empty())
+                    return;  // Stopping, and nothing left
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    // _stop
+    // Let the threads finish the queue, & join them.
+    void _stop() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _ready.notify_all();
+        for (auto & t : _threads)
+            t.join();
+    }
+
+// ***** FSTIoPool: data members *****
+private:
+
+    std::mutex                          _mutex;     // Guards the rest
+    std::condition_variable             _ready;     // Task or stop
+    std::deque<std::function<void ()>>  _tasks;     // Queued tasks
+    bool                                _stopping;  // Dctor has begun
+    std::vector<std::thread>            _threads;   // Last: started in
+                                                    //  the ctor body
+
+};  // End class FSTIoPool
+
+
+// *********************************************************************
+// Implementation details
+// *********************************************************************
+
+
+namespace fst_asyncio_detail {
+
+    // Alignment for direct I/O: covers the logical block size of
+    //  common devices
+    constexpr std::size_t ALIGN = 4096;
+
+    // roundUp
+    inline std::size_t roundUp(std::size_t n,
+                               std::size_t align) noexcept
+    {
+        return (n + align - 1) / align * align;
+    }
+
+    // class File
+    // Open file descriptor; closes on destruction.
+    class File {
+    public:
+
+        // Open path with flags; with direct, try O_DIRECT first.
+        // Sets isDirect to whether O_DIRECT is in use.
+        // Throws std::system_error on failure.
+        File(const std::string & path,
+             int flags,
+             bool direct)
+            :_fd(-1),
+             isDirect(false)
+        {
+#ifdef O_DIRECT
+            if (direct)
+            {
+                _fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+                isDirect = (_fd >= 0);
+                if (_fd < 0 && errno != EINVAL)
+                    _throwErrno("cannot open " + path);
+            }
+#else
+            (void)direct;
+#endif
+            if (_fd < 0)
+                _fd = ::open(path.c_str(), flags, 0644);
+            if (_fd < 0)
+                _throwErrno("cannot open " + path);
+        }
+
+        File(const File &) = delete;
+        File & operator=(const File &) = delete;
+
+        ~File()
+        {
+            if (_fd >= 0)
+                ::close(_fd);
+        }
+
+        int fd() const noexcept
+        {
+            return _fd;
+        }
+
+        // close
+        // Close now, reporting errors (a write error may show up only
+        //  here). Throws std::system_error on failure.
+        void close()
+        {
+            int fd = _fd;
+            _fd = -1;
+            if (::close(fd) != 0)
+                _throwErrno("close failed");
+        }
+
+    private:
+
+        [[noreturn]] static void _throwErrno(const std::string & what)
+        {
+            throw std::system_error(errno, std::generic_category(),
+                                    "FST async I/O: " + what);
+        }
+
+        int _fd;
+
+    public:
+
+        bool isDirect;
+
+    };  // End class File
+
+    // writeAll, readAll
+    // pwrite/pread n bytes at offset, retrying short transfers. readAll
+    //  returns the number read (less than n at end of file).
+    // Throw std::system_error on failure.
+    inline void writeAll(int fd,
+                         const char * buf,
+                         std::size_t n,
+                         std::size_t offset)
+    {
+        while (n != 0)
+        {
+            ssize_t done = ::pwrite(fd, buf, n, off_t(offset));
+            if (done < 0 && errno == EINTR)
+                continue;
+            if (done <= 0)
+                throw std::system_error(errno, std::generic_category(),
+                                        "FST async I/O: write failed");
+            buf += done;
+            n -= std::size_t(done);
+            offset += std::size_t(done);
+        }
+    }
+
+    inline std::size_t readAll(int fd,
+                               char * buf,
+                               std::size_t n,
+                               std::size_t offset)
+    {
+        std::size_t total = 0;
+        while (total < n)
+        {
+            ssize_t done = ::pread(fd, buf + total, n - total,
+                                   off_t(offset + total));
+            if (done < 0 && errno == EINTR)
+                continue;
+            if (done < 0)
+                throw std::system_error(errno, std::generic_category(),
+                                        "FST async I/O: read failed");
+            if (done == 0)
+                break;
+            total += std::size_t(done);
+        }
+        return total;
+    }
+
+    // struct AlignedBuffer
+    // Page-aligned bounce buffer for direct I/O.
+    struct AlignedBuffer {
+        explicit AlignedBuffer(std::size_t n)
+            :data(static_cast<char *>(std::aligned_alloc(ALIGN,
+                                                         roundUp(n, ALIGN))))
+        {
+            if (data == nullptr)
+                throw std::bad_alloc();
+        }
+        AlignedBuffer(const AlignedBuffer &) = delete;
+        AlignedBuffer & operator=(const AlignedBuffer &) = delete;
+        ~AlignedBuffer()
+        {
+            std::free(data);
+        }
+        char * data;
+    };
+
+    // transferChunk
+    // Write (toFile) or read bytes [offset, offset+n) of the file from/to
+    //  mem. Direct I/O goes through a bounce buffer, padded to ALIGN.
+    //  For reads, returns bytes read.
+    inline std::size_t transferChunk(int fd,
+                                     bool direct,
+                                     bool toFile,
+                                     char * mem,
+                                     std::size_t n,
+                                     std::size_t offset)
+    {
+        if (!direct)
+        {
+            if (toFile)
+            {
+                writeAll(fd, mem, n, offset);
+                return n;
+            }
+            return readAll(fd, mem, n, offset);
+        }
+        std::size_t padded = roundUp(n, ALIGN);
+        AlignedBuffer bounce(padded);
+        if (toFile)
+        {
+            std::memcpy(bounce.data, mem, n);
+            std::memset(bounce.data + n, 0, padded - n);
+            writeAll(fd, bounce.data, padded, offset);
+            return n;
+        }
+        std::size_t got = readAll(fd, bounce.data, padded, offset);
+        got = std::min(got, n);
+        std::memcpy(mem, bounce.data, got);
+        return got;
+    }
+
+    // struct Job
+    // Shared state of one save or load: the array, the file, how many
+    //  chunk tasks remain, and the first error.
+    template <typename Array>
+    struct Job {
+        std::shared_ptr<Array>  array;
+        std::promise<Array>     promise;
+        std::unique_ptr<File>   file;
+        std::size_t             bytes = 0;       // Bytes to transfer
+        std::atomic<std::size_t> remaining{0};   // Chunk tasks left
+        std::mutex              errorMutex;
+        std::exception_ptr      error;           // First failure
+
+        void fail(std::exception_ptr e) noexcept
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = e;
+        }
+    };
+
+    // finish
+    // Complete job: close (& truncate) the file, then fulfil the promise
+    //  with the array, or with the error.
+    template <typename Array>
+    void finish(Job<Array> & job,
+                bool saving) noexcept
+    {
+        try
+        {
+            if (!job.error && job.file)
+            {
+                if (saving && job.file->isDirect
+                    && ::ftruncate(job.file->fd(), off_t(job.bytes)) != 0)
+                    throw std::system_error(errno, std::generic_category(),
+                                            "FST async I/O: truncate failed");
+                job.file->close();
+            }
+        }
+        catch (...)
+        {
+            job.fail(std::current_exception());
+        }
+        job.file.reset();
+
+        if (!job.error)
+        {
+            job.promise.set_value(std::move(*job.array));
+            return;
+        }
+        if (!saving)
+        {
+            job.promise.set_exception(job.error);
+            return;
+        }
+        // Saving: hand the array back inside the exception
+        std::string what = "FST async I/O: save failed";
+        try
+        {
+            std::rethrow_exception(job.error);
+        }
+        catch (std::exception & e)
+        {
+            what = e.what();
+        }
+        catch (...)
+        {}
+        try
+        {
+            auto e = std::make_exception_ptr(
+                FSTIoError<Array>(what, job.array));
+            job.array.reset();  // The exception is now the only owner
+            job.promise.set_exception(e);
+        }
+        catch (...)
+        {
+            job.promise.set_exception(job.error);
+        }
+    }
+
+    // start
+    // Queue the chunk tasks of job on pool, after the file is open & the
+    //  array sized. Each moves chunkBytes (the last, the rest); the last
+    //  to finish calls finish.
+    template <typename Array>
+    void start(std::shared_ptr<Job<Array>> job,
+               bool saving,
+               std::size_t chunkBytes,
+               FSTIoPool & pool)
+    {
+        std::size_t chunks = (job->bytes + chunkBytes - 1) / chunkBytes;
+        if (chunks == 0)
+        {
+            finish(*job, saving);
+            return;
+        }
+        job->remaining = chunks;
+        char * base = job->array->size() == 0
+            ? nullptr : reinterpret_cast<char *>(&(*job->array)[0]);
+        for (std::size_t c = 0; c < chunks; ++c)
+        {
+            std::size_t offset = c * chunkBytes;
+            std::size_t n = std::min(chunkBytes, job->bytes - offset);
+            auto task = [job, saving, base, offset, n]()
+            {
+                try
+                {
+                    std::size_t got = transferChunk(job->file->fd(),
+                        job->file->isDirect, saving, base + offset, n,
+                        offset);
+                    if (got != n)
+                        throw std::runtime_error(
+                            "FST async I/O: file shorter than expected");
+                }
+                catch (...)
+                {
+                    job->fail(std::current_exception());
+                }
+                if (--job->remaining == 0)
+                    finish(*job, saving);
+            };
+            try
+            {
+                pool.submit(task);
+            }
+            catch (...)
+            {
+                // Run it here instead; it cannot throw
+                task();
+            }
+        }
+    }
+
+}  // End namespace fst_asyncio_detail
+
+
+// *********************************************************************
+// Asynchronous save & load
+// *********************************************************************
+
+
+// fstSaveAsync
+// Move a into a background save to path (see top of file). The future
+//  gives the array back when the file is written & closed.
+// Requirements on Types:
+//     T is trivially copyable.
+// Strong Guarantee: if this throws, a is unchanged.
+// Exception neutral
+template <typename T, typename Policy>
+std::future<FSTArray<T, Policy>> fstSaveAsync(
+    FSTArray<T, Policy> && a,
+    const std::string & path,
+    FSTIoOptions options=FSTIoOptions(),
+    FSTIoPool & pool=FSTIoPool::global())
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "fstSaveAsync requires a trivially copyable item type");
+    using Array = FSTArray<T, Policy>;
+    using namespace fst_asyncio_detail;
+
+    auto job = std::make_shared<Job<Array>>();
+    auto result = job->promise.get_future();
+    std::size_t chunkBytes = roundUp(std::max(options.chunkBytes,
+                                              std::size_t(1)), ALIGN);
+    job->array = std::make_shared<Array>(0);
+    job->array->swap(a);  // Nothing above changed a; nothing below throws
+    job->bytes = job->array->size() * sizeof(T);
+    try
+    {
+        pool.submit([job, path, options, chunkBytes, &pool]()
+        {
+            try
+            {
+                job->file = std::make_unique<File>(path,
+                    O_WRONLY | O_CREAT | O_TRUNC, options.direct);
+                start(job, true, chunkBytes, pool);
+            }
+            catch (...)
+            {
+                job->fail(std::current_exception());
+                finish(*job, true);
+            }
+        });
+    }
+    catch (...)
+    {
+        a.swap(*job->array);
+        throw;
+    }
+    return result;
+}
+
+
+// fstLoadAsync
+// Read the file of raw T items at path in the background (see top of
+//  file). The future gives an FSTArray<T> holding them.
+// Requirements on Types:
+//     T is trivially copyable & default-constructible.
+// Strong Guarantee
+// Exception neutral
+template <typename T, typename Policy=FSTNoShrink>
+std::future<FSTArray<T, Policy>> fstLoadAsync(
+    const std::string & path,
+    FSTIoOptions options=FSTIoOptions(),
+    FSTIoPool & pool=FSTIoPool::global())
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "fstLoadAsync requires a trivially copyable item type");
+    using Array = FSTArray<T, Policy>;
+    using namespace fst_asyncio_detail;
+
+    auto job = std::make_shared<Job<Array>>();
+    auto result = job->promise.get_future();
+    std::size_t chunkBytes = roundUp(std::max(options.chunkBytes,
+                                              std::size_t(1)), ALIGN);
+    pool.submit([job, path, options, chunkBytes, &pool]()
+    {
+        try
+        {
+            job->file = std::make_unique<File>(path, O_RDONLY,
+                                               options.direct);
+            struct stat st;
+            if (::fstat(job->file->fd(), &st) != 0)
+                throw std::system_error(errno, std::generic_category(),
+                                        "FST async I/O: cannot stat "
+                                        + path);
+            std::size_t bytes = std::size_t(st.st_size);
+            if (bytes % sizeof(T) != 0)
+                throw std::runtime_error("FST async I/O: partial item in "
+                                         + path);
+            job->array = std::make_shared<Array>(bytes / sizeof(T));
+            job->bytes = bytes;
+            start(job, false, chunkBytes, pool);
+        }
+        catch (...)
+        {
+            job->fail(std::current_exception());
+            if (!job->array)
+            {
+                job->file.reset();
+                job->promise.set_exception(job->error);
+                return;
+            }
+            finish(*job, false);
+        }
+    });
+    return result;
+}
+
+
+#endif  //#ifndef FILE_FSTARRAY_ASYNCIO_H_INCLUDED
+
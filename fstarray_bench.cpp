@@ -0,0 +1,1873 @@
+// fstarray_bench.cpp
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Benchmark program for class template FSTArray
+// Usage:
+//     fstarray_bench            Run all benchmarks
+//     fstarray_bench NAME ...   Run only the named benchmarks
+// Build optimized (CMAKE_BUILD_TYPE=Release). Target
+//  fstarray_bench_hardened is this program built with FSTARRAY_HARDENED;
+//  fstarray_bench_cache is built with FSTARRAY_BUFFER_CACHE.
+
+#include "fstarray.h"        // For class template FSTArray
+#include "fstslotmap.h"      // For class template FSTSlotMap
+#include "fstasyncarray.h"   // For class template FSTAsyncArray
+#include "fstfixedarray.h"   // For class template FSTFixedArray
+#include "fstpackedarray.h"  // For class template FSTPackedArray
+#include "fstfrozenarray.h"  // For class FSTFrozenArray
+#include "fstarray_sort.h"   // For fstSort etc.
+#include "fstarray_io.h"     // For fstReadInts, fstReadBinary
+#include "fstarray_asyncio.h"  // For fstSaveAsync, fstLoadAsync
+#include "fstsharedarray.h"  // For class template FSTSharedArray
+#include "fstrcuarray.h"     // For class template FSTRcuArray
+#include "fstshardedarray.h"  // For class template FSTShardedArray
+#include "fstarray_gather.h"  // For fstGather, fstScatter
+#include "fstarray_expr.h"    // For lazy arithmetic on FSTArray
+#include "fstarrayview.h"     // For class templates FSTArrayView etc.
+#include "fstarray_hash.h"    // For std::hash<FSTArray>
+
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <iomanip>
+using std::setw;
+#include <string>
+using std::string;
+#include <chrono>
+#include <cstddef>
+using std::size_t;
+#include <cstring>
+using std::strcmp;
+#include <type_traits>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <shared_mutex>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+
+// *********************************************************************
+// Benchmark helpers
+// *********************************************************************
+
+
+// sink
+// Keep a computed value alive, so the optimizer cannot delete the work
+//  that produced it.
+template <typename T>
+void sink(const T & value)
+{
+    static volatile T store;
+    store = value;
+    (void)store;
+}
+
+
+// timeBest
+// Run func reps times; return the fastest run, in seconds.
+template <typename Func>
+double timeBest(int reps, Func func)
+{
+    double best = 1.0e300;
+    for (int r = 0; r < reps; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double> d =
+            std::chrono::steady_clock::now() - start;
+        if (d.count() < best)
+            best = d.count();
+    }
+    return best;
+}
+
+
+// percentile
+// Return the p-th percentile (0 <= p <= 1) of the given samples.
+// Sorts the samples.
+double percentile(FSTArray<double> & samples,
+                  double p)
+{
+    std::sort(samples.begin(), samples.end());
+    size_t i = size_t(p * double(samples.size() - 1));
+    return samples[i];
+}
+
+
+// residentBytes
+// Return the resident set size of this process, or 0 where it cannot
+//  be read (non-Linux).
+size_t residentBytes()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t total = 0;
+    size_t resident = 0;
+    if (statm >> total >> resident)
+        return resident * size_t(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+}
+
+
+// physicalBytes
+// Return the size of physical memory, or 0 where it cannot be found
+//  (non-Linux).
+size_t physicalBytes()
+{
+#ifdef __linux__
+    return size_t(sysconf(_SC_PHYS_PAGES)) * size_t(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+
+// report
+// Print one result line: label, seconds, and ns per item.
+void report(const string & label,
+            double seconds,
+            size_t items)
+{
+    cout << "  " << std::left << setw(40) << label << std::right
+         << std::fixed << std::setprecision(6) << setw(12) << seconds
+         << " s" << std::setprecision(3) << setw(10)
+         << seconds * 1.0e9 / double(items) << " ns/item" << endl;
+}
+
+
+// *********************************************************************
+// Benchmarks
+// *********************************************************************
+
+
+// benchChecked
+// Cost of checked access. In the default build, operator[] and
+//  iterators must match raw-pointer code exactly; the static_asserts
+//  pin the layout, and the timings of operator[] and a raw pointer loop
+//  should agree. at() shows the cost of an always-on check. Compare
+//  with the same benchmark in fstarray_bench_hardened.
+void benchChecked()
+{
+#ifdef FSTARRAY_HARDENED
+    cout << "checked (FSTARRAY_HARDENED)" << endl;
+#else
+    cout << "checked (default build)" << endl;
+    static_assert(sizeof(FSTArray<int>) == 3 * sizeof(void *),
+                  "default FSTArray must carry no hardening state");
+    static_assert(std::is_same_v<FSTArray<int>::iterator, int *>,
+                  "default FSTArray iterator must be a raw pointer");
+#endif
+
+    const size_t SIZE = size_t(1) << 24;
+    FSTArray<int> a(SIZE);
+    for (size_t i = 0; i < SIZE; ++i)
+        a[i] = int(i & 0xff);
+
+    double t;
+    t = timeBest(5, [&]() {
+        long long sum = 0;
+        const int * p = &a[0];
+        for (size_t i = 0; i < SIZE; ++i)
+            sum += p[i];
+        sink(sum);
+    });
+    report("raw pointer loop", t, SIZE);
+
+    t = timeBest(5, [&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < a.size(); ++i)
+            sum += a[i];
+        sink(sum);
+    });
+    report("operator[] loop", t, SIZE);
+
+    t = timeBest(5, [&]() {
+        long long sum = 0;
+        for (auto it = a.begin(); it != a.end(); ++it)
+            sum += *it;
+        sink(sum);
+    });
+    report("iterator loop", t, SIZE);
+
+    t = timeBest(5, [&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < a.size(); ++i)
+            sum += a.at(i);
+        sink(sum);
+    });
+    report("at() loop", t, SIZE);
+}
+
+
+// benchSlotMap
+// Erase-heavy churn on an entity table: erase a random entity, add a
+//  new one. FSTArray erases by index (shifting the tail); FSTSlotMap
+//  erases by handle (swap-and-pop). Then iterate over all entities.
+void benchSlotMap()
+{
+    cout << "slotmap" << endl;
+
+    const size_t SIZE = size_t(100000);
+    const size_t OPS = size_t(100000);
+    double t;
+
+    FSTArray<int> arr(0);
+    t = timeBest(3, [&]() {
+        arr.resize(0);
+        for (size_t i = 0; i < SIZE; ++i)
+            arr.push_back(int(i));
+        std::mt19937_64 rng(1);
+        for (size_t i = 0; i < OPS; ++i)
+        {
+            arr.erase(arr.begin() + rng() % arr.size());
+            arr.push_back(int(i));
+        }
+    });
+    report("FSTArray erase(index) churn", t, OPS);
+
+    FSTSlotMap<int> sm;
+    t = timeBest(3, [&]() {
+        FSTSlotMap<int> fresh;
+        sm.swap(fresh);
+        FSTArray<FSTSlotMap<int>::Handle> live(0);
+        for (size_t i = 0; i < SIZE; ++i)
+            live.push_back(sm.insert(int(i)));
+        std::mt19937_64 rng(1);
+        for (size_t i = 0; i < OPS; ++i)
+        {
+            size_t k = rng() % live.size();
+            sm.erase(live[k]);
+            live[k] = sm.insert(int(i));
+        }
+    });
+    report("FSTSlotMap erase(handle) churn", t, OPS);
+
+    t = timeBest(5, [&]() {
+        long long sum = 0;
+        for (auto x : arr)
+            sum += x;
+        sink(sum);
+    });
+    report("FSTArray iterate", t, arr.size());
+
+    t = timeBest(5, [&]() {
+        long long sum = 0;
+        for (auto x : sm)
+            sum += x;
+        sink(sum);
+    });
+    report("FSTSlotMap iterate", t, sm.size());
+}
+
+
+// benchEraseIf
+// Filter 10%, 50% & 90% of 100M random ints: FSTArray::erase_if against
+//  std::remove_if + resize. Also shows unordered_erase against erase
+//  when removing many items one at a time.
+void benchEraseIf()
+{
+    cout << "erase_if" << endl;
+
+    const size_t SIZE = size_t(100000000);
+    FSTArray<int> source(SIZE);
+    std::mt19937 rng(1);
+    for (size_t i = 0; i < SIZE; ++i)
+        source[i] = int(rng() % 100);
+
+    for (int percent : { 10, 50, 90 })
+    {
+        auto pred = [percent](int x) { return x < percent; };
+        FSTArray<int> work(0);
+
+        // Time only the filtering, not the refill
+        double best = 1.0e300;
+        for (int r = 0; r < 3; ++r)
+        {
+            work = source;
+            best = std::min(best, timeBest(1, [&]() { work.erase_if(pred); }));
+        }
+        report("erase_if, remove " + std::to_string(percent) + "%",
+               best, SIZE);
+
+        best = 1.0e300;
+        for (int r = 0; r < 3; ++r)
+        {
+            work = source;
+            best = std::min(best, timeBest(1, [&]() {
+                auto newEnd = std::remove_if(work.begin(), work.end(), pred);
+                work.resize(size_t(newEnd - work.begin()));
+            }));
+        }
+        report("std::remove_if, remove " + std::to_string(percent) + "%",
+               best, SIZE);
+    }
+
+    // One-at-a-time removal of 1% of a 1M array
+    const size_t SMALL = size_t(1000000);
+    FSTArray<int> work(0);
+    double best = 1.0e300;
+    for (int r = 0; r < 3; ++r)
+    {
+        work = source;
+        work.resize(SMALL);
+        best = std::min(best, timeBest(1, [&]() {
+            for (size_t i = 0; i < SMALL / 100; ++i)
+                work.erase(work.begin() + (i * 97) % work.size());
+        }));
+    }
+    report("erase x 1% of 1M", best, SMALL / 100);
+
+    best = 1.0e300;
+    for (int r = 0; r < 3; ++r)
+    {
+        work = source;
+        work.resize(SMALL);
+        best = std::min(best, timeBest(1, [&]() {
+            for (size_t i = 0; i < SMALL / 100; ++i)
+                work.unordered_erase(work.begin() + (i * 97) % work.size());
+        }));
+    }
+    report("unordered_erase x 1% of 1M", best, SMALL / 100);
+}
+
+
+// benchBufferCache
+// Per-request churn: make an FSTArray<int>, push_back a few hundred
+//  items, destroy it. Reports throughput & per-iteration latency. In
+//  fstarray_bench_cache, runs with the buffer cache on, then off.
+void benchBufferCache()
+{
+    cout << "buffercache" << endl;
+
+    const size_t ITERS = size_t(1000000);
+    const size_t ITEMS = size_t(300);
+    FSTArray<double> samples(ITERS);
+
+    auto churn = [&](const string & label) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ITERS; ++i)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            {
+                FSTArray<int> a;
+                for (size_t k = 0; k < ITEMS; ++k)
+                    a.push_back(int(k));
+                sink(a[ITEMS/2]);
+            }
+            std::chrono::duration<double, std::nano> d =
+                std::chrono::steady_clock::now() - t0;
+            samples[i] = d.count();
+        }
+        std::chrono::duration<double> total =
+            std::chrono::steady_clock::now() - start;
+        report(label + " total", total.count(), ITERS);
+        double p50 = percentile(samples, 0.50);
+        double p99 = percentile(samples, 0.99);
+        cout << "    p50 " << p50 << " ns   p99 " << p99 << " ns" << endl;
+    };
+
+#ifdef FSTARRAY_BUFFER_CACHE
+    auto & cache = FSTBufferCache<int>::local();
+    cache.setEnabled(true);
+    churn("cache on");
+    cout << "    hits " << cache.hits() << "   misses " << cache.misses()
+         << endl;
+    cache.setEnabled(false);
+    churn("cache off");
+    cache.setEnabled(true);
+#else
+    churn("new[]/delete[] (no FSTARRAY_BUFFER_CACHE)");
+#endif
+}
+
+
+// benchAsyncGrowth
+// Tail latency of push_back while growing to 50M items: FSTArray
+//  (stop-the-world copy at each capacity crossing) against
+//  FSTAsyncArray (background copy). Prints a log2 latency histogram.
+//  Background growth needs a spare core to pay off.
+void benchAsyncGrowth()
+{
+    cout << "asyncgrowth (hardware threads: "
+         << std::thread::hardware_concurrency() << ")" << endl;
+
+    const size_t SIZE = size_t(50000000);
+
+    auto run = [&](const string & label, auto & arr) {
+        size_t buckets[64] = {};
+        double maxNs = 0.0;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            arr.push_back(int(i));
+            std::chrono::duration<double, std::nano> d =
+                std::chrono::steady_clock::now() - t0;
+            size_t ns = size_t(d.count());
+            size_t b = 0;
+            while ((size_t(1) << b) <= ns)
+                ++b;
+            ++buckets[b];
+            if (d.count() > maxNs)
+                maxNs = d.count();
+        }
+
+        cout << "  " << label << ": push_back latency histogram" << endl;
+        size_t seen = 0;
+        double p50 = 0, p999 = 0, p9999 = 0;
+        for (size_t b = 0; b < 64; ++b)
+        {
+            if (buckets[b] == 0)
+                continue;
+            seen += buckets[b];
+            double upper = double(size_t(1) << b);
+            if (p50 == 0 && seen >= SIZE / 2)
+                p50 = upper;
+            if (p999 == 0 && seen >= SIZE - SIZE / 1000)
+                p999 = upper;
+            if (p9999 == 0 && seen >= SIZE - SIZE / 10000)
+                p9999 = upper;
+            cout << "    < " << setw(12) << size_t(upper) << " ns "
+                 << setw(10) << buckets[b] << endl;
+        }
+        cout << "    p50 <= " << p50 << " ns   p99.9 <= " << p999
+             << " ns   p99.99 <= " << p9999 << " ns   max "
+             << maxNs / 1.0e6 << " ms" << endl;
+    };
+
+    {
+        FSTArray<int> a;
+        run("FSTArray", a);
+    }
+    {
+        FSTAsyncArray<int> a;
+        run("FSTAsyncArray", a);
+    }
+}
+
+
+// benchFixed
+// Small arrays: make, fill & sum an array of N ints, many times, with
+//  heap FSTArray and stack FSTFixedArray. Also reads a lookup table
+//  built at compile time. For the smallest N, the optimizer may fold
+//  the fixed array away entirely; that is part of the point.
+template <size_t N>
+void benchFixedSize()
+{
+    const size_t REPS = size_t(2000000);
+    double t;
+
+    t = timeBest(3, [&]() {
+        long long sum = 0;
+        for (size_t r = 0; r < REPS; ++r)
+        {
+            FSTArray<int> a(N);
+            for (size_t i = 0; i < N; ++i)
+                a[i] = int(i + r);
+            for (size_t i = 0; i < N; ++i)
+                sum += a[i];
+        }
+        sink(sum);
+    });
+    report("FSTArray<int>, N = " + std::to_string(N), t, REPS);
+
+    t = timeBest(3, [&]() {
+        long long sum = 0;
+        for (size_t r = 0; r < REPS; ++r)
+        {
+            FSTFixedArray<int, N> a(N);
+            for (size_t i = 0; i < N; ++i)
+                a[i] = int(i + r);
+            for (size_t i = 0; i < N; ++i)
+                sum += a[i];
+        }
+        sink(sum);
+    });
+    report("FSTFixedArray<int, N>, N = " + std::to_string(N), t, REPS);
+}
+
+
+// makeCubesTable
+// Lookup table of cubes, for benchFixed.
+constexpr FSTFixedArray<long long, 256> makeCubesTable()
+{
+    FSTFixedArray<long long, 256> t;
+    for (long long i = 0; i < 256; ++i)
+        t.push_back(i*i*i);
+    return t;
+}
+
+
+void benchFixed()
+{
+    cout << "fixed" << endl;
+    benchFixedSize<4>();
+    benchFixedSize<16>();
+    benchFixedSize<64>();
+
+    static constexpr auto cubes = makeCubesTable();
+    const size_t LOOKUPS = size_t(100000000);
+    double t = timeBest(3, [&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < LOOKUPS; ++i)
+            sum += cubes[i & 0xff];
+        sink(sum);
+    });
+    report("compile-time table lookup", t, LOOKUPS);
+}
+
+
+// primesTable
+// Primes below N, by a sieve using FSTArray; usable at compile time.
+template <size_t N>
+constexpr FSTFixedArray<int, N> primesTable()
+{
+    FSTArray<bool> composite(N);
+    for (size_t i = 0; i < N; ++i)
+        composite[i] = false;
+    FSTFixedArray<int, N> primes;
+    for (size_t i = 2; i < N; ++i)
+    {
+        if (composite[i])
+            continue;
+        primes.push_back(int(i));
+        for (size_t j = i*i; j < N; j += i)
+            composite[j] = true;
+    }
+    return primes;
+}
+
+
+// benchConstexprTable
+// Startup cost of a table of the primes below 20000: built by
+//  constant evaluation (nothing to do at run time) against built by the
+//  same code at program start.
+void benchConstexprTable()
+{
+    cout << "constexprtable" << endl;
+
+    const size_t N = size_t(20000);
+    static constexpr auto compiled = primesTable<N>();
+
+    double t = timeBest(5, [&]() {
+        sink(compiled[compiled.size()-1]);
+    });
+    report("compile-time table, first use", t, compiled.size());
+
+    t = timeBest(5, [&]() {
+        auto built = primesTable<N>();
+        sink(built[built.size()-1]);
+    });
+    report("run-time table, build at startup", t, compiled.size());
+}
+
+
+// burstRounds
+// For benchShrink: arrays take turns doing a burst (push_back up to
+//  peak items) and a drain (pop_back down to floor items). Record
+//  resident bytes after each turn in rss; return the total time.
+template <typename Policy>
+double burstRounds(size_t peak,
+                   size_t floor,
+                   FSTArray<size_t> & rss)
+{
+    FSTArray<FSTArray<double, Policy>> live(rss.size());
+    double total = 0.0;
+    for (size_t k = 0; k < live.size(); ++k)
+    {
+        auto start = std::chrono::steady_clock::now();
+        FSTArray<double, Policy> & a = live[k];
+        a.resize(0);
+        for (size_t i = 0; i < peak; ++i)
+            a.push_back(double(i));
+        while (a.size() > floor)
+            a.pop_back();
+        std::chrono::duration<double> d =
+            std::chrono::steady_clock::now() - start;
+        total += d.count();
+        rss[k] = residentBytes();
+    }
+    return total;
+}
+
+
+// benchShrink
+// Memory held after bursts. Each of several arrays in turn grows to a
+//  peak and drains to a small size. With FSTNoShrink (the default),
+//  every drained array keeps its peak capacity, so resident memory
+//  climbs with each turn; with FSTShrinkQuarter it is given back, and
+//  memory stays near one burst's worth. Times show what the shrinking
+//  costs.
+void benchShrink()
+{
+    const size_t ARRAYS = size_t(8);
+    const size_t PEAK = size_t(2000000);
+    const size_t FLOOR = size_t(1000);
+
+    size_t rssStart = residentBytes();
+    FSTArray<size_t> rssKeep(ARRAYS);
+    FSTArray<size_t> rssShrink(ARRAYS);
+    double tKeep = burstRounds<FSTNoShrink>(PEAK, FLOOR, rssKeep);
+    double tShrink = burstRounds<FSTShrinkQuarter>(PEAK, FLOOR,
+                                                   rssShrink);
+
+    cout << "  Resident MB after each array's burst & drain (at start: "
+         << std::fixed << std::setprecision(1)
+         << double(rssStart) / 1048576.0 << "):" << endl;
+    cout << "  " << setw(8) << "turn" << setw(16) << "FSTNoShrink"
+         << setw(20) << "FSTShrinkQuarter" << endl;
+    for (size_t k = 0; k < ARRAYS; ++k)
+    {
+        cout << "  " << setw(8) << k+1 << std::fixed
+             << std::setprecision(1)
+             << setw(16) << double(rssKeep[k]) / 1048576.0
+             << setw(20) << double(rssShrink[k]) / 1048576.0 << endl;
+    }
+    size_t ops = ARRAYS * 2 * (PEAK - FLOOR);
+    report("bursts, FSTNoShrink", tKeep, ops);
+    report("bursts, FSTShrinkQuarter", tShrink, ops);
+}
+
+
+// benchPacked
+// Footprint & scan speed of packed arrays against unpacked ones: bits in
+//  FSTBitArray against FSTArray<bool>, and 4-bit values in
+//  FSTPackedArray<4> against FSTArray<int>. Scans are a count of the
+//  items equal to a value, and a full unpack (packed) or copy
+//  (unpacked) into an int buffer.
+void benchPacked()
+{
+    cout << "packed" << endl;
+    const size_t N = size_t(16000000);
+    const int REPS = 5;
+    std::mt19937 gen(311);
+
+    FSTArray<bool> bools(N);
+    FSTBitArray bitArr(N);
+    FSTArray<int> ints(N);
+    FSTPackedArray<4> nibbles(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        auto r = gen();
+        bools[i] = bitArr[i] = (r & 1) != 0;
+        ints[i] = int(r >> 8) & 15;
+        nibbles[i] = unsigned(ints[i]);
+    }
+
+    cout << "  Bytes per 1000 items: FSTArray<bool> "
+         << 1000.0 * double(bools.capacity() * sizeof(bool)) / double(N)
+         << ", FSTBitArray "
+         << 1000.0 * double(bitArr.bytes()) / double(N)
+         << ", FSTArray<int> "
+         << 1000.0 * double(ints.capacity() * sizeof(int)) / double(N)
+         << ", FSTPackedArray<4> "
+         << 1000.0 * double(nibbles.bytes()) / double(N) << endl;
+
+    double t = timeBest(REPS, [&]() {
+        sink(size_t(std::count(bools.begin(), bools.end(), true)));
+    });
+    report("count true, FSTArray<bool>", t, N);
+    t = timeBest(REPS, [&]() {
+        sink(bitArr.popcount());
+    });
+    report("count true, FSTBitArray", t, N);
+
+    t = timeBest(REPS, [&]() {
+        sink(size_t(std::count(ints.begin(), ints.end(), 7)));
+    });
+    report("count 7, FSTArray<int>", t, N);
+    t = timeBest(REPS, [&]() {
+        sink(nibbles.count(7));
+    });
+    report("count 7, FSTPackedArray<4>", t, N);
+
+    FSTArray<int> out(N);
+    t = timeBest(REPS, [&]() {
+        std::copy(ints.begin(), ints.end(), out.begin());
+        sink(out[N/2]);
+    });
+    report("copy to int buffer, FSTArray<int>", t, N);
+    t = timeBest(REPS, [&]() {
+        nibbles.unpack(0, N, &out[0]);
+        sink(out[N/2]);
+    });
+    report("unpack to int buffer, FSTPackedArray<4>", t, N);
+}
+
+
+// benchFrozenOne
+// For benchFrozen: compression ratio, scan (sum) & random-access time of
+//  FSTFrozenArray against the raw array, for one distribution.
+void benchFrozenOne(const string & label,
+                    const FSTArray<int> & raw)
+{
+    const int REPS = 5;
+    const size_t N = raw.size();
+    FSTFrozenArray frozen(raw);
+    cout << "  " << label << ": compression ratio " << std::fixed
+         << std::setprecision(2)
+         << double(N * sizeof(int)) / double(frozen.bytes()) << endl;
+
+    double t = timeBest(REPS, [&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < N; ++i)
+            sum += raw[i];
+        sink(sum);
+    });
+    report("  scan, raw", t, N);
+    t = timeBest(REPS, [&]() {
+        long long sum = 0;
+        frozen.forEach([&](int v) { sum += v; });
+        sink(sum);
+    });
+    report("  scan, frozen (block decode)", t, N);
+
+    const size_t LOOKUPS = size_t(4000000);
+    t = timeBest(REPS, [&]() {
+        long long sum = 0;
+        size_t i = 0;
+        for (size_t k = 0; k < LOOKUPS; ++k)
+        {
+            i = (i + 7919 * 128 + 13) % N;
+            sum += raw[i];
+        }
+        sink(sum);
+    });
+    report("  random access, raw", t, LOOKUPS);
+    t = timeBest(REPS, [&]() {
+        long long sum = 0;
+        size_t i = 0;
+        for (size_t k = 0; k < LOOKUPS; ++k)
+        {
+            i = (i + 7919 * 128 + 13) % N;
+            sum += frozen[i];
+        }
+        sink(sum);
+    });
+    report("  random access, frozen", t, LOOKUPS);
+}
+
+
+// benchFrozen
+// FSTFrozenArray on realistic data: sorted IDs with small random gaps,
+//  skewed counters (mostly small, a few large), timestamps with jitter,
+//  and uniformly random ints (incompressible).
+void benchFrozen()
+{
+    cout << "frozen" << endl;
+    const size_t N = size_t(16000000);
+    std::mt19937 gen(311);
+    FSTArray<int> a(N);
+
+    long long id = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        id += 1 + gen() % 20;
+        a[i] = int(id);
+    }
+    benchFrozenOne("sorted IDs", a);
+
+    std::geometric_distribution<int> geo(0.05);
+    for (size_t i = 0; i < N; ++i)
+        a[i] = (gen() % 1000 == 0) ? int(gen() % 1000000) : geo(gen);
+    benchFrozenOne("skewed counters", a);
+
+    for (size_t i = 0; i < N; ++i)
+        a[i] = int(i * 100 + gen() % 50);
+    benchFrozenOne("timestamps, jittered", a);
+
+    for (size_t i = 0; i < N; ++i)
+        a[i] = int(gen());
+    benchFrozenOne("uniform random", a);
+}
+
+
+// timeSort
+// For benchSort: best time to sort n items, as ns per item. Each
+//  repetition restores the input, and sorts enough copies to run for a
+//  while; the cost of restoring is measured alone and subtracted.
+template <typename SortFunc>
+double timeSort(const FSTArray<int> & input,
+                FSTArray<int> & work,
+                SortFunc sortFunc)
+{
+    const size_t n = input.size();
+    const size_t rounds = std::max(size_t(1), size_t(4000000) / n);
+    int reps = n >= size_t(100000000) ? 1 : 3;
+    double copyTime = timeBest(reps, [&]() {
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            std::copy(input.begin(), input.end(), work.begin());
+            sink(work[r % n]);
+        }
+    });
+    double t = timeBest(reps, [&]() {
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            std::copy(input.begin(), input.end(), work.begin());
+            sortFunc();
+            sink(work[r % n]);
+        }
+    });
+    return std::max(t - copyTime, 0.0) * 1.0e9 / double(n * rounds);
+}
+
+
+// benchSort
+// Sorting random ints, 1K to 1G items (the largest sizes only where
+//  physical memory holds three copies twice over): std::sort against
+//  fstRadixSort, fstParallelSort and adaptive fstSort; also
+//  fstNthElement against std::nth_element. In ns per item.
+void benchSort()
+{
+    cout << "sort" << endl;
+    cout << "  Threads available: " << std::thread::hardware_concurrency()
+         << endl;
+    cout << "  " << setw(12) << "items" << setw(11) << "std::sort"
+         << setw(11) << "radix" << setw(11) << "parallel" << setw(11)
+         << "fstSort" << setw(11) << "std::nth" << setw(11) << "fstNth"
+         << endl;
+
+    std::mt19937 gen(311);
+    size_t memory = physicalBytes();
+    for (size_t n = size_t(1000); n <= size_t(1000000000); n *= 10)
+    {
+        if (memory != 0 && 6 * n * sizeof(int) > memory)
+        {
+            cout << "  " << setw(12) << n << "  skipped: too little memory"
+                 << endl;
+            continue;
+        }
+        FSTArray<int> input(n);
+        for (size_t i = 0; i < n; ++i)
+            input[i] = int(gen());
+        FSTArray<int> work(n);
+
+        double tStd = timeSort(input, work, [&]() {
+            std::sort(work.begin(), work.end());
+        });
+        double tRadix = timeSort(input, work, [&]() {
+            fstRadixSort(work);
+        });
+        double tPar = timeSort(input, work, [&]() {
+            fstParallelSort(work);
+        });
+        double tAdapt = timeSort(input, work, [&]() {
+            fstSort(work);
+        });
+        double tStdNth = timeSort(input, work, [&]() {
+            std::nth_element(work.begin(), work.begin() + n/2, work.end());
+        });
+        double tNth = timeSort(input, work, [&]() {
+            fstNthElement(work, n/2);
+        });
+        cout << "  " << setw(12) << n << std::fixed << std::setprecision(2)
+             << setw(11) << tStd << setw(11) << tRadix << setw(11) << tPar
+             << setw(11) << tAdapt << setw(11) << tStdNth << setw(11)
+             << tNth << endl;
+    }
+}
+
+
+// benchRead
+// Loading ints from a file: an ifstream >> & push_back loop against
+//  fstReadInts (text) and fstReadBinary, on 10M ints of mixed lengths.
+//  The file is read once first, so all runs read from the page cache.
+void benchRead()
+{
+    cout << "read" << endl;
+    const size_t N = size_t(10000000);
+    const int REPS = 3;
+    auto dir = std::filesystem::temp_directory_path();
+    string textPath = (dir / "fstarray_bench_read.txt").string();
+    string binPath = (dir / "fstarray_bench_read.bin").string();
+
+    std::mt19937 gen(311);
+    FSTArray<int> values(N);
+    for (size_t i = 0; i < N; ++i)
+        values[i] = int(gen()) >> (gen() % 31);
+    {
+        std::ofstream text(textPath);
+        for (size_t i = 0; i < N; ++i)
+            text << values[i] << (i % 10 == 9 ? '\n' : ' ');
+        std::ofstream bin(binPath, std::ios::binary);
+        bin.write(reinterpret_cast<const char *>(&values[0]),
+                  std::streamsize(N * sizeof(int)));
+    }
+    double textMB = double(std::filesystem::file_size(textPath)) / 1.0e6;
+    double binMB = double(std::filesystem::file_size(binPath)) / 1.0e6;
+    cout << "  Text file " << std::fixed << std::setprecision(1) << textMB
+         << " MB, binary file " << binMB << " MB" << endl;
+
+    size_t loaded = 0;
+    double t = timeBest(REPS, [&]() {
+        std::ifstream in(textPath);
+        FSTArray<int> a(0);
+        int x;
+        while (in >> x)
+            a.push_back(x);
+        loaded = a.size();
+    });
+    report("ifstream >> & push_back", t, loaded);
+    cout << "    " << std::setprecision(0) << textMB / t << " MB/s" << endl;
+
+    t = timeBest(REPS, [&]() {
+        FSTArray<int> a(0);
+        loaded = fstReadInts(a, textPath.c_str());
+    });
+    report("fstReadInts", t, loaded);
+    cout << "    " << std::setprecision(0) << textMB / t << " MB/s" << endl;
+
+    t = timeBest(REPS, [&]() {
+        FSTArray<int> a(0);
+        loaded = fstReadBinary(a, binPath.c_str());
+    });
+    report("fstReadBinary", t, loaded);
+    cout << "    " << std::setprecision(0) << binMB / t << " MB/s" << endl;
+
+    std::remove(textPath.c_str());
+    std::remove(binPath.c_str());
+}
+
+
+// benchAsyncSave
+// Saving 256 MB of ints: a synchronous write(2) loop against
+//  fstSaveAsync, buffered & direct. For each, the stall (time until the
+//  calling thread may do other work) and the total (until the file is
+//  written & closed), best of 3. Also loading: pread loop against
+//  fstLoadAsync.
+void benchAsyncSave()
+{
+    cout << "asyncsave" << endl;
+    const size_t N = size_t(64) << 20;
+    const int REPS = 3;
+    const size_t BYTES = N * sizeof(int);
+    const double MB = double(BYTES) / 1.0e6;
+    string path = (std::filesystem::temp_directory_path()
+                   / "fstarray_bench_async.bin").string();
+
+    FSTArray<int> a(N);
+    for (size_t i = 0; i < N; ++i)
+        a[i] = int(i * 2654435761u);
+
+    auto line = [&](const char * label, double stall, double total)
+    {
+        cout << "  " << std::left << setw(24) << label << std::right
+             << std::fixed << std::setprecision(2)
+             << "stall " << setw(9) << stall * 1.0e3 << " ms   total "
+             << setw(9) << total * 1.0e3 << " ms   " << std::setprecision(0)
+             << setw(6) << MB / total << " MB/s" << endl;
+    };
+
+    double t = timeBest(REPS, [&]() {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        const char * p = reinterpret_cast<const char *>(&a[0]);
+        size_t left = BYTES;
+        while (left != 0)
+        {
+            ssize_t done = ::write(fd, p, std::min(left, size_t(1) << 30));
+            if (done <= 0)
+                break;
+            p += done;
+            left -= size_t(done);
+        }
+        ::close(fd);
+    });
+    line("write() loop", t, t);
+
+    for (bool direct : { false, true })
+    {
+        FSTIoOptions opts;
+        opts.direct = direct;
+        double bestStall = 1.0e300;
+        double bestTotal = 1.0e300;
+        for (int r = 0; r < REPS; ++r)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto saving = fstSaveAsync(std::move(a), path, opts);
+            auto returned = std::chrono::steady_clock::now();
+            a = saving.get();
+            auto done = std::chrono::steady_clock::now();
+            bestStall = std::min(bestStall,
+                std::chrono::duration<double>(returned - start).count());
+            bestTotal = std::min(bestTotal,
+                std::chrono::duration<double>(done - start).count());
+        }
+        line(direct ? "fstSaveAsync, direct" : "fstSaveAsync", bestStall,
+             bestTotal);
+    }
+
+    FSTArray<int> b(0);
+    t = timeBest(REPS, [&]() {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        FSTArray<int> in(N);
+        char * p = reinterpret_cast<char *>(&in[0]);
+        size_t got = 0;
+        while (got < BYTES)
+        {
+            ssize_t n = ::pread(fd, p + got, BYTES - got, off_t(got));
+            if (n <= 0)
+                break;
+            got += size_t(n);
+        }
+        ::close(fd);
+        b.swap(in);
+    });
+    line("pread() loop", t, t);
+    t = timeBest(REPS, [&]() {
+        b = fstLoadAsync<int>(path).get();
+    });
+    line("fstLoadAsync", t, t);
+    sink(b[N-1]);
+
+    std::remove(path.c_str());
+}
+
+
+// readFull, writeFull
+// Move exactly n bytes through a pipe; return whether all were moved.
+bool readFull(int fd, void * buf, size_t n)
+{
+    char * p = static_cast<char *>(buf);
+    while (n != 0)
+    {
+        ssize_t got = ::read(fd, p, n);
+        if (got <= 0)
+            return false;
+        p += got;
+        n -= size_t(got);
+    }
+    return true;
+}
+
+bool writeFull(int fd, const void * buf, size_t n)
+{
+    const char * p = static_cast<const char *>(buf);
+    while (n != 0)
+    {
+        ssize_t done = ::write(fd, p, n);
+        if (done <= 0)
+            return false;
+        p += done;
+        n -= size_t(done);
+    }
+    return true;
+}
+
+
+// checksum
+// Sum of the ints in [first, last): the consumer's use of the data.
+long long checksum(const int * first, const int * last)
+{
+    long long sum = 0;
+    for (; first != last; ++first)
+        sum += *first;
+    return sum;
+}
+
+
+// benchShared
+// Handing an array of ints to another process, 1 MB to 1 GB: a pipe with
+//  serialization (size, then raw items; the consumer reads them into an
+//  FSTArray) against FSTSharedArray, filled by copying from an FSTArray,
+//  or built in place in the segment. Times are end to end, best of 3:
+//  from the producer starting to send until the consumer has summed the
+//  items & replied (one small pipe message each way, in both methods).
+void benchShared()
+{
+    cout << "shared" << endl;
+    cout << "  " << setw(10) << "bytes" << setw(14) << "pipe ms"
+         << setw(14) << "shm copy ms" << setw(14) << "shm built ms"
+         << endl;
+
+    for (size_t bytes = size_t(1) << 20; bytes <= size_t(1) << 30;
+         bytes *= 4)
+    {
+        const size_t N = bytes / sizeof(int);
+        const int REPS = bytes >= (size_t(256) << 20) ? 1 : 3;
+
+        // run
+        // Fork a consumer running consume(request fd, reply fd) REPS
+        //  times; time produce(request fd, reply fd) each time.
+        auto run = [&](auto consume, auto produce)
+        {
+            int toChild[2], toParent[2];
+            if (::pipe(toChild) != 0 || ::pipe(toParent) != 0)
+                return -1.0;
+            pid_t child = ::fork();
+            if (child == 0)
+            {
+                ::close(toChild[1]);
+                ::close(toParent[0]);
+                for (int r = 0; r < REPS; ++r)
+                    consume(toChild[0], toParent[1]);
+                ::_exit(0);
+            }
+            ::close(toChild[0]);
+            ::close(toParent[1]);
+            double t = timeBest(REPS, [&]() {
+                produce(toChild[1], toParent[0]);
+            });
+            ::close(toChild[1]);
+            ::close(toParent[0]);
+            ::waitpid(child, nullptr, 0);
+            return t;
+        };
+
+        double tPipe, tCopy, tBuilt;
+        {
+            FSTArray<int> source(N);
+            for (size_t i = 0; i < N; ++i)
+                source[i] = int(i);
+
+            tPipe = run(
+                [&](int in, int out) {
+                    size_t n = 0;
+                    readFull(in, &n, sizeof(n));
+                    FSTArray<int> a(n);
+                    readFull(in, &a[0], n * sizeof(int));
+                    long long sum = checksum(&a[0], &a[0] + n);
+                    writeFull(out, &sum, sizeof(sum));
+                },
+                [&](int out, int in) {
+                    size_t n = source.size();
+                    writeFull(out, &n, sizeof(n));
+                    writeFull(out, &source[0], n * sizeof(int));
+                    long long sum;
+                    readFull(in, &sum, sizeof(sum));
+                    sink(sum);
+                });
+
+            auto shm = FSTSharedArray<int>::createAnonymous(N);
+            auto consumeShared = [&](int in, int out) {
+                std::uint64_t version;
+                readFull(in, &version, sizeof(version));
+                auto r = FSTSharedArray<int>::fromFd(::dup(shm.fd()));
+                long long sum = r.read(checksum);
+                writeFull(out, &sum, sizeof(sum));
+            };
+            tCopy = run(consumeShared,
+                [&](int out, int in) {
+                    shm.assign(source.begin(), source.end());
+                    std::uint64_t version = shm.version();
+                    writeFull(out, &version, sizeof(version));
+                    long long sum;
+                    readFull(in, &sum, sizeof(sum));
+                    sink(sum);
+                });
+            tBuilt = run(consumeShared,
+                [&](int out, int in) {
+                    // Producer's data already lives in the segment
+                    shm.write([](FSTSharedArray<int> & a) { a[0] = 0; });
+                    std::uint64_t version = shm.version();
+                    writeFull(out, &version, sizeof(version));
+                    long long sum;
+                    readFull(in, &sum, sizeof(sum));
+                    sink(sum);
+                });
+        }
+        cout << "  " << setw(10) << bytes << std::fixed
+             << std::setprecision(3) << setw(14) << tPipe * 1.0e3
+             << setw(14) << tCopy * 1.0e3 << setw(14) << tBuilt * 1.0e3
+             << endl;
+    }
+}
+
+
+// benchRcu
+// Reader throughput on a 10K-int array, 1 to 64 reader threads, while a
+//  writer thread tries to insert or erase an item every millisecond
+//  (writes: how many it managed in the 200 ms): a global
+//  std::shared_mutex (readers lock per lookup; the writer changes the
+//  array in place) against FSTRcuArray (readers view() per lookup &
+//  are quiescent every 64 lookups; the writer publishes copies). A
+//  lookup sums 8 random items. Scaling needs as many cores as threads.
+void benchRcu()
+{
+    cout << "rcu" << endl;
+    const size_t N = 10000;
+    const auto DURATION = std::chrono::milliseconds(200);
+    cout << "  " << setw(8) << "readers" << setw(16) << "rwlock Mops/s"
+         << setw(10) << "writes" << setw(16) << "rcu Mops/s" << setw(10)
+         << "writes" << endl;
+
+    FSTArray<int> init(N);
+    for (size_t i = 0; i < N; ++i)
+        init[i] = int(i);
+
+    // run
+    // Run threads readers calling lookup(rng), & a writer calling
+    //  write(i) each ms, for DURATION; return lookups per second, & set
+    //  writes to the number of writes done.
+    auto run = [&](int threads, auto makeLookup, auto write, size_t & writes)
+    {
+        std::atomic<bool> stop(false);
+        std::atomic<size_t> total(0);
+        std::vector<std::thread> readers;
+        for (int t = 0; t < threads; ++t)
+            readers.emplace_back([&, t]() {
+                auto lookup = makeLookup();
+                std::mt19937 gen(static_cast<unsigned>(t) + 1);
+                size_t ops = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    lookup(gen);
+                    ++ops;
+                }
+                total += ops;
+            });
+        std::atomic<size_t> done(0);
+        std::thread writer([&]() {
+            while (!stop.load())
+            {
+                write(done.load());
+                ++done;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(DURATION);
+        writes = done.load();  // Writes done while readers ran
+        stop = true;
+        std::chrono::duration<double> d =
+            std::chrono::steady_clock::now() - start;
+        for (auto & th : readers)
+            th.join();
+        writer.join();
+        return double(total.load()) / d.count();
+    };
+
+    for (int threads = 1; threads <= 64; threads *= 2)
+    {
+        size_t writesLock = 0, writesRcu = 0;
+
+        FSTArray<int> locked(init);
+        std::shared_mutex mutex;
+        double lockRate = run(threads,
+            [&]() {
+                return [&](std::mt19937 & gen) {
+                    std::shared_lock<std::shared_mutex> lock(mutex);
+                    long sum = 0;
+                    for (int k = 0; k < 8; ++k)
+                        sum += locked[gen() % locked.size()];
+                    sink(sum);
+                };
+            },
+            [&](size_t i) {
+                std::unique_lock<std::shared_mutex> lock(mutex);
+                if (i % 2 == 0)
+                    locked.insert(locked.begin() + i % N, int(i));
+                else
+                    locked.erase(locked.begin() + i % N);
+            },
+            writesLock);
+
+        FSTRcuArray<int> rcu(init);
+        double rcuRate = run(threads,
+            [&]() {
+                return [&, r = rcu.reader(), ops = 0]
+                       (std::mt19937 & gen) mutable {
+                    const FSTArray<int> & v = r.view();
+                    long sum = 0;
+                    for (int k = 0; k < 8; ++k)
+                        sum += v[gen() % v.size()];
+                    sink(sum);
+                    if (++ops % 64 == 0)
+                        r.quiescent();
+                };
+            },
+            [&](size_t i) {
+                if (i % 2 == 0)
+                    rcu.insert(i % N, int(i));
+                else
+                    rcu.erase(i % N);
+            },
+            writesRcu);
+
+        cout << "  " << setw(8) << threads << std::fixed
+             << std::setprecision(1) << setw(16) << lockRate / 1.0e6
+             << setw(10) << writesLock << setw(16) << rcuRate / 1.0e6
+             << setw(10) << writesRcu << endl;
+    }
+}
+
+
+// benchSharded
+// 16M ints appended by 1 to 64 threads, then gathered into one array:
+//  a shared FSTArray with a mutex per push_back; a std::vector per
+//  thread (held in a std::vector), then concatenated; & FSTShardedArray,
+//  then concat. Times include both steps. Last, merging 8 sorted shards:
+//  mergeSorted against concat & std::sort.
+void benchSharded()
+{
+    cout << "sharded" << endl;
+    const size_t N = size_t(16) << 20;
+    const int REPS = 3;
+    cout << "  " << setw(8) << "threads" << setw(13) << "mutex ms"
+         << setw(13) << "vectors ms" << setw(13) << "sharded ms"
+         << setw(13) << "(concat ms)" << endl;
+
+    // onThreads
+    // Run f(t, count) on threads t = 0 .. threads-1, splitting N items.
+    auto onThreads = [&](size_t threads, auto f)
+    {
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < threads; ++t)
+            pool.emplace_back([&, t]() {
+                f(t, N / threads + (t < N % threads ? 1 : 0));
+            });
+        for (auto & th : pool)
+            th.join();
+    };
+
+    for (size_t threads = 1; threads <= 64; threads *= 2)
+    {
+        double tMutex = timeBest(REPS, [&]() {
+            FSTArray<int> shared(0);
+            std::mutex m;
+            onThreads(threads, [&](size_t t, size_t count) {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    shared.push_back(int(t + i));
+                }
+            });
+            sink(shared.size());
+        });
+
+        double tVectors = timeBest(REPS, [&]() {
+            std::vector<std::vector<int>> parts(threads);
+            onThreads(threads, [&](size_t t, size_t count) {
+                for (size_t i = 0; i < count; ++i)
+                    parts[t].push_back(int(t + i));
+            });
+            std::vector<int> all;
+            all.reserve(N);
+            for (auto & v : parts)
+                all.insert(all.end(), v.begin(), v.end());
+            sink(all.size());
+        });
+
+        double tConcat = 1.0e300;
+        double tSharded = timeBest(REPS, [&]() {
+            FSTShardedArray<int> sh(threads);
+            onThreads(threads, [&](size_t t, size_t count) {
+                FSTArray<int> & mine = sh.shard(t);
+                for (size_t i = 0; i < count; ++i)
+                    mine.push_back(int(t + i));
+            });
+            auto start = std::chrono::steady_clock::now();
+            FSTArray<int> all = sh.concat();
+            std::chrono::duration<double> d =
+                std::chrono::steady_clock::now() - start;
+            tConcat = std::min(tConcat, d.count());
+            sink(all.size());
+        });
+
+        cout << "  " << setw(8) << threads << std::fixed
+             << std::setprecision(1) << setw(13) << tMutex * 1.0e3
+             << setw(13) << tVectors * 1.0e3 << setw(13)
+             << tSharded * 1.0e3 << setw(13) << tConcat * 1.0e3 << endl;
+    }
+
+    FSTShardedArray<int> sorted(8);
+    std::mt19937 gen(311);
+    for (size_t t = 0; t < 8; ++t)
+    {
+        FSTArray<int> & s = sorted.shard(t);
+        for (size_t i = 0; i < N / 8; ++i)
+            s.push_back(int(gen() >> 1));
+        std::sort(s.begin(), s.end());
+    }
+    double tMerge = timeBest(REPS, [&]() {
+        sink(sorted.mergeSorted().size());
+    });
+    double tSort = timeBest(REPS, [&]() {
+        FSTArray<int> all = sorted.concat();
+        std::sort(all.begin(), all.end());
+        sink(all.size());
+    });
+    cout << "  8 sorted shards: mergeSorted " << std::setprecision(1)
+         << tMerge * 1.0e3 << " ms, concat & std::sort " << tSort * 1.0e3
+         << " ms" << endl;
+}
+
+
+// benchGather
+// Gathering & scattering 16M random indices into 256M ints (1 GB, more
+//  than the last-level cache): a plain operator[] loop against
+//  fstGather & fstScatter, by prefetch distance & index order; also
+//  gathering from a 1 MB array (AVX2 gathers, if built with
+//  FSTARRAY_AVX2_GATHER & AVX2). ns per index, best of 3.
+void benchGather()
+{
+    cout << "gather" << endl;
+    const size_t N = size_t(256) << 20;
+    const size_t M = size_t(16) << 20;
+    const int REPS = 3;
+#ifdef FSTARRAY_GATHER_USE_AVX2
+    cout << "  (built with AVX2 gathers)" << endl;
+#endif
+
+    FSTArray<int> a(N);
+    for (size_t i = 0; i < N; ++i)
+        a[i] = int(i);
+    FSTArray<int> idx(M);
+    std::mt19937 gen(311);
+    for (size_t k = 0; k < M; ++k)
+        idx[k] = int(gen() % N);
+    FSTArray<int> out(M);
+
+    double t = timeBest(REPS, [&]() {
+        for (size_t k = 0; k < M; ++k)
+            out[k] = a[size_t(idx[k])];
+        sink(out[M-1]);
+    });
+    report("gather: operator[] loop", t, M);
+
+    struct Config {
+        const char *   label;
+        size_t         dist;
+        FSTIndexOrder  order;
+    };
+    const Config configs[] = {
+        { "no prefetch", 0, FSTIndexOrder::given },
+        { "prefetch 8", 8, FSTIndexOrder::given },
+        { "prefetch 16", 16, FSTIndexOrder::given },
+        { "prefetch 32", 32, FSTIndexOrder::given },
+        { "prefetch 16, bucketed", 16, FSTIndexOrder::bucketed },
+        { "prefetch 16, sorted", 16, FSTIndexOrder::sorted },
+    };
+    for (const Config & c : configs)
+    {
+        FSTGatherOptions opts;
+        opts.prefetchDistance = c.dist;
+        opts.order = c.order;
+        t = timeBest(REPS, [&]() {
+            fstGather(a, idx, out, opts);
+            sink(out[M-1]);
+        });
+        report(string("fstGather, ") + c.label, t, M);
+    }
+
+    // In cache: 1 MB of the array
+    const size_t SMALL = size_t(256) << 10;
+    FSTArray<int> small(SMALL);
+    FSTArray<int> smallIdx(M);
+    for (size_t k = 0; k < M; ++k)
+        smallIdx[k] = idx[k] % int(SMALL);
+    t = timeBest(REPS, [&]() {
+        for (size_t k = 0; k < M; ++k)
+            out[k] = small[size_t(smallIdx[k])];
+        sink(out[M-1]);
+    });
+    report("gather, 1 MB array: operator[] loop", t, M);
+    t = timeBest(REPS, [&]() {
+        fstGather(small, smallIdx, out);
+        sink(out[M-1]);
+    });
+    report("gather, 1 MB array: fstGather", t, M);
+
+    t = timeBest(REPS, [&]() {
+        for (size_t k = 0; k < M; ++k)
+            a[size_t(idx[k])] = out[k];
+        sink(a[0]);
+    });
+    report("scatter: operator[] loop", t, M);
+    for (const Config & c : configs)
+    {
+        if (c.dist == 8 || c.dist == 32)
+            continue;
+        FSTGatherOptions opts;
+        opts.prefetchDistance = c.dist;
+        opts.order = c.order;
+        t = timeBest(REPS, [&]() {
+            fstScatter(a, idx, out, opts);
+            sink(a[0]);
+        });
+        report(string("fstScatter, ") + c.label, t, M);
+    }
+}
+
+
+// benchExpr
+// Item-wise arithmetic on FSTArray<double>, 3 operands (a * 2 + b) & 6
+//  operands ((a + b) * (c - d) / e + f), in cache (64K items) & out
+//  (32M items): unfused, one loop per operator into a new temporary
+//  array, as operators returning FSTArray would do; a handwritten fused
+//  loop; & fstarray_expr.h expressions, assigned to an array of the
+//  right size. ns per item, best of 5.
+void benchExpr()
+{
+    cout << "expr" << endl;
+    const int REPS = 5;
+
+    // unfused: x op y into a new array
+    auto unfused = [](const FSTArray<double> & x,
+                      const FSTArray<double> & y,
+                      auto op)
+    {
+        size_t n = x.size();
+        FSTArray<double> r(n);
+        double * rp = &r[0];
+        const double * xp = &x[0];
+        const double * yp = &y[0];
+        for (size_t i = 0; i < n; ++i)
+            rp[i] = op(xp[i], yp[i]);
+        return r;
+    };
+    auto plus = [](double x, double y) { return x + y; };
+    auto minus = [](double x, double y) { return x - y; };
+    auto times = [](double x, double y) { return x * y; };
+    auto divide = [](double x, double y) { return x / y; };
+
+    const size_t sizes[] = { size_t(1) << 16, size_t(1) << 25 };
+    for (size_t n : sizes)
+    {
+        string where = n < (size_t(1) << 20) ? "64K items: "
+                                             : "32M items: ";
+        FSTArray<double> arr[6] = { FSTArray<double>(n), FSTArray<double>(n),
+            FSTArray<double>(n), FSTArray<double>(n), FSTArray<double>(n),
+            FSTArray<double>(n) };
+        for (int k = 0; k < 6; ++k)
+            for (size_t i = 0; i < n; ++i)
+                arr[k][i] = 1.0 + double((i * (k+3)) % 101);
+        const FSTArray<double> & a = arr[0];
+        const FSTArray<double> & b = arr[1];
+        const FSTArray<double> & c = arr[2];
+        const FSTArray<double> & d = arr[3];
+        const FSTArray<double> & e = arr[4];
+        const FSTArray<double> & f = arr[5];
+        FSTArray<double> out(n);
+        size_t reps = (size_t(1) << 26) / n;  // Time ~64M items per rep
+
+        // 3 operands
+        FSTArray<double> two(n);
+        for (size_t i = 0; i < n; ++i)
+            two[i] = 2.0;
+        double t = timeBest(REPS, [&]() {
+            for (size_t r = 0; r < reps; ++r)
+                out = unfused(unfused(a, two, times), b, plus);
+            sink(out[n-1]);
+        });
+        report(where + "a*2+b, unfused", t, n * reps);
+        t = timeBest(REPS, [&]() {
+            for (size_t r = 0; r < reps; ++r)
+            {
+                double * op = &out[0];
+                const double * ap = &a[0];
+                const double * bp = &b[0];
+                for (size_t i = 0; i < n; ++i)
+                    op[i] = ap[i] * 2.0 + bp[i];
+            }
+            sink(out[n-1]);
+        });
+        report(where + "a*2+b, handwritten loop", t, n * reps);
+        t = timeBest(REPS, [&]() {
+            for (size_t r = 0; r < reps; ++r)
+                out = a * 2.0 + b;
+            sink(out[n-1]);
+        });
+        report(where + "a*2+b, expression", t, n * reps);
+
+        // 6 operands
+        t = timeBest(REPS, [&]() {
+            for (size_t r = 0; r < reps; ++r)
+                out = unfused(unfused(unfused(unfused(a, b, plus),
+                                              unfused(c, d, minus), times),
+                                      e, divide),
+                              f, plus);
+            sink(out[n-1]);
+        });
+        report(where + "(a+b)*(c-d)/e+f, unfused", t, n * reps);
+        t = timeBest(REPS, [&]() {
+            for (size_t r = 0; r < reps; ++r)
+            {
+                double * op = &out[0];
+                const double * ap = &a[0];
+                const double * bp = &b[0];
+                const double * cp = &c[0];
+                const double * dp = &d[0];
+                const double * ep = &e[0];
+                const double * fp = &f[0];
+                for (size_t i = 0; i < n; ++i)
+                    op[i] = (ap[i] + bp[i]) * (cp[i] - dp[i]) / ep[i] + fp[i];
+            }
+            sink(out[n-1]);
+        });
+        report(where + "(a+b)*(c-d)/e+f, handwritten loop", t, n * reps);
+        t = timeBest(REPS, [&]() {
+            for (size_t r = 0; r < reps; ++r)
+                out = (a + b) * (c - d) / e + f;
+            sink(out[n-1]);
+        });
+        report(where + "(a+b)*(c-d)/e+f, expression", t, n * reps);
+    }
+}
+
+
+// sumOf
+// Pipeline stage for benchSlice: sum of items. The "before" version
+//  takes an FSTArray, so callers must copy a sub-range into one.
+template <typename Items>
+long long sumOf(const Items & items)
+{
+    long long total = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+        total += items[i];
+    return total;
+}
+
+
+// benchSlice
+// A pipeline over 32M ints (128 MB) that slices the array: per-chunk
+//  sums (chunks of 1K & 64K items; also over a 4 MB part, in cache), a
+//  sum of every 16th item, & handing each 64K chunk to a later stage
+//  that keeps it. Before: each slice
+//  copied into a new FSTArray; after: FSTArrayView, FSTStridedView &
+//  FSTArraySlice. ns per item of the array, best of 3.
+void benchSlice()
+{
+    cout << "slice" << endl;
+    const size_t N = size_t(32) << 20;
+    const int REPS = 3;
+
+    FSTArray<int> a(N);
+    for (size_t i = 0; i < N; ++i)
+        a[i] = int(i % 1000);
+
+    // Chunk sums, over all of a, & over its first 1M items (4 MB, in
+    //  cache), repeated to cover as many items
+    const size_t chunks[] = { size_t(1) << 10, size_t(1) << 16 };
+    const size_t spans[] = { size_t(1) << 20, N };
+    for (size_t span : spans)
+    for (size_t chunk : chunks)
+    {
+        string label = string("chunk sums, ")
+                     + (span == N ? "128 MB, " : "4 MB, ")
+                     + std::to_string(chunk >> 10) + "K: ";
+        double t = timeBest(REPS, [&]() {
+            long long total = 0;
+            for (size_t round = 0; round < N / span; ++round)
+            for (size_t at = 0; at < span; at += chunk)
+            {
+                FSTArray<int> part(chunk);
+                std::copy(&a[0] + at, &a[0] + at + chunk, &part[0]);
+                total += sumOf(part);
+            }
+            sink(total);
+        });
+        report(label + "copy to FSTArray", t, N);
+        t = timeBest(REPS, [&]() {
+            FSTArrayView<const int> all(a);
+            long long total = 0;
+            for (size_t round = 0; round < N / span; ++round)
+            for (size_t at = 0; at < span; at += chunk)
+                total += sumOf(all.subview(at, chunk));
+            sink(total);
+        });
+        report(label + "FSTArrayView", t, N);
+    }
+
+    const size_t STEP = 16;
+    double t = timeBest(REPS, [&]() {
+        FSTArray<int> sample(N / STEP);
+        for (size_t i = 0; i < N / STEP; ++i)
+            sample[i] = a[i * STEP];
+        sink(sumOf(sample));
+    });
+    report("every 16th: copy to FSTArray", t, N);
+    t = timeBest(REPS, [&]() {
+        sink(sumOf(FSTArrayView<const int>(a).strided(STEP)));
+    });
+    report("every 16th: FSTStridedView", t, N);
+
+    // Hand-off: a later stage keeps each 64K chunk
+    const size_t CHUNK = size_t(1) << 16;
+    t = timeBest(REPS, [&]() {
+        std::vector<FSTArray<int>> kept;
+        for (size_t at = 0; at < N; at += CHUNK)
+        {
+            FSTArray<int> part(CHUNK);
+            std::copy(&a[0] + at, &a[0] + at + CHUNK, &part[0]);
+            kept.push_back(std::move(part));
+        }
+        sink(sumOf(kept[kept.size() / 2]));
+    });
+    report("keep 64K chunks: copy to FSTArray", t, N);
+    FSTArraySlice<int> shared{ FSTArray<int>(a) };  // Setup: not timed
+    t = timeBest(REPS, [&]() {
+        std::vector<FSTArraySlice<int>> kept;
+        for (size_t at = 0; at < N; at += CHUNK)
+            kept.push_back(shared.slice(at, CHUNK));
+        sink(sumOf(kept[kept.size() / 2]));
+    });
+    report("keep 64K chunks: FSTArraySlice", t, N);
+}
+
+
+// benchHash
+// Equality & hashing of FSTArray<int>, 1 KB to 1 GB, each timing
+//  covering at least 1 GB: an item-by-item loop against operator==
+//  (std::memcmp), & an ad-hoc hash (hash_combine of std::hash per item)
+//  against std::hash<FSTArray> (fstHashBytes). GB/s, best of 3.
+void benchHash()
+{
+    cout << "hash" << endl;
+    const int REPS = 3;
+    const size_t GB = size_t(1) << 30;
+    const size_t sizes[] = { size_t(1) << 10, size_t(1) << 16,
+                             size_t(1) << 20, size_t(1) << 26, GB };
+
+    // gbPerSec: print label & rate for bytes in t seconds
+    auto gbPerSec = [](const string & label,
+                       double t,
+                       size_t bytes)
+    {
+        cout << "  " << std::left << setw(40) << label << std::right
+             << std::fixed << std::setprecision(2) << setw(8)
+             << double(bytes) / t / 1e9 << " GB/s" << endl;
+    };
+
+    for (size_t bytes : sizes)
+    {
+        size_t n = bytes / sizeof(int);
+        size_t reps = GB / bytes;
+        string where = bytes < (size_t(1) << 20)
+            ? std::to_string(bytes >> 10) + " KB: "
+            : std::to_string(bytes >> 20) + " MB: ";
+
+        FSTArray<int> a(n);
+        for (size_t i = 0; i < n; ++i)
+            a[i] = int(i * 2654435761u);
+        FSTArray<int> b(a);
+
+        double t = timeBest(REPS, [&]() {
+            bool same = true;
+            for (size_t r = 0; r < reps; ++r)
+            {
+                const int * ap = &a[0];
+                const int * bp = &b[0];
+                bool eq = a.size() == b.size();
+                for (size_t i = 0; eq && i < n; ++i)
+                    eq = ap[i] == bp[i];
+                same = same && eq;
+            }
+            sink(same);
+        });
+        gbPerSec(where + "equal, item loop", t, bytes * reps);
+        t = timeBest(REPS, [&]() {
+            bool same = true;
+            for (size_t r = 0; r < reps; ++r)
+                same = same && a == b;
+            sink(same);
+        });
+        gbPerSec(where + "equal, operator==", t, bytes * reps);
+
+        t = timeBest(REPS, [&]() {
+            size_t h = 0;
+            for (size_t r = 0; r < reps; ++r)
+            {
+                size_t seed = n;
+                const int * ap = &a[0];
+                for (size_t i = 0; i < n; ++i)
+                    seed ^= std::hash<int>()(ap[i]) + 0x9E3779B9
+                          + (seed << 6) + (seed >> 2);
+                h += seed;
+            }
+            sink(h);
+        });
+        gbPerSec(where + "hash, hash_combine loop", t, bytes * reps);
+        t = timeBest(REPS, [&]() {
+            size_t h = 0;
+            for (size_t r = 0; r < reps; ++r)
+                h += std::hash<FSTArray<int>>()(a);
+            sink(h);
+        });
+        gbPerSec(where + "hash, std::hash<FSTArray>", t, bytes * reps);
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// struct BenchEntry
+// Name & function for one benchmark.
+struct BenchEntry {
+    const char * name;
+    void (*func)();
+};
+
+const BenchEntry benchmarks[] = {
+    { "checked", benchChecked },
+    { "slotmap", benchSlotMap },
+    { "erase_if", benchEraseIf },
+    { "buffercache", benchBufferCache },
+    { "asyncgrowth", benchAsyncGrowth },
+    { "fixed", benchFixed },
+    { "constexprtable", benchConstexprTable },
+    { "shrink", benchShrink },
+    { "packed", benchPacked },
+    { "frozen", benchFrozen },
+    { "sort", benchSort },
+    { "read", benchRead },
+    { "asyncsave", benchAsyncSave },
+    { "shared", benchShared },
+    { "rcu", benchRcu },
+    { "sharded", benchSharded },
+    { "gather", benchGather },
+    { "expr", benchExpr },
+    { "slice", benchSlice },
+    { "hash", benchHash },
+};
+
+
+// Main program
+// Run the benchmarks named on the command line, or all of them.
+int main(int argc,
+         char *argv[])
+{
+    bool found = false;
+    for (const auto & b : benchmarks)
+    {
+        bool run = (argc == 1);
+        for (int i = 1; i < argc; ++i)
+        {
+            if (strcmp(argv[i], b.name) == 0)
+                run = true;
+        }
+        if (run)
+        {
+            b.func();
+            cout << endl;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        cout << "Benchmarks:";
+        for (const auto & b : benchmarks)
+            cout << " " << b.name;
+        cout << endl;
+        return 1;
+    }
+    return 0;
+}
+
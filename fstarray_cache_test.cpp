@@ -0,0 +1,152 @@
+// fstarray_cache_test.cpp
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Test program for class template FSTArray with the buffer cache
+// Built with FSTARRAY_BUFFER_CACHE (defined below, as well as by the
+//  build); counts the buffers FSTArray takes from its thread's
+//  FSTBufferCache, to check that buffers are reused and that shrinking
+//  does not reallocate needlessly.
+// Does not wait for ENTER, so it can run unattended (ctest).
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, fstarray.h, fstbuffercache.h
+
+#ifndef FSTARRAY_BUFFER_CACHE
+#define FSTARRAY_BUFFER_CACHE
+#endif
+
+// Includes for code to be tested
+#include "fstarray.h"        // For class template FSTArray
+#include "fstbuffercache.h"  // For class template FSTBufferCache
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template FSTArray - buffer cache";
+
+
+// *********************************************************************
+// Helper Functions
+// *********************************************************************
+
+
+// allocations
+// Return number of buffers FSTArray<int> has asked this thread's cache
+//  for (each allocation asks, whether or not the cache has one).
+size_t allocations()
+{
+    const FSTBufferCache<int> & cache = FSTBufferCache<int>::local();
+    return cache.hits() + cache.misses();
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Buffer cache - freed buffers are reused" )
+{
+    FSTBufferCache<int>::local().flush();
+    {
+        FSTArray<int> a(1000);
+        a[999] = 1;
+    }
+    size_t hitsBefore = FSTBufferCache<int>::local().hits();
+    FSTArray<int> b(900);
+    {
+    INFO( "Array of the same capacity class takes the cached buffer" );
+    REQUIRE( FSTBufferCache<int>::local().hits() == hitsBefore + 1 );
+    REQUIRE( b.capacity() == size_t(1024) );
+    }
+}
+
+
+TEST_CASE( "Buffer cache - shrink policy does not reallocate in place" )
+{
+    // Sizes in (cap/4, cap/3] ask FSTShrinkBelow<3> for 2*size, which
+    //  rounds back up to the current capacity
+    FSTArray<int, FSTShrinkBelow<3>> a(0);
+    while (a.capacity() < 64)
+        a.push_back(0);
+    while (a.size() > 21)
+        a.pop_back();
+    {
+    INFO( "Setup - capacity 64, size just above a third" );
+    REQUIRE( a.capacity() == size_t(64) );
+    REQUIRE( a.size() == size_t(21) );
+    }
+
+    size_t before = allocations();
+    for (int i = 0; i < 100; ++i)
+    {
+        a.pop_back();
+        a.push_back(i);
+    }
+    {
+    INFO( "pop_back & push_back at the threshold do not reallocate" );
+    REQUIRE( allocations() == before );
+    REQUIRE( a.capacity() == size_t(64) );
+    }
+
+    while (a.size() > 15)
+        a.pop_back();
+    {
+    INFO( "Shrinks once the rounded capacity is smaller" );
+    REQUIRE( a.capacity() == size_t(32) );
+    REQUIRE( allocations() == before + 1 );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// Main program
+// Run all tests. Does not wait for ENTER.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n"
+             << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n"
+             << endl;
+    }
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
+
@@ -0,0 +1,423 @@
+// fstarray_expr.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Lazy element-wise arithmetic on FSTArray (expression templates),
+//  evaluated in one fused pass on assignment
+
+#ifndef FILE_FSTARRAY_EXPR_H_INCLUDED
+#define FILE_FSTARRAY_EXPR_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <stdexcept>
+// For std::out_of_range
+#include <type_traits>
+// For std::enable_if_t
+// For std::is_arithmetic_v
+// For std::decay_t
+// For std::true_type
+// For std::false_type
+#include <utility>
+// For std::declval
+
+// Element-wise arithmetic:
+//     a + b, a - b, a * b, a / b, -a
+//  where each operand is an FSTArray, an expression, or (for one of the
+//  two operands of a binary operator) a scalar of arithmetic type, which
+//  stands for an array of that value. The result is not an array but an
+//  FSTExpr: a small object that records the operation & refers to its
+//  operands. Nothing is computed, and nothing is allocated, until the
+//  expression is assigned to an FSTArray:
+//     c = a * 2.0 + b;           // One loop: c[i] = a[i] * 2.0 + b[i]
+//     FSTArray<double> d = -c / a;
+//  Assignment makes one pass over the operands, writing straight into
+//  the destination's buffer; the buffer is reused if its capacity allows
+//  (if the destination already has the expression's size, it is not
+//  reallocated at all). The loop has no calls & no temporaries, so the
+//  compiler can vectorize it. The destination may also be an operand
+//  (a = a * 2.0 + b): item i is computed from items i only.
+// Element types mix as they would for single values (an FSTArray<int>
+//  times 0.5 gives double items), converted to the destination's
+//  value_type on assignment. Items may be of any type with the needed
+//  operators, not only arithmetic types.
+// Lifetime: an expression refers to the buffers of its array operands,
+//  like an iterator. Assign it before any operand is resized, modified
+//  or destroyed. In particular, do not keep an expression in an auto
+//  variable past the end of a statement that made a temporary operand.
+// Errors: building an expression from arrays of different sizes throws
+//  std::out_of_range.
+// Guarantees: assignment gives the Strong Guarantee if the operations &
+//  item assignment cannot throw (as for arithmetic types); otherwise,
+//  Basic Guarantee. Exception neutral.
+
+
+template <typename Node>
+class FSTExpr;
+
+
+// *********************************************************************
+// Implementation details
+// *********************************************************************
+
+
+namespace fst_expr_detail {
+
+    // Expression nodes
+    // Each has operator[](i), giving item i, & size(). Nodes hold their
+    //  children by value & arrays by pointer, so copying a whole
+    //  expression copies a few pointers & scalars.
+
+    // struct Leaf
+    // An FSTArray operand.
+    template <typename T>
+    struct Leaf {
+        static constexpr bool SIZED = true;
+
+        const T * data;
+        std::size_t n;
+
+        const T & operator[](std::size_t i) const noexcept
+        {
+            return data[i];
+        }
+
+        std::size_t size() const noexcept
+        {
+            return n;
+        }
+    };
+
+    // struct Scalar
+    // A scalar operand: the same item at every index.
+    template <typename T>
+    struct Scalar {
+        static constexpr bool SIZED = false;
+
+        T value;
+
+        const T & operator[](std::size_t) const noexcept
+        {
+            return value;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return 0;
+        }
+    };
+
+    // Operations
+    struct Add {
+        template <typename A, typename B>
+        static auto apply(const A & a, const B & b) { return a + b; }
+    };
+
+    struct Subtract {
+        template <typename A, typename B>
+        static auto apply(const A & a, const B & b) { return a - b; }
+    };
+
+    struct Multiply {
+        template <typename A, typename B>
+        static auto apply(const A & a, const B & b) { return a * b; }
+    };
+
+    struct Divide {
+        template <typename A, typename B>
+        static auto apply(const A & a, const B & b) { return a / b; }
+    };
+
+    // struct Binary
+    // Operation applied to items of two operands, at least one sized.
+    template <typename Op, typename L, typename R>
+    struct Binary {
+        static constexpr bool SIZED = true;
+
+        L left;
+        R right;
+
+        auto operator[](std::size_t i) const
+        {
+            return Op::apply(left[i], right[i]);
+        }
+
+        std::size_t size() const noexcept
+        {
+            if constexpr (L::SIZED)
+                return left.size();
+            else
+                return right.size();
+        }
+    };
+
+    // struct Negate
+    // Unary minus applied to items of an operand.
+    template <typename E>
+    struct Negate {
+        static constexpr bool SIZED = true;
+
+        E operand;
+
+        auto operator[](std::size_t i) const
+        {
+            return -operand[i];
+        }
+
+        std::size_t size() const noexcept
+        {
+            return operand.size();
+        }
+    };
+
+    // isArray, isExpr
+    // Whether T is an FSTArray, an FSTExpr.
+    template <typename T>
+    struct isArray : std::false_type {};
+
+    template <typename T, typename P>
+    struct isArray<FSTArray<T, P>> : std::true_type {};
+
+    template <typename T>
+    struct isExpr : std::false_type {};
+
+    template <typename N>
+    struct isExpr<FSTExpr<N>> : std::true_type {};
+
+    // SIZED_OPERAND<T>: T is an array or expression
+    template <typename T>
+    constexpr bool SIZED_OPERAND = isArray<T>::value || isExpr<T>::value;
+
+    // BINARY_OK<L, R>: operator is ours -- both are operands, & at least
+    //  one is sized
+    template <typename L, typename R>
+    constexpr bool BINARY_OK =
+        (SIZED_OPERAND<L> || SIZED_OPERAND<R>)
+     && (SIZED_OPERAND<L> || std::is_arithmetic_v<L>)
+     && (SIZED_OPERAND<R> || std::is_arithmetic_v<R>);
+
+    // node
+    // Return the expression node for an operand.
+    template <typename T, typename P>
+    Leaf<T> node(const FSTArray<T, P> & a)
+    {
+        return Leaf<T>{ a.size() == 0 ? nullptr : &a[0], a.size() };
+    }
+
+    template <typename N>
+    const N & node(const FSTExpr<N> & e) noexcept
+    {
+        return e.node();
+    }
+
+    template <typename T,
+              typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    Scalar<T> node(T value) noexcept
+    {
+        return Scalar<T>{ value };
+    }
+
+    // makeBinary
+    // Return expression applying Op to items of l & r.
+    // Throws std::out_of_range if both are sized & sizes differ.
+    template <typename Op, typename L, typename R>
+    auto makeBinary(const L & l,
+                    const R & r)
+    {
+        auto ln = node(l);
+        auto rn = node(r);
+        using LN = decltype(ln);
+        using RN = decltype(rn);
+        if constexpr (LN::SIZED && RN::SIZED)
+        {
+            if (ln.size() != rn.size())
+                throw std::out_of_range(
+                    "FSTArray expression: operand sizes differ");
+        }
+        return FSTExpr<Binary<Op, LN, RN>>(Binary<Op, LN, RN>{ ln, rn });
+    }
+
+}  // End namespace fst_expr_detail
+
+
+// *********************************************************************
+// class FSTExpr - Class definition
+// *********************************************************************
+
+
+// class FSTExpr
+// Lazy element-wise expression over FSTArrays (see top of file). Made by
+//  the arithmetic operators; evaluated by assigning it to an FSTArray,
+//  or by constructing an FSTArray from it.
+// Invariants:
+//     _node's array operands all have size size().
+//
+// Node = expression tree (see fst_expr_detail)
+template <typename Node>
+class FSTExpr {
+
+// ***** FSTExpr: types *****
+public:
+
+    // fst_expression_tag: marks expressions, for FSTArray's op=
+    using fst_expression_tag = void;
+    // value_type: type of items
+    using value_type = std::decay_t<decltype(std::declval<const Node &>()[0])>;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+
+// ***** FSTExpr: ctors *****
+public:
+
+    // Ctor from node
+    // No-Throw Guarantee
+    explicit FSTExpr(const Node & node) noexcept
+        :_node(node)
+    {}
+
+// ***** FSTExpr: general public functions *****
+public:
+
+    // operator[]
+    // Compute item index.
+    // Pre:
+    //     index < size().
+    value_type operator[](size_type index) const
+    {
+        return _node[index];
+    }
+
+    // size
+    // No-Throw Guarantee
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return _node.size();
+    }
+
+    // node
+    // Return the expression tree.
+    // No-Throw Guarantee
+    const Node & node() const noexcept
+    {
+        return _node;
+    }
+
+    // assignTo
+    // Evaluate into dest, in one pass, making dest's size size(). dest
+    //  keeps its buffer if it already has size size(), or if its
+    //  capacity is enough; otherwise it gets a new one of that size,
+    //  with no copying of old items.
+    // Strong Guarantee if the operations & item assignment cannot
+    //  throw; otherwise Basic Guarantee
+    // Exception neutral
+    template <typename Array>
+    void assignTo(Array & dest) const
+    {
+        size_type n = size();
+        if (dest.size() != n)  // Then dest is not an operand
+        {
+            if (n >= dest.capacity())
+            {
+                Array fresh(n);
+                _evaluate(fresh);
+                dest.swap(fresh);
+                return;
+            }
+            dest.resize(n);
+        }
+        _evaluate(dest);
+    }
+
+// ***** FSTExpr: internal-use functions *****
+private:
+
+    // _evaluate
+    // Set dest[i] to item i, for each i.
+    // Pre:
+    //     dest.size() == size().
+    template <typename Array>
+    void _evaluate(Array & dest) const
+    {
+        size_type n = size();
+        if (n == 0)
+            return;
+        typename Array::value_type * out = &dest[0];
+        const Node node = _node;  // Local copy: pointers stay in registers
+        // Item i depends only on items i, even when dest is an operand
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC ivdep
+#endif
+        for (size_type i = 0; i < n; ++i)
+            out[i] = node[i];
+    }
+
+// ***** FSTExpr: data members *****
+private:
+
+    Node _node;  // Expression tree
+
+};  // End class FSTExpr
+
+
+// *********************************************************************
+// Arithmetic operators
+// *********************************************************************
+
+
+// operator+, operator-, operator*, operator/ (binary)
+// Return expression for the item-wise operation. One of l, r may be an
+//  arithmetic scalar.
+// Throws std::out_of_range if l & r are arrays or expressions of
+//  different sizes.
+// Strong Guarantee
+template <typename L, typename R,
+          typename = std::enable_if_t<fst_expr_detail::BINARY_OK<L, R>>>
+auto operator+(const L & l,
+               const R & r)
+{
+    return fst_expr_detail::makeBinary<fst_expr_detail::Add>(l, r);
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<fst_expr_detail::BINARY_OK<L, R>>>
+auto operator-(const L & l,
+               const R & r)
+{
+    return fst_expr_detail::makeBinary<fst_expr_detail::Subtract>(l, r);
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<fst_expr_detail::BINARY_OK<L, R>>>
+auto operator*(const L & l,
+               const R & r)
+{
+    return fst_expr_detail::makeBinary<fst_expr_detail::Multiply>(l, r);
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<fst_expr_detail::BINARY_OK<L, R>>>
+auto operator/(const L & l,
+               const R & r)
+{
+    return fst_expr_detail::makeBinary<fst_expr_detail::Divide>(l, r);
+}
+
+
+// operator- (unary)
+// Return expression for item-wise negation.
+// No-Throw Guarantee
+template <typename E,
+          typename = std::enable_if_t<fst_expr_detail::SIZED_OPERAND<E>>>
+auto operator-(const E & e)
+{
+    using N = decltype(fst_expr_detail::node(e));
+    using Neg = fst_expr_detail::Negate<std::decay_t<N>>;
+    return FSTExpr<Neg>(Neg{ fst_expr_detail::node(e) });
+}
+
+
+#endif  //#ifndef FILE_FSTARRAY_EXPR_H_INCLUDED
+
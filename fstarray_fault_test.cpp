@@ -0,0 +1,519 @@
+// fstarray_fault_test.cpp
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Fault-injection test program for class template FSTArray
+// For each operation, and for every k, makes the k-th allocation (in
+//  one sweep) or the k-th item operation (in another) throw, then
+//  checks the class invariants of FSTArray, the documented exception
+//  guarantee, and that nothing leaked.
+// Does not wait for ENTER, so it can run unattended (ctest).
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, fstarray.h
+
+// Includes for code to be tested
+#include "fstarray.h"        // For class template FSTArray
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdlib>
+using std::malloc;
+using std::free;
+#include <new>
+using std::bad_alloc;
+#include <vector>
+using std::vector;
+#include <stdexcept>
+using std::runtime_error;
+#include <functional>
+using std::function;
+#include <utility>
+using std::move;
+#include <type_traits>
+using std::type_identity_t;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template FSTArray - fault injection";
+
+
+// *********************************************************************
+// Fault Injection
+// *********************************************************************
+
+
+// Countdowns: when one reaches zero, the next event of that kind fails.
+//  Negative means never fail.
+long allocCountdown = -1;    // Array allocations (operator new [])
+long itemCountdown = -1;     // FaultItem default ctor, copy ctor, copy =
+
+// Number of arrays currently allocated with operator new []
+size_t liveArrays = 0;
+
+
+// fireFault
+// Count down; return true if this event must fail.
+// Does not throw (No-Throw Guarantee)
+bool fireFault(long & countdown)
+{
+    if (countdown < 0)
+        return false;
+    return countdown-- == 0;
+}
+
+
+// Replacement array allocation functions
+// FSTArray gets every buffer from new [] and returns it with delete [],
+//  so these see all of its allocations, and nothing else here uses
+//  them.
+void * operator new[](size_t n)
+{
+    if (fireFault(allocCountdown))
+        throw bad_alloc();
+    void * p = malloc(n == 0 ? 1 : n);
+    if (p == nullptr)
+        throw bad_alloc();
+    ++liveArrays;
+    return p;
+}
+
+void operator delete[](void * p) noexcept
+{
+    if (p == nullptr)
+        return;
+    --liveArrays;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+// False positive: p came from malloc, in our operator new [] above
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+    free(p);
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+}
+
+void operator delete[](void * p, size_t) noexcept
+{
+    operator delete[](p);
+}
+
+
+// class FaultItem
+// Item type whose default ctor, copy ctor, and copy assignment count
+//  down itemCountdown, and throw std::runtime_error when it fires.
+//  Has no move operations, so moves (e.g., in std::swap) are copies
+//  and may throw too.
+// Invariants:
+//     FaultItem::_live is the number of existing FaultItem objects.
+class FaultItem {
+
+public:
+
+    FaultItem()
+        :_value(0)
+    {
+        _op();
+        ++_live;
+    }
+
+    // Ctor from int; never fails. For setting up test arrays.
+    explicit FaultItem(int value) noexcept
+        :_value(value)
+    {
+        ++_live;
+    }
+
+    FaultItem(const FaultItem & other)
+        :_value(other._value)
+    {
+        _op();
+        ++_live;
+    }
+
+    FaultItem & operator=(const FaultItem & other)
+    {
+        _op();
+        _value = other._value;
+        return *this;
+    }
+
+    ~FaultItem()
+    {
+        --_live;
+    }
+
+    int value() const noexcept
+    {
+        return _value;
+    }
+
+    static size_t live() noexcept
+    {
+        return _live;
+    }
+
+private:
+
+    static void _op()
+    {
+        if (fireFault(itemCountdown))
+            throw runtime_error("injected item fault");
+    }
+
+    int _value;
+    static size_t _live;
+
+};  // End class FaultItem
+
+size_t FaultItem::_live = size_t(0);
+
+
+// *********************************************************************
+// Sweep Driver
+// *********************************************************************
+
+
+using FArray = FSTArray<FaultItem>;
+using SArray = FSTArray<FaultItem, FSTShrinkQuarter>;
+
+
+// makeArray
+// Return array of given size holding 0, 1, ..., size-1, made with no
+//  faults armed.
+template <typename Array=FArray>
+Array makeArray(size_t size)
+{
+    Array a(size);
+    for (size_t i = 0; i < size; ++i)
+        a[i] = FaultItem(int(i));
+    return a;
+}
+
+
+// contents
+// Return values in a as a vector.
+template <typename Array>
+vector<int> contents(const Array & a)
+{
+    vector<int> v;
+    for (auto it = a.begin(); it != a.end(); ++it)
+        v.push_back(it->value());
+    return v;
+}
+
+
+// Guarantee made by an operation when an item operation or allocation
+//  throws. (When an allocation fails, every single operation must make
+//  the Strong Guarantee; a sequence of operations need not.)
+enum class Guarantee { STRONG, BASIC };
+
+
+// faultSweep
+// For k = 0, 1, ...: make a fresh array with setup, arm the k-th fault
+//  of the given kind, and apply op. Stop at the first k for which op
+//  completes without a fault. After each run, check:
+//     0 <= size() <= capacity(); a buffer exists if capacity() > 0.
+//     If op threw: contents unchanged, if guarantee is STRONG.
+//     The array is still usable (copy & push_back).
+//     No arrays or items leaked.
+template <typename Array>
+void faultSweep(long & countdown,
+                size_t setupSize,
+                const function<void (Array &)> & op,
+                Guarantee guarantee)
+{
+    bool strong = (guarantee == Guarantee::STRONG);
+
+    for (long k = 0; ; ++k)
+    {
+        size_t arraysBefore = liveArrays;
+        size_t itemsBefore = FaultItem::live();
+        bool threw = false;
+        {
+            Array a = makeArray<Array>(setupSize);
+            vector<int> before = contents(a);
+
+            countdown = k;
+            try
+            {
+                op(a);
+            }
+            catch (...)
+            {
+                threw = true;
+            }
+            countdown = -1;
+
+            {
+            INFO( "Invariant: size <= capacity" );
+            REQUIRE( a.size() <= a.capacity() );
+            }
+            {
+            INFO( "Invariant: array owned when capacity > 0" );
+            REQUIRE( (a.capacity() == 0 || a.begin() != nullptr) );
+            }
+            if (threw && strong)
+            {
+            INFO( "Strong Guarantee: contents unchanged after fault" );
+            REQUIRE( contents(a) == before );
+            }
+
+            Array b(a);
+            b.push_back(FaultItem(-1));
+            {
+            INFO( "Array usable after fault" );
+            REQUIRE( b.size() == a.size()+1 );
+            }
+        }
+        {
+        INFO( "No leaked arrays after fault" );
+        REQUIRE( liveArrays == arraysBefore );
+        }
+        {
+        INFO( "No leaked items after fault" );
+        REQUIRE( FaultItem::live() == itemsBefore );
+        }
+
+        if (!threw)
+            break;
+    }
+}
+
+
+// sweepBoth
+// Run faultSweep for allocation faults, then for item faults.
+// Array is not deduced from op (a lambda); give it if not FArray.
+template <typename Array=FArray>
+void sweepBoth(size_t setupSize,
+               const function<void (type_identity_t<Array> &)> & op,
+               Guarantee itemGuarantee,
+               Guarantee allocGuarantee = Guarantee::STRONG)
+{
+    faultSweep<Array>(allocCountdown, setupSize, op, allocGuarantee);
+    faultSweep<Array>(itemCountdown, setupSize, op, itemGuarantee);
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Fault injection - ctors & assignment" )
+{
+    const FArray source = makeArray(20);
+
+    SUBCASE( "Ctor from size" )
+    {
+        sweepBoth(5, [](FArray &) { FArray t(40); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "Copy ctor" )
+    {
+        sweepBoth(5, [&](FArray &) { FArray t(source); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "Copy assignment" )
+    {
+        sweepBoth(5, [&](FArray & a) { a = source; },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "Move ctor, move assignment, swap" )
+    {
+        sweepBoth(5, [&](FArray & a) {
+            FArray t(move(a));
+            a = move(t);
+            a.swap(t);
+            a.swap(t);
+        }, Guarantee::STRONG);
+    }
+}
+
+
+TEST_CASE( "Fault injection - resize" )
+{
+    SUBCASE( "resize smaller" )
+    {
+        sweepBoth(10, [](FArray & a) { a.resize(3); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "resize larger, within capacity" )
+    {
+        sweepBoth(10, [](FArray & a) { a.resize(15); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "resize larger, reallocating" )
+    {
+        sweepBoth(10, [](FArray & a) { a.resize(100); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "shrink_to_fit" )
+    {
+        sweepBoth(10, [](FArray & a) { a.shrink_to_fit(); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "reserve" )
+    {
+        sweepBoth(10, [](FArray & a) { a.reserve(100); },
+                  Guarantee::STRONG);
+    }
+}
+
+
+TEST_CASE( "Fault injection - insert, erase, push_back, pop_back" )
+{
+    SUBCASE( "insert at end, reallocating" )
+    {
+        sweepBoth(16, [](FArray & a) { a.insert(a.end(), FaultItem(7)); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "insert at beginning" )
+    {
+        sweepBoth(10, [](FArray & a) { a.insert(a.begin(), FaultItem(7)); },
+                  Guarantee::BASIC);
+    }
+
+    SUBCASE( "insert in middle, reallocating" )
+    {
+        sweepBoth(16, [](FArray & a) {
+            a.insert(a.begin()+8, FaultItem(7));
+        }, Guarantee::BASIC);
+    }
+
+    SUBCASE( "erase at end" )
+    {
+        sweepBoth(10, [](FArray & a) { a.erase(a.end()-1); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "erase at beginning" )
+    {
+        sweepBoth(10, [](FArray & a) { a.erase(a.begin()); },
+                  Guarantee::BASIC);
+    }
+
+    SUBCASE( "push_back, reallocating" )
+    {
+        sweepBoth(16, [](FArray & a) { a.push_back(FaultItem(7)); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "Many push_back calls" )
+    {
+        sweepBoth(0, [](FArray & a) {
+            for (int i = 0; i < 100; ++i)
+                a.push_back(FaultItem(i));
+        }, Guarantee::BASIC, Guarantee::BASIC);
+    }
+
+    SUBCASE( "pop_back" )
+    {
+        sweepBoth(10, [](FArray & a) { a.pop_back(); },
+                  Guarantee::STRONG);
+    }
+}
+
+
+TEST_CASE( "Fault injection - unordered_erase, erase_if" )
+{
+    SUBCASE( "unordered_erase" )
+    {
+        sweepBoth(10, [](FArray & a) { a.unordered_erase(a.begin()+2); },
+                  Guarantee::STRONG);
+    }
+
+    SUBCASE( "erase_if" )
+    {
+        sweepBoth(10, [](FArray & a) {
+            a.erase_if([](const FaultItem & x) { return x.value() % 3 == 0; });
+        }, Guarantee::BASIC);
+    }
+}
+
+
+TEST_CASE( "Fault injection - shrink policy" )
+{
+    // A failed shrink keeps the old buffer; the operation still succeeds
+
+    SUBCASE( "resize smaller, shrinking" )
+    {
+        sweepBoth<SArray>(100, [](SArray & a) { a.resize(10); },
+                          Guarantee::STRONG);
+    }
+
+    SUBCASE( "erase, shrinking" )
+    {
+        sweepBoth<SArray>(100, [](SArray & a) {
+            a.resize(20);
+            a.erase(a.begin());
+        }, Guarantee::BASIC, Guarantee::BASIC);
+    }
+
+    SUBCASE( "Many pop_back calls" )
+    {
+        sweepBoth<SArray>(100, [](SArray & a) {
+            while (a.size() > 0)
+                a.pop_back();
+        }, Guarantee::BASIC, Guarantee::BASIC);
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// Main program
+// Run all tests. Does not wait for ENTER.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n"
+             << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n"
+             << endl;
+    }
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
+
@@ -0,0 +1,478 @@
+// fstarray_fuzz.cpp
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Differential fuzz program for class template FSTArray
+// Applies random sequences of operations to FSTArray and std::vector,
+//  and compares their contents after each step. Covers int & string
+//  items, and the default & a shrinking policy.
+// Usage:
+//     fstarray_fuzz [SEED [OPS]]   Deterministic random run; reports
+//                                  operations per second
+//     fstarray_fuzz -f FILE ...    Run the operations encoded in each
+//                                  FILE (e.g., AFL test cases)
+// Built with FSTARRAY_LIBFUZZER defined, this file instead provides
+//  LLVMFuzzerTestOneInput, for libFuzzer (see CMakeLists.txt).
+// Exits with a message and nonzero status at the first mismatch.
+//  Build with -fsanitize=address,undefined to catch memory errors too
+//  (CMake option FSTARRAY_SANITIZE).
+
+#include "fstarray.h"        // For class template FSTArray
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+#include <fstream>
+using std::ifstream;
+#include <iterator>
+using std::istreambuf_iterator;
+#include <string>
+using std::string;
+using std::to_string;
+#include <vector>
+using std::vector;
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint8_t;
+using std::uint64_t;
+#include <cstdlib>
+using std::abort;
+using std::strtoull;
+#include <cstring>
+using std::strcmp;
+#include <random>
+using std::mt19937_64;
+#include <chrono>
+#include <utility>
+using std::move;
+
+
+// *********************************************************************
+// Operation Sources
+// *********************************************************************
+
+
+// class RandomSource
+// Picks operations & arguments with a seeded PRNG; stops after a given
+//  number of operations.
+class RandomSource {
+
+public:
+
+    RandomSource(uint64_t seed, size_t ops)
+        :_rng(seed),
+         _opsLeft(ops)
+    {}
+
+    // more
+    // Return true if another operation should be done, and count it.
+    bool more()
+    {
+        if (_opsLeft == 0)
+            return false;
+        --_opsLeft;
+        return true;
+    }
+
+    // pick
+    // Return a value in [0, n). Pre: n > 0.
+    size_t pick(size_t n)
+    {
+        return size_t(_rng() % n);
+    }
+
+private:
+
+    mt19937_64 _rng;
+    size_t _opsLeft;
+
+};  // End class RandomSource
+
+
+// class ByteSource
+// Picks operations & arguments from a fuzzer-supplied byte string;
+//  stops when it is used up. Every byte string is a valid input.
+class ByteSource {
+
+public:
+
+    ByteSource(const uint8_t * data, size_t size)
+        :_data(data),
+         _size(size),
+         _pos(0)
+    {}
+
+    bool more() const
+    {
+        return _pos < _size;
+    }
+
+    // pick
+    // Return a value in [0, n), from the next two bytes (zeros past the
+    //  end). Pre: n > 0.
+    size_t pick(size_t n)
+    {
+        size_t v = 0;
+        for (int i = 0; i < 2; ++i)
+        {
+            v = (v << 8) | (_pos < _size ? _data[_pos] : 0);
+            ++_pos;
+        }
+        return v % n;
+    }
+
+private:
+
+    const uint8_t * _data;
+    size_t _size;
+    size_t _pos;
+
+};  // End class ByteSource
+
+
+// *********************************************************************
+// Differential Driver
+// *********************************************************************
+
+
+// makeValue
+// Return a value of type T made from n.
+template <typename T>
+T makeValue(size_t n);
+
+template <>
+int makeValue<int>(size_t n)
+{
+    return int(n);
+}
+
+template <>
+string makeValue<string>(size_t n)
+{
+    // Long enough to defeat the small-string optimization sometimes
+    return to_string(n) + (n % 3 == 0 ? string(20, 'x') : string());
+}
+
+
+// fail
+// Report a mismatch and stop.
+[[noreturn]] void fail(const string & what,
+                       size_t step)
+{
+    cerr << "MISMATCH after step " << step << ": " << what << endl;
+    abort();
+}
+
+
+// check
+// Compare an FSTArray with its reference vector.
+template <typename Array, typename T>
+void check(const Array & a,
+           const vector<T> & v,
+           size_t step)
+{
+    if (a.size() != v.size())
+        fail("size " + to_string(a.size()) + " != " + to_string(v.size()),
+             step);
+    if (a.size() > a.capacity())
+        fail("size > capacity", step);
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        if (!(a[i] == v[i]))
+            fail("item " + to_string(i) + " differs", step);
+    }
+}
+
+
+// runOps
+// Apply operations from src to two FSTArray<T, Policy> objects and two
+//  vectors in parallel; check after each. Return the number of
+//  operations done.
+template <typename T, typename Policy, typename Source>
+size_t runOps(Source & src)
+{
+    using Array = FSTArray<T, Policy>;
+
+    // Cap sizes, so runs stay fast
+    const size_t MAXSIZE = size_t(300);
+
+    Array a;
+    Array b;
+    vector<T> va;
+    vector<T> vb;
+
+    size_t step = 0;
+    while (src.more())
+    {
+        ++step;
+        switch (src.pick(16))
+        {
+        case 0:  // resize; give new items known values
+        {
+            size_t n = src.pick(MAXSIZE);
+            size_t old = a.size();
+            a.resize(n);
+            va.resize(n);
+            for (size_t i = old; i < n; ++i)
+                a[i] = va[i] = makeValue<T>(i);
+            break;
+        }
+        case 1:  // insert new value
+        case 2:  // insert one of our own items
+        {
+            if (a.size() >= MAXSIZE)
+                break;
+            size_t pos = src.pick(a.size()+1);
+            if (a.size() == 0 || src.pick(2) == 0)
+            {
+                T item = makeValue<T>(src.pick(1000));
+                a.insert(a.begin()+pos, item);
+                va.insert(va.begin()+pos, item);
+            }
+            else
+            {
+                size_t from = src.pick(a.size());
+                T item = va[from];
+                a.insert(a.begin()+pos, a[from]);
+                va.insert(va.begin()+pos, item);
+            }
+            break;
+        }
+        case 3:  // erase
+        {
+            if (a.size() == 0)
+                break;
+            size_t pos = src.pick(a.size());
+            a.erase(a.begin()+pos);
+            va.erase(va.begin()+pos);
+            break;
+        }
+        case 4:  // push_back, sometimes one of our own items
+        {
+            if (a.size() >= MAXSIZE)
+                break;
+            if (a.size() > 0 && src.pick(2) == 0)
+            {
+                size_t from = src.pick(a.size());
+                a.push_back(a[from]);
+                va.push_back(T(va[from]));
+            }
+            else
+            {
+                T item = makeValue<T>(src.pick(1000));
+                a.push_back(item);
+                va.push_back(item);
+            }
+            break;
+        }
+        case 5:  // pop_back
+        {
+            if (a.size() == 0)
+                break;
+            a.pop_back();
+            va.pop_back();
+            break;
+        }
+        case 6:  // copy ctor
+        {
+            Array c(a);
+            check(c, va, step);
+            a.swap(c);
+            break;
+        }
+        case 7:  // copy assignment, either direction
+        {
+            if (src.pick(2) == 0)
+            {
+                a = b;
+                va = vb;
+            }
+            else
+            {
+                b = a;
+                vb = va;
+            }
+            break;
+        }
+        case 8:  // move ctor & move assignment
+        {
+            Array c(move(a));
+            vector<T> vc(move(va));
+            a = Array();
+            va.clear();
+            a = move(c);
+            va = move(vc);
+            break;
+        }
+        case 9:  // swap
+        {
+            a.swap(b);
+            va.swap(vb);
+            break;
+        }
+        case 10:  // self-assignment
+        {
+            const Array & self = a;
+            a = self;
+            break;
+        }
+        case 11:  // unordered_erase
+        {
+            if (a.size() == 0)
+                break;
+            size_t pos = src.pick(a.size());
+            a.unordered_erase(a.begin()+pos);
+            va[pos] = va.back();
+            va.pop_back();
+            break;
+        }
+        case 12:  // erase_if
+        {
+            size_t mod = 2 + src.pick(5);
+            size_t k = 0;
+            a.erase_if([&k, mod](const T &) { return k++ % mod == 0; });
+            size_t j = 0;
+            size_t out = 0;
+            for (size_t i = 0; i < va.size(); ++i)
+            {
+                if (j++ % mod != 0)
+                    va[out++] = va[i];
+            }
+            va.resize(out);
+            break;
+        }
+        case 13:  // at, in & out of range
+        {
+            size_t i = src.pick(a.size()+2);
+            bool threw = false;
+            try
+            {
+                if (!(a.at(i) == va.at(i)))
+                    fail("at differs", step);
+            }
+            catch (std::out_of_range &)
+            {
+                threw = true;
+            }
+            if (threw != (i >= va.size()))
+                fail("at range check", step);
+            break;
+        }
+        case 14:  // rebuild from size; size == capacity when size >= 16,
+                  //  so the next insert reallocates
+        {
+            size_t n = src.pick(40);
+            Array c(n);
+            for (size_t i = 0; i < n; ++i)
+                c[i] = makeValue<T>(i);
+            a.swap(c);
+            va.assign(a.begin(), a.end());
+            break;
+        }
+        case 15:  // shrink_to_fit
+        {
+            a.shrink_to_fit();
+            if (a.capacity() < a.size())
+                fail("capacity < size after shrink_to_fit", step);
+            break;
+        }
+        }
+
+        check(a, va, step);
+        check(b, vb, step);
+    }
+    return step;
+}
+
+
+// *********************************************************************
+// Entry Points
+// *********************************************************************
+
+
+// runBytes
+// Run the operations encoded in a byte string: the first byte chooses
+//  item type & shrink policy.
+void runBytes(const uint8_t * data,
+              size_t size)
+{
+    if (size == 0)
+        return;
+    ByteSource src(data+1, size-1);
+    switch (data[0] % 4)
+    {
+    case 0:  runOps<int, FSTNoShrink>(src); break;
+    case 1:  runOps<string, FSTNoShrink>(src); break;
+    case 2:  runOps<int, FSTShrinkQuarter>(src); break;
+    default: runOps<string, FSTShrinkQuarter>(src); break;
+    }
+}
+
+
+#ifdef FSTARRAY_LIBFUZZER
+
+// LLVMFuzzerTestOneInput
+// libFuzzer entry point.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data,
+                                      size_t size)
+{
+    runBytes(data, size);
+    return 0;
+}
+
+#else
+
+// runFile
+// Run the operations encoded in a file, as LLVMFuzzerTestOneInput would.
+void runFile(const char * path)
+{
+    ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        cerr << "Cannot open " << path << endl;
+        std::exit(2);
+    }
+    vector<char> bytes((istreambuf_iterator<char>(in)),
+                       istreambuf_iterator<char>());
+    runBytes(reinterpret_cast<const uint8_t *>(bytes.data()),
+             bytes.size());
+}
+
+
+// Main program
+// Random run (default), or replay files given after -f.
+int main(int argc,
+         char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "-f") == 0)
+    {
+        for (int i = 2; i < argc; ++i)
+            runFile(argv[i]);
+        return 0;
+    }
+
+    uint64_t seed = (argc >= 2) ? strtoull(argv[1], nullptr, 10) : 1;
+    size_t ops = (argc >= 3) ? size_t(strtoull(argv[2], nullptr, 10))
+                             : size_t(1000000);
+
+    auto start = std::chrono::steady_clock::now();
+    RandomSource srcInt(seed, ops);
+    size_t done = runOps<int, FSTNoShrink>(srcInt);
+    RandomSource srcString(seed+1, ops / 4);
+    done += runOps<string, FSTNoShrink>(srcString);
+    RandomSource srcShrink(seed+2, ops / 2);
+    done += runOps<int, FSTShrinkQuarter>(srcShrink);
+    std::chrono::duration<double> d =
+        std::chrono::steady_clock::now() - start;
+
+    cout << "fstarray_fuzz: seed " << seed << ", " << done
+         << " operations OK, " << size_t(double(done) / d.count())
+         << " ops/s" << endl;
+    return 0;
+}
+
+#endif  //#ifdef FSTARRAY_LIBFUZZER
+
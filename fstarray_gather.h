@@ -0,0 +1,371 @@
+// fstarray_gather.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Batched gather & scatter by index lists for FSTArray, with software
+//  prefetch & optional reordering for locality
+
+#ifndef FILE_FSTARRAY_GATHER_H_INCLUDED
+#define FILE_FSTARRAY_GATHER_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include "fstarray_sort.h"
+// For fstRadixSort
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::uint32_t
+// For std::uint64_t
+// For std::int32_t
+#include <algorithm>
+// For std::min
+// For std::max
+#include <limits>
+// For std::numeric_limits
+#include <stdexcept>
+// For std::out_of_range
+#include <type_traits>
+// For std::is_integral_v
+// For std::is_signed_v
+// For std::is_trivially_copyable_v
+#if defined(__AVX2__) && defined(FSTARRAY_AVX2_GATHER)
+#define FSTARRAY_GATHER_USE_AVX2
+#include <immintrin.h>
+// For _mm256_i32gather_epi32 etc.
+#endif
+
+// Gather & scatter (indices: an FSTArray of an integral type):
+//     fstGather(a, indices, out [, options])
+//         out[k] = a[indices[k]], for each k; out is resized.
+//     fstScatter(a, indices, values [, options])
+//         a[indices[k]] = values[k], for each k, in order of k: where
+//         an index repeats, the last value wins.
+// Random indices into an array larger than the cache make each
+//  operator[] a cache miss, one at a time. These issue software
+//  prefetches options.prefetchDistance items ahead, so that many misses
+//  are in flight at once.
+// options.order may also reorder the accesses for locality; results are
+//  the same:
+//     FSTIndexOrder::given     As given.
+//     FSTIndexOrder::bucketed  Grouped by region of the array (a stable
+//                              counting sort on the index's high bits):
+//                              each region is small enough to stay in
+//                              the L2 cache while it is used.
+//     FSTIndexOrder::sorted    In index order (a radix sort of index &
+//                              position); pays off when many indices
+//                              share cache lines.
+//  Reordering costs two passes over the indices & a scratch array.
+// Prefetching is skipped for arrays small enough to stay in cache.
+// If FSTARRAY_AVX2_GATHER is defined, & AVX2 is enabled (-mavx2 or
+//  similar), gathers of 4-byte items in given order by 32-bit indices,
+//  from arrays in cache, use the AVX2 gather instruction. It is off by
+//  default: on CPUs with the gather data sampling mitigation, it is
+//  slower than plain loads; out of cache, it is never faster.
+// Errors: throws std::out_of_range, before changing anything, if an
+//  index is negative or >= a.size(), or if indices & values differ in
+//  size.
+// Guarantees: Strong Guarantee if T copy assignment cannot throw;
+//  otherwise Basic Guarantee. Exception neutral.
+
+
+// *********************************************************************
+// struct FSTGatherOptions
+// *********************************************************************
+
+
+// enum class FSTIndexOrder
+// Order in which fstGather & fstScatter visit the indices.
+enum class FSTIndexOrder {
+    given,
+    bucketed,
+    sorted
+};
+
+
+// struct FSTGatherOptions
+// Settings for fstGather & fstScatter.
+struct FSTGatherOptions {
+    std::size_t   prefetchDistance = 16;  // Items ahead; 0: no prefetch
+    FSTIndexOrder order = FSTIndexOrder::given;
+};
+
+
+// *********************************************************************
+// Implementation details
+// *********************************************************************
+
+
+namespace fst_gather_detail {
+
+    // Bytes of the array in one bucket: about half an L2 cache
+    constexpr std::size_t BUCKET_BYTES = std::size_t(1) << 18;
+    // Arrays of at most this many bytes are not prefetched
+    constexpr std::size_t CACHED_BYTES = std::size_t(1) << 20;
+
+    // prefetch
+    // Hint that *p will be read (forWrite false) or written soon.
+    inline void prefetch(const void * p,
+                         bool forWrite) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        if (forWrite)
+            __builtin_prefetch(p, 1, 0);
+        else
+            __builtin_prefetch(p, 0, 0);
+#else
+        (void)p;
+        (void)forWrite;
+#endif
+    }
+
+    // throwBadIndex
+    [[noreturn]] inline void throwBadIndex()
+    {
+        throw std::out_of_range("FST gather/scatter: index out of range");
+    }
+
+    // checkIndices
+    // Throw std::out_of_range unless every index is in [0, size).
+    template <typename I, typename IPolicy>
+    void checkIndices(const FSTArray<I, IPolicy> & indices,
+                      std::size_t size)
+    {
+        static_assert(std::is_integral_v<I>,
+                      "FST gather/scatter requires integral indices");
+        const std::size_t n = indices.size();
+        if (n == 0)
+            return;
+        // Least & greatest index: reductions the compiler vectorizes
+        const I * idx = &indices[0];
+        I lo = idx[0];
+        I hi = idx[0];
+        for (std::size_t k = 1; k < n; ++k)
+        {
+            lo = std::min(lo, idx[k]);
+            hi = std::max(hi, idx[k]);
+        }
+        if ((std::is_signed_v<I> && lo < 0) || std::size_t(hi) >= size)
+            throwBadIndex();
+    }
+
+    // struct Visit
+    // One access, in visiting order: position in the index list, & the
+    //  index there (so visiting reads the index list in order).
+    struct Visit {
+        std::size_t pos;
+        std::size_t index;
+    };
+
+    // visitOrder
+    // Return the accesses for indices in the order to visit them, for
+    //  an array of size items of itemBytes each (see top of file). Equal
+    //  indices keep their relative order.
+    // Pre:
+    //     Every index is in [0, size).
+    template <typename I, typename IPolicy>
+    FSTArray<Visit> visitOrder(const FSTArray<I, IPolicy> & indices,
+                               std::size_t size,
+                               std::size_t itemBytes,
+                               FSTIndexOrder order)
+    {
+        const std::size_t n = indices.size();
+        const I * idx = &indices[0];
+        FSTArray<Visit> visits(n);
+
+        if (order == FSTIndexOrder::sorted
+            && size <= std::numeric_limits<std::uint32_t>::max()
+            && n <= std::numeric_limits<std::uint32_t>::max())
+        {
+            // Key: index in the high half, position in the low half
+            FSTArray<std::uint64_t> keys(n);
+            for (std::size_t k = 0; k < n; ++k)
+                keys[k] = (std::uint64_t(idx[k]) << 32) | k;
+            fstRadixSort(keys);
+            for (std::size_t k = 0; k < n; ++k)
+                visits[k] = Visit{ std::size_t(keys[k] & 0xFFFFFFFFu),
+                                   std::size_t(keys[k] >> 32) };
+            return visits;
+        }
+
+        // Bucketed (also sorted, for huge arrays): stable counting sort
+        //  by index / perBucket
+        std::size_t perBucket = std::max(BUCKET_BYTES / itemBytes,
+                                         std::size_t(1));
+        std::size_t buckets = (size + perBucket - 1) / perBucket;
+        FSTArray<std::size_t> start(buckets + 1);
+        for (std::size_t b = 0; b <= buckets; ++b)
+            start[b] = 0;
+        for (std::size_t k = 0; k < n; ++k)
+            ++start[std::size_t(idx[k]) / perBucket + 1];
+        for (std::size_t b = 0; b < buckets; ++b)
+            start[b+1] += start[b];
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            std::size_t i = std::size_t(idx[k]);
+            visits[start[i / perBucket]++] = Visit{ k, i };
+        }
+        return visits;
+    }
+
+#ifdef FSTARRAY_GATHER_USE_AVX2
+    // gatherAvx2
+    // dest[k] = base[idx[k]] for k in [0, n), 8 at a time with the AVX2
+    //  gather instruction.
+    inline void gatherAvx2(const int * base,
+                           const std::int32_t * idx,
+                           int * dest,
+                           std::size_t n) noexcept
+    {
+        std::size_t blocks = n / 8;
+        for (std::size_t b = 0; b < blocks; ++b)
+        {
+            __m256i vi = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(idx + 8*b));
+            __m256i v = _mm256_i32gather_epi32(base, vi, 4);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + 8*b), v);
+        }
+        for (std::size_t k = 8*blocks; k < n; ++k)
+            dest[k] = base[idx[k]];
+    }
+#endif
+
+}  // End namespace fst_gather_detail
+
+
+// *********************************************************************
+// Gather & scatter
+// *********************************************************************
+
+
+// fstGather
+// Set out to a[indices[k]] for each k (see top of file). out's buffer is
+//  reused if it is large enough.
+// Requirements on Types:
+//     T is copy-assignable; I is integral.
+// Strong Guarantee if T copy assignment cannot throw; otherwise Basic
+//  Guarantee.
+// Exception neutral
+template <typename T, typename Policy, typename I, typename IPolicy,
+          typename OutPolicy>
+void fstGather(const FSTArray<T, Policy> & a,
+               const FSTArray<I, IPolicy> & indices,
+               FSTArray<T, OutPolicy> & out,
+               FSTGatherOptions options=FSTGatherOptions())
+{
+    using namespace fst_gather_detail;
+    const std::size_t size = a.size();
+    checkIndices(indices, size);
+    if (static_cast<const void *>(&out) == static_cast<const void *>(&a))
+    {
+        // Gathering from out into itself: go through a copy
+        FSTArray<T, OutPolicy> result(0);
+        fstGather(a, indices, result, options);
+        out.swap(result);
+        return;
+    }
+    const std::size_t n = indices.size();
+    if (n == 0)
+    {
+        out.resize(0);
+        return;
+    }
+    FSTArray<Visit> visits(0);  // Before out changes: may throw
+    if (options.order != FSTIndexOrder::given)
+        visits = visitOrder(indices, size, sizeof(T), options.order);
+    out.resize(n);
+    const T * src = &a[0];
+    const I * idx = &indices[0];
+    T * dest = &out[0];
+    const std::size_t dist = size * sizeof(T) <= CACHED_BYTES
+                           ? 0 : options.prefetchDistance;
+
+    if (options.order == FSTIndexOrder::given)
+    {
+#ifdef FSTARRAY_GATHER_USE_AVX2
+        if constexpr (sizeof(T) == 4 && std::is_trivially_copyable_v<T>
+                      && sizeof(I) == 4)
+        {
+            if (size * sizeof(T) <= CACHED_BYTES)
+            {
+                gatherAvx2(reinterpret_cast<const int *>(src),
+                           reinterpret_cast<const std::int32_t *>(idx),
+                           reinterpret_cast<int *>(dest), n);
+                return;
+            }
+        }
+#endif
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            if (dist != 0 && k + dist < n)
+                prefetch(src + std::size_t(idx[k + dist]), false);
+            dest[k] = src[std::size_t(idx[k])];
+        }
+        return;
+    }
+
+    const Visit * v = &visits[0];
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        if (dist != 0 && j + dist < n)
+            prefetch(src + v[j + dist].index, false);
+        dest[v[j].pos] = src[v[j].index];
+    }
+}
+
+
+// fstScatter
+// Set a[indices[k]] = values[k] for each k, in order (see top of file).
+// Requirements on Types:
+//     T is copy-assignable, with no-throw copy assignment; I is
+//      integral.
+// Strong Guarantee
+// Exception neutral
+template <typename T, typename Policy, typename I, typename IPolicy,
+          typename VPolicy>
+void fstScatter(FSTArray<T, Policy> & a,
+                const FSTArray<I, IPolicy> & indices,
+                const FSTArray<T, VPolicy> & values,
+                FSTGatherOptions options=FSTGatherOptions())
+{
+    using namespace fst_gather_detail;
+    if (indices.size() != values.size())
+        throw std::out_of_range("FST scatter: indices & values differ "
+                                "in size");
+    checkIndices(indices, a.size());
+    const std::size_t n = indices.size();
+    if (n == 0)
+        return;
+    T * dest = &a[0];
+    const I * idx = &indices[0];
+    const T * src = &values[0];
+    const std::size_t dist = a.size() * sizeof(T) <= CACHED_BYTES
+                           ? 0 : options.prefetchDistance;
+
+    if (options.order == FSTIndexOrder::given)
+    {
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            if (dist != 0 && k + dist < n)
+                prefetch(dest + std::size_t(idx[k + dist]), true);
+            dest[std::size_t(idx[k])] = src[k];
+        }
+        return;
+    }
+
+    // Stable order: repeated indices are still written in order of k
+    FSTArray<Visit> visits = visitOrder(indices, a.size(), sizeof(T),
+                                        options.order);
+    const Visit * v = &visits[0];
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        if (dist != 0 && j + dist < n)
+            prefetch(dest + v[j + dist].index, true);
+        dest[v[j].index] = src[v[j].pos];
+    }
+}
+
+
+#endif  //#ifndef FILE_FSTARRAY_GATHER_H_INCLUDED
+
@@ -0,0 +1,208 @@
+// fstarray_hardened_test.cpp
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Test program for the hardening mode of class template FSTArray
+// Built with FSTARRAY_HARDENED (defined below, as well as by the build);
+//  checks that each precondition check throws: bad indices, stale
+//  iterators, and iterators from another array.
+// Does not wait for ENTER, so it can run unattended (ctest).
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, fstarray.h
+
+#ifndef FSTARRAY_HARDENED
+#define FSTARRAY_HARDENED
+#endif
+
+// Includes for code to be tested
+#include "fstarray.h"        // For class template FSTArray
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <stdexcept>
+using std::out_of_range;
+using std::logic_error;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template FSTArray - hardening mode";
+
+
+// *********************************************************************
+// Helper Functions
+// *********************************************************************
+
+
+// throwsAs
+// Return true if f() throws an Exception, false if it returns normally.
+//  Other exceptions propagate.
+template <typename Exception, typename Func>
+bool throwsAs(Func f)
+{
+    try
+    {
+        f();
+    }
+    catch (Exception &)
+    {
+        return true;
+    }
+    return false;
+}
+
+
+// makeArray
+// Return array of size n holding 0, 1, ..., n-1.
+FSTArray<int> makeArray(size_t n)
+{
+    FSTArray<int> a(n);
+    for (size_t i = 0; i < n; ++i)
+        a[i] = int(i);
+    return a;
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Hardened - operator[] index check" )
+{
+    FSTArray<int> a = makeArray(10);
+    const FSTArray<int> & ca = a;
+    {
+    INFO( "In-range indices do not throw" );
+    REQUIRE( a[0] == 0 );
+    REQUIRE( ca[9] == 9 );
+    }
+    {
+    INFO( "operator[] out of range throws std::out_of_range" );
+    REQUIRE( throwsAs<out_of_range>([&]() { (void)a[10]; }) );
+    REQUIRE( throwsAs<out_of_range>([&]() { (void)ca[10]; }) );
+    REQUIRE( throwsAs<out_of_range>([&]() { (void)a[size_t(-1)]; }) );
+    REQUIRE( throwsAs<out_of_range>([&]() {
+        FSTArray<int> empty(0);
+        (void)empty[0]; }) );
+    }
+    {
+    INFO( "at out of range throws std::out_of_range" );
+    REQUIRE( throwsAs<out_of_range>([&]() { (void)a.at(10); }) );
+    }
+}
+
+
+TEST_CASE( "Hardened - stale iterators" )
+{
+    FSTArray<int> a = makeArray(10);
+
+    auto it = a.begin() + 3;
+    REQUIRE( *it == 3 );
+    a.push_back(10);
+    {
+    INFO( "Dereferencing an iterator from before push_back throws" );
+    REQUIRE( throwsAs<logic_error>([&]() { (void)*it; }) );
+    }
+    {
+    INFO( "Passing it to insert & erase throws; array unchanged" );
+    REQUIRE( throwsAs<logic_error>([&]() { a.insert(it, 99); }) );
+    REQUIRE( throwsAs<logic_error>([&]() { a.erase(it); }) );
+    REQUIRE( a.size() == 11 );
+    REQUIRE( a[3] == 3 );
+    }
+
+    auto it2 = a.begin();
+    a.resize(5);
+    {
+    INFO( "Iterator from before resize throws" );
+    REQUIRE( throwsAs<logic_error>([&]() { (void)*it2; }) );
+    REQUIRE( throwsAs<logic_error>([&]() { a.erase(it2); }) );
+    }
+    auto it3 = a.begin();
+    a.resize(1000);  // Reallocates
+    {
+    INFO( "Iterator from before reallocating resize throws" );
+    REQUIRE( throwsAs<logic_error>([&]() { (void)*it3; }) );
+    }
+
+    auto fresh = a.begin();
+    {
+    INFO( "Fresh iterator is valid; erase(end()) is out of range" );
+    REQUIRE( *fresh == 0 );
+    REQUIRE( throwsAs<out_of_range>([&]() { a.erase(a.end()); }) );
+    }
+}
+
+
+TEST_CASE( "Hardened - iterators from another array" )
+{
+    FSTArray<int> a = makeArray(10);
+    FSTArray<int> b = makeArray(10);
+    {
+    INFO( "insert with an iterator into another array throws" );
+    REQUIRE( throwsAs<logic_error>([&]() { b.insert(a.begin(), 99); }) );
+    REQUIRE( throwsAs<logic_error>([&]() { b.insert(a.end(), 99); }) );
+    }
+    {
+    INFO( "erase with an iterator into another array throws" );
+    REQUIRE( throwsAs<logic_error>([&]() { b.erase(a.begin() + 2); }) );
+    }
+    {
+    INFO( "Neither array changed" );
+    REQUIRE( a.size() == 10 );
+    REQUIRE( b.size() == 10 );
+    REQUIRE( a[2] == 2 );
+    REQUIRE( b[2] == 2 );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// Main program
+// Run all tests. Does not wait for ENTER.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n"
+             << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n"
+             << endl;
+    }
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
+
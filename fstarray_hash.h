@@ -0,0 +1,296 @@
+// fstarray_hash.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Fast hashing of FSTArray contents, & std::hash for FSTArray
+
+#ifndef FILE_FSTARRAY_HASH_H_INCLUDED
+#define FILE_FSTARRAY_HASH_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+// For fst_array_detail::BYTEWISE_EQUAL
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::uint64_t
+#include <cstring>
+// For std::memcpy
+#include <functional>
+// For std::hash
+
+// Hashing:
+//     fstHashBytes(data, n [, seed])
+//         64-bit hash of n bytes at data.
+//     fstHash(a [, seed])
+//         Hash of FSTArray a, consistent with a == b: equal arrays
+//         hash alike.
+//     std::hash<FSTArray<T, P>>
+//         fstHash(a), so FSTArrays may be keys of unordered containers.
+// fstHashBytes follows the design of XXH3: eight 64-bit lanes, each
+//  taking one 8-byte word of every 64-byte stripe with a 32x32->64-bit
+//  multiply, so the loop vectorizes (SSE2/AVX2); after each 1 KB block
+//  the lanes are scrambled. Inputs under 64 bytes take a short path.
+//  It is not XXH3 (different keys & tails) & its values are not
+//  stable: they may differ between platforms & versions, so do not
+//  store them.
+// fstHash hashes the bytes of arrays whose items compare bytewise
+//  (integers, enums, pointers; see fst_array_detail::BYTEWISE_EQUAL);
+//  otherwise, it combines std::hash of each item.
+// Hashes are not cached: FSTArray hands out references to its items, so
+//  it cannot know when they change.
+
+
+// *********************************************************************
+// Implementation details
+// *********************************************************************
+
+
+namespace fst_hash_detail {
+
+    constexpr std::uint64_t PRIME32_1 = 0x9E3779B1U;
+    constexpr std::uint64_t PRIME32_2 = 0x85EBCA77U;
+    constexpr std::uint64_t PRIME32_3 = 0xC2B2AE3DU;
+    constexpr std::uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    constexpr std::uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr std::uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    constexpr std::uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr std::uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    constexpr std::size_t LANES = 8;                // 8-byte words/stripe
+    constexpr std::size_t STRIPE = 8 * LANES;       // Bytes per stripe
+    constexpr std::size_t BLOCK_STRIPES = 16;       // Stripes per block
+    constexpr std::size_t KEYS = BLOCK_STRIPES + LANES;
+
+    // splitMix
+    // Return x-th output of the SplitMix64 generator (for keys).
+    constexpr std::uint64_t splitMix(std::uint64_t x) noexcept
+    {
+        std::uint64_t z = (x + 1) * PRIME64_1;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // struct Keys
+    // Key words: stripe s of a block uses keys s..s+7, one per lane (a
+    //  sliding window, as XXH3 slides along its secret), so reordering
+    //  stripes changes the hash; the last stripe uses 16..23.
+    struct Keys {
+        std::uint64_t k[KEYS];
+
+        constexpr Keys() noexcept
+            :k()
+        {
+            for (std::size_t i = 0; i < KEYS; ++i)
+                k[i] = splitMix(i);
+        }
+    };
+
+    inline constexpr Keys KEY{};
+
+    // load64
+    // Return 8 bytes at p, as a native-endian word.
+    inline std::uint64_t load64(const unsigned char * p) noexcept
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, sizeof w);
+        return w;
+    }
+
+    // mulFold
+    // Return xor of the halves of the 128-bit product a*b.
+    inline std::uint64_t mulFold(std::uint64_t a,
+                                 std::uint64_t b) noexcept
+    {
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+        return std::uint64_t(p) ^ std::uint64_t(p >> 64);
+#else
+        std::uint64_t aLo = a & 0xFFFFFFFFU;
+        std::uint64_t aHi = a >> 32;
+        std::uint64_t bLo = b & 0xFFFFFFFFU;
+        std::uint64_t bHi = b >> 32;
+        std::uint64_t lolo = aLo * bLo;
+        std::uint64_t hilo = aHi * bLo;
+        std::uint64_t lohi = aLo * bHi;
+        std::uint64_t hihi = aHi * bHi;
+        std::uint64_t cross = (lolo >> 32) + (hilo & 0xFFFFFFFFU) + lohi;
+        std::uint64_t hi = (hilo >> 32) + (cross >> 32) + hihi;
+        std::uint64_t lo = (cross << 32) | (lolo & 0xFFFFFFFFU);
+        return lo ^ hi;
+#endif
+    }
+
+    // avalanche
+    // Return x with every bit depending on every bit.
+    inline std::uint64_t avalanche(std::uint64_t x) noexcept
+    {
+        x ^= x >> 37;
+        x *= 0x165667919E3779F9ULL;
+        return x ^ (x >> 32);
+    }
+
+    // accumulate
+    // Add one stripe at p to the lanes, with keys key[0..7].
+    inline void accumulate(std::uint64_t * acc,
+                           const unsigned char * p,
+                           const std::uint64_t * key) noexcept
+    {
+        for (std::size_t j = 0; j < LANES; ++j)
+        {
+            std::uint64_t w = load64(p + 8*j);
+            std::uint64_t k = w ^ key[j];
+            acc[j ^ 1] += w;
+            acc[j] += (k & 0xFFFFFFFFU) * (k >> 32);
+        }
+    }
+
+    // scramble
+    // Mix each lane, between blocks.
+    inline void scramble(std::uint64_t * acc) noexcept
+    {
+        for (std::size_t j = 0; j < LANES; ++j)
+        {
+            std::uint64_t a = acc[j];
+            a ^= a >> 47;
+            a ^= KEY.k[BLOCK_STRIPES + j];
+            acc[j] = a * PRIME32_1;
+        }
+    }
+
+    // hashShort
+    // Hash of n < STRIPE bytes: one multiply-fold per 8-byte word.
+    inline std::uint64_t hashShort(const unsigned char * p,
+                                   std::size_t n,
+                                   std::uint64_t seed) noexcept
+    {
+        std::uint64_t h = seed ^ (n * PRIME64_1);
+        std::size_t i = 0;
+        std::size_t k = 0;
+        for (; i + 8 <= n; i += 8, ++k)
+            h = mulFold(load64(p + i) ^ KEY.k[k], h ^ KEY.k[k + LANES]);
+        if (i < n)
+        {
+            std::uint64_t w = 0;
+            std::memcpy(&w, p + i, n - i);
+            h = mulFold(w ^ KEY.k[k], h ^ KEY.k[k + LANES]);
+        }
+        return avalanche(h ^ (h >> 29) ^ PRIME64_4);
+    }
+
+    // hashLong
+    // Hash of n >= STRIPE bytes: stripes into lanes (see top of file).
+    //  The last stripe is the last 64 bytes, overlapping the one before
+    //  it if n is not a multiple of 64.
+    inline std::uint64_t hashLong(const unsigned char * p,
+                                  std::size_t n,
+                                  std::uint64_t seed) noexcept
+    {
+        std::uint64_t acc[LANES] = {
+            PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+            PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1 };
+        for (std::size_t j = 0; j < LANES; ++j)
+            acc[j] ^= seed;
+
+        std::size_t stripes = (n - 1) / STRIPE;
+        std::size_t s = 0;
+        for (; s + BLOCK_STRIPES <= stripes; s += BLOCK_STRIPES)
+        {
+            for (std::size_t t = 0; t < BLOCK_STRIPES; ++t)
+                accumulate(acc, p + (s + t) * STRIPE, KEY.k + t);
+            scramble(acc);
+        }
+        for (std::size_t t = 0; s + t < stripes; ++t)
+            accumulate(acc, p + (s + t) * STRIPE, KEY.k + t);
+        accumulate(acc, p + n - STRIPE, KEY.k + BLOCK_STRIPES);
+
+        std::uint64_t h = seed ^ (n * PRIME64_1);
+        for (std::size_t j = 0; j < LANES; j += 2)
+            h += mulFold(acc[j] ^ KEY.k[j + 1], acc[j+1] ^ KEY.k[j + 2]);
+        return avalanche(h);
+    }
+
+    // combine
+    // Return hash h updated with x, for hashing item by item.
+    inline std::uint64_t combine(std::uint64_t h,
+                                 std::uint64_t x) noexcept
+    {
+        return mulFold(h ^ x, PRIME64_2) + PRIME64_3;
+    }
+
+}  // End namespace fst_hash_detail
+
+
+// *********************************************************************
+// Hash functions
+// *********************************************************************
+
+
+// fstHashBytes
+// Return 64-bit hash of the n bytes at data (see top of file).
+// Pre:
+//     [data, data+n) is readable, or n == 0.
+// No-Throw Guarantee
+inline std::uint64_t fstHashBytes(const void * data,
+                                  std::size_t n,
+                                  std::uint64_t seed=0) noexcept
+{
+    const unsigned char * p = static_cast<const unsigned char *>(data);
+    if (n < fst_hash_detail::STRIPE)
+        return fst_hash_detail::hashShort(p, n, seed);
+    return fst_hash_detail::hashLong(p, n, seed);
+}
+
+
+// fstHash
+// Return hash of a's items, consistent with operator== (see top of
+//  file).
+// Requirements on Types:
+//     T compares bytewise, or std::hash<T> exists.
+// No-Throw Guarantee if T compares bytewise or std::hash<T> cannot
+//  throw
+// Exception neutral
+template <typename T, typename P>
+std::uint64_t fstHash(const FSTArray<T, P> & a,
+                      std::uint64_t seed=0)
+{
+    std::size_t n = a.size();
+    if constexpr (fst_array_detail::BYTEWISE_EQUAL<T>)
+    {
+        return fstHashBytes(n == 0 ? nullptr : &a[0], n * sizeof(T), seed);
+    }
+    else
+    {
+        std::hash<T> itemHash;
+        std::uint64_t h = seed ^ (n * fst_hash_detail::PRIME64_1);
+        for (std::size_t i = 0; i < n; ++i)
+            h = fst_hash_detail::combine(h, std::uint64_t(itemHash(a[i])));
+        return fst_hash_detail::avalanche(h);
+    }
+}
+
+
+// *********************************************************************
+// std::hash specialization
+// *********************************************************************
+
+
+// std::hash<FSTArray>
+// fstHash, as a std::size_t.
+namespace std {
+
+    template <typename T, typename P>
+    struct hash<FSTArray<T, P>> {
+        std::size_t operator()(const FSTArray<T, P> & a) const
+        {
+            return std::size_t(fstHash(a));
+        }
+    };
+
+}  // End namespace std
+
+
+#endif  //#ifndef FILE_FSTARRAY_HASH_H_INCLUDED
+
@@ -0,0 +1,566 @@
+// fstarray_io.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Fast loading of FSTArray from files & pipes: text integers and raw
+//  binary items, read in large blocks straight into array storage
+
+#ifndef FILE_FSTARRAY_IO_H_INCLUDED
+#define FILE_FSTARRAY_IO_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::uint64_t
+#include <cstring>
+// For std::memcpy
+// For std::memmove
+#include <cstdio>
+// For std::FILE etc. (non-POSIX systems)
+#include <algorithm>
+// For std::max
+// For std::min
+#include <bit>
+// For std::countr_zero
+#include <limits>
+// For std::numeric_limits
+#include <stdexcept>
+// For std::runtime_error
+#include <string>
+// For std::string
+#include <type_traits>
+// For std::is_integral_v
+// For std::is_signed_v
+// For std::is_trivially_copyable_v
+#if __has_include(<unistd.h>) && __has_include(<fcntl.h>)
+#define FSTARRAY_IO_POSIX
+#include <unistd.h>
+// For read
+// For close
+#include <fcntl.h>
+// For open
+// For posix_fadvise
+#include <sys/stat.h>
+// For fstat
+#include <cerrno>
+// For errno, EINTR
+#endif
+
+// Loading entry points (each appends to the array):
+//     fstReadInts(a, path)     Text: integers separated by whitespace or
+//     fstReadInts(a, fd)        commas, optionally signed.
+//     fstReadBinary(a, path)   Binary: raw items, native byte order, as
+//     fstReadBinary(a, fd)      written from an array's storage.
+// Reads are large blocks (BLOCK bytes) from read(2) on POSIX systems, or
+//  fread elsewhere. Items go straight into the array's storage: no
+//  per-item push_back. For regular files, the file size (fstat) sets
+//  the array's capacity once: exactly, for binary files; for text, from
+//  the bytes per number in the first block. Pipes & other unsized input
+//  grow the array by doubling.
+// Text parsing handles 8 digits at a time in a 64-bit word (SWAR: SIMD
+//  within a register): one test finds the run of digits, and three
+//  multiplies convert it.
+// Errors: std::runtime_error if the file cannot be opened or read, or
+//  the input is malformed (a bad character, a number out of range for
+//  the item type, a partial binary item). On error, the array keeps its
+//  old items (its capacity may have grown).
+// Load into FSTNoShrink arrays: with a shrink policy, the mostly empty
+//  capacity reserved early on may be given back & taken again.
+
+
+// *********************************************************************
+// Implementation details
+// *********************************************************************
+
+
+namespace fst_io_detail {
+
+    // Bytes per read
+    constexpr std::size_t BLOCK = std::size_t(1) << 20;
+    // Bytes of padding after the data in the read buffer, so that 8-byte
+    //  loads near the end stay inside it
+    constexpr std::size_t PAD = 16;
+
+    // class Input
+    // File descriptor (POSIX) or FILE * to read from. Closes it on
+    //  destruction if it opened it.
+    class Input {
+    public:
+
+        // Open path for reading.
+        // Throws std::runtime_error on failure.
+        explicit Input(const char * path)
+            :_owned(true)
+        {
+#ifdef FSTARRAY_IO_POSIX
+            _fd = ::open(path, O_RDONLY);
+            if (_fd < 0)
+                throw std::runtime_error(std::string("FST read: cannot open ")
+                                         + path);
+#else
+            _file = std::fopen(path, "rb");
+            if (_file == nullptr)
+                throw std::runtime_error(std::string("FST read: cannot open ")
+                                         + path);
+#endif
+        }
+
+#ifdef FSTARRAY_IO_POSIX
+        // Read from open descriptor fd; do not close it.
+        explicit Input(int fd) noexcept
+            :_owned(false),
+             _fd(fd)
+        {}
+#endif
+
+        Input(const Input &) = delete;
+        Input & operator=(const Input &) = delete;
+
+        ~Input()
+        {
+            if (!_owned)
+                return;
+#ifdef FSTARRAY_IO_POSIX
+            ::close(_fd);
+#else
+            std::fclose(_file);
+#endif
+        }
+
+        // sizeHint
+        // Return bytes left to read for a regular file, or 0 if unknown.
+        //  For a regular file, also advise the system of sequential
+        //  reading.
+        std::size_t sizeHint() const noexcept
+        {
+#ifdef FSTARRAY_IO_POSIX
+            struct stat st;
+            if (::fstat(_fd, &st) != 0 || !S_ISREG(st.st_mode))
+                return 0;
+            off_t pos = ::lseek(_fd, 0, SEEK_CUR);
+            if (pos < 0 || pos > st.st_size)
+                return 0;
+#if defined(POSIX_FADV_SEQUENTIAL)
+            ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            return std::size_t(st.st_size - pos);
+#else
+            return 0;
+#endif
+        }
+
+        // read
+        // Read up to n bytes to buf; return the number read, 0 at end of
+        //  input. Throws std::runtime_error on a read error.
+        std::size_t read(char * buf,
+                         std::size_t n)
+        {
+#ifdef FSTARRAY_IO_POSIX
+            for (;;)
+            {
+                ssize_t got = ::read(_fd, buf, n);
+                if (got >= 0)
+                    return std::size_t(got);
+                if (errno != EINTR)
+                    throw std::runtime_error("FST read: read error");
+            }
+#else
+            std::size_t got = std::fread(buf, 1, n, _file);
+            if (got == 0 && std::ferror(_file))
+                throw std::runtime_error("FST read: read error");
+            return got;
+#endif
+        }
+
+        // readFull
+        // Like read, but keeps reading until n bytes or end of input.
+        std::size_t readFull(char * buf,
+                             std::size_t n)
+        {
+            std::size_t total = 0;
+            while (total < n)
+            {
+                std::size_t got = read(buf + total, n - total);
+                if (got == 0)
+                    break;
+                total += got;
+            }
+            return total;
+        }
+
+    private:
+
+        bool        _owned;  // Close on destruction?
+#ifdef FSTARRAY_IO_POSIX
+        int         _fd;
+#else
+        std::FILE * _file;
+#endif
+
+    };  // End class Input
+
+    // load8
+    // Return the 8 bytes at p as a little-endian word.
+    inline std::uint64_t load8(const char * p) noexcept
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        if constexpr (std::endian::native == std::endian::big)
+            w = __builtin_bswap64(w);
+        return w;
+    }
+
+    // digitRun
+    // Return the number of leading ASCII digits (0 .. 8) in word w (as
+    //  from load8). Bytes 0x80 and up count as non-digits.
+    inline unsigned digitRun(std::uint64_t w) noexcept
+    {
+        constexpr std::uint64_t ONES = 0x0101010101010101ULL;
+        constexpr std::uint64_t HIGH = 0x8080808080808080ULL;
+        // Byte is a digit iff its high nibble is 3 and the high nibble
+        //  of byte+6 is 3 (no carries: high bits are masked off first)
+        std::uint64_t low7 = w & ~HIGH;
+        std::uint64_t bad = ((w & (0xF0 * ONES)) ^ (0x30 * ONES))
+                          | (((low7 + 0x06 * ONES) & (0xF0 * ONES))
+                             ^ (0x30 * ONES))
+                          | (w & HIGH);
+        // High bit of each non-zero byte of bad
+        std::uint64_t nonDigit = (((bad & ~HIGH) + ~HIGH) | bad) & HIGH;
+        return nonDigit == 0 ? 8u : unsigned(std::countr_zero(nonDigit)) / 8;
+    }
+
+    // parse8
+    // Return the value of the 8 ASCII digits in word w (as from load8;
+    //  first digit in the low byte).
+    inline std::uint64_t parse8(std::uint64_t w) noexcept
+    {
+        w -= 0x3030303030303030ULL;
+        w = (w * 10) + (w >> 8);  // Pairs of digits
+        w = (((w & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+           + (((w >> 16) & 0x000000FF000000FFULL)
+              * (1 + (10000ULL << 32)))) >> 32;
+        return w;
+    }
+
+    // parseDigits
+    // Parse the run of digits at p, which the buffer's padding ends;
+    //  store its value in value, and return the end of the run. Returns
+    //  nullptr if the value needs more than 64 bits.
+    inline const char * parseDigits(const char * p,
+                                    std::uint64_t & value) noexcept
+    {
+        std::uint64_t v = 0;
+        unsigned digits = 0;
+        for (;;)
+        {
+            std::uint64_t w = load8(p);
+            unsigned run = digitRun(w);
+            if (run == 8)
+            {
+                if (digits + 8 > 19)
+                    break;  // Could overflow; finish one at a time
+                v = v * 100000000ULL + parse8(w);
+                digits += 8;
+                p += 8;
+                continue;
+            }
+            if (run != 0)
+            {
+                if (digits + run > 19)
+                    break;
+                // Shift the digits to the top; fill below with '0's
+                static constexpr std::uint64_t POW10[8] = {
+                    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+                unsigned shift = 8 * (8 - run);
+                w = (w << shift) | (0x3030303030303030ULL >> (64 - shift));
+                v = v * POW10[run] + parse8(w);
+                p += run;
+            }
+            value = v;
+            return p;
+        }
+        // Slow path: up to 20 digits, checked
+        while (unsigned(*p - '0') < 10)
+        {
+            std::uint64_t d = std::uint64_t(*p - '0');
+            if (v > (std::numeric_limits<std::uint64_t>::max() - d) / 10)
+                return nullptr;
+            v = v * 10 + d;
+            ++p;
+        }
+        value = v;
+        return p;
+    }
+
+    // isSeparator
+    // Return whether c is white space or a comma: one test of a bit mask,
+    //  rather than a chain of branches.
+    inline bool isSeparator(char c) noexcept
+    {
+        constexpr std::uint64_t SEPARATORS =
+            (1ULL << ' ') | (1ULL << ',') | (1ULL << '\t') | (1ULL << '\n')
+          | (1ULL << '\v') | (1ULL << '\f') | (1ULL << '\r');
+        unsigned u = static_cast<unsigned char>(c);
+        return u < 64 && ((SEPARATORS >> u) & 1) != 0;
+    }
+
+    // parseBlock
+    // Parse integers from [p, end) into out; return the number stored.
+    //  Stops before a number that reaches end (unless last, when end of
+    //  input is end of number), leaving rest pointing at it. *end and
+    //  the PAD bytes after it must be 0.
+    // Throws std::runtime_error on bad input.
+    template <typename T>
+    std::size_t parseBlock(const char * p,
+                           const char * end,
+                           bool last,
+                           T * out,
+                           const char * & rest)
+    {
+        using Lim = std::numeric_limits<T>;
+        std::size_t count = 0;
+        for (;;)
+        {
+            while (p < end && isSeparator(*p))
+                ++p;
+            const char * start = p;
+            if (p == end)
+                break;
+            bool negative = false;
+            if (*p == '-' || *p == '+')
+            {
+                negative = (*p == '-');
+                ++p;
+            }
+            std::uint64_t mag = 0;
+            const char * q = parseDigits(p, mag);
+            if (q == nullptr || (q == p && q != end))
+                throw std::runtime_error(q == nullptr
+                    ? "FST read: number out of range"
+                    : "FST read: bad character in input");
+            if (q == end && !last)
+            {
+                p = start;  // May continue in the next block
+                break;
+            }
+            if (q == p || (q < end && !isSeparator(*q)))
+                throw std::runtime_error("FST read: bad character in input");
+            p = q;
+
+            if constexpr (Lim::is_signed)
+            {
+                std::uint64_t limit = negative
+                    ? std::uint64_t(Lim::max()) + 1
+                    : std::uint64_t(Lim::max());
+                if (mag > limit)
+                    throw std::runtime_error("FST read: number out of range");
+                out[count++] = negative
+                             ? T(std::int64_t(std::uint64_t(0) - mag))
+                             : T(mag);
+            }
+            else
+            {
+                if ((negative && mag != 0) || mag > Lim::max())
+                    throw std::runtime_error("FST read: number out of range");
+                out[count++] = T(mag);
+            }
+        }
+        rest = p;
+        return count;
+    }
+
+    // makeRoom
+    // Make a's capacity greater than needed: by doubling, so that input
+    //  of unknown size costs amortized O(1) per item.
+    // Strong Guarantee
+    template <typename T, typename Policy>
+    void makeRoom(FSTArray<T, Policy> & a,
+                  std::size_t needed)
+    {
+        if (needed >= a.capacity())
+            a.reserve(std::max(needed + 1, 2 * a.capacity()));
+    }
+
+    // readInts
+    // Body of fstReadInts.
+    template <typename T, typename Policy>
+    std::size_t readInts(FSTArray<T, Policy> & a,
+                         Input & in)
+    {
+        static_assert(std::is_integral_v<T>,
+                      "fstReadInts requires an integral item type");
+        std::size_t oldSize = a.size();
+        std::size_t hint = in.sizeHint();
+        FSTArray<char> buf(BLOCK + PAD);
+        std::size_t kept = 0;   // Bytes carried over at start of buf
+        bool reserved = false;
+        try
+        {
+            for (;;)
+            {
+                std::size_t got = in.readFull(&buf[kept], BLOCK - kept);
+                std::size_t len = kept + got;
+                bool last = (got == 0 || len < BLOCK);
+                std::memset(&buf[len], 0, PAD);
+
+                // Room for the most numbers this block can hold
+                std::size_t maxItems = len / 2 + 1;
+                std::size_t n = a.size();
+                makeRoom(a, n + maxItems);
+                a.resize(n + maxItems);
+                const char * rest = nullptr;
+                std::size_t count = parseBlock(&buf[0], &buf[0] + len, last,
+                                               &a[n], rest);
+                a.resize(n + count);
+
+                // After the first block, size the array for the file
+                if (!reserved && hint != 0 && count != 0)
+                {
+                    std::size_t used = std::size_t(rest - &buf[0]);
+                    double perByte = double(count) / double(used);
+                    a.reserve(oldSize + std::size_t(double(hint) * perByte
+                                                    * 1.0625) + maxItems + 1);
+                        // Slack: estimate error, & the last block's room
+                    reserved = true;
+                }
+
+                if (last)
+                    break;
+                kept = len - std::size_t(rest - &buf[0]);
+                if (kept == BLOCK)
+                    throw std::runtime_error("FST read: number too long");
+                std::memmove(&buf[0], rest, kept);
+            }
+        }
+        catch (...)
+        {
+            a.resize(oldSize);
+            throw;
+        }
+        return a.size() - oldSize;
+    }
+
+    // readBinary
+    // Body of fstReadBinary.
+    template <typename T, typename Policy>
+    std::size_t readBinary(FSTArray<T, Policy> & a,
+                           Input & in)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "fstReadBinary requires a trivially copyable item type");
+        std::size_t oldSize = a.size();
+        std::size_t hintItems = in.sizeHint() / sizeof(T);
+        const std::size_t perRead = std::max(BLOCK / sizeof(T),
+                                             std::size_t(1));
+        try
+        {
+            // Known size: all the room needed, & one item more, so that
+            //  the final read sees end of input
+            if (hintItems != 0)
+                a.reserve(oldSize + hintItems + 2);
+            for (;;)
+            {
+                // Read straight into the array, past its current items
+                std::size_t n = a.size();
+                std::size_t done = n - oldSize;
+                std::size_t want = hintItems > done
+                    ? std::min(perRead, hintItems - done + 1) : perRead;
+                makeRoom(a, n + want);
+                a.resize(n + want);
+                std::size_t got = in.readFull(
+                    reinterpret_cast<char *>(&a[n]), want * sizeof(T));
+                a.resize(n + got / sizeof(T));
+                if (got % sizeof(T) != 0)
+                    throw std::runtime_error("FST read: partial item at end");
+                if (got < want * sizeof(T))
+                    break;
+            }
+        }
+        catch (...)
+        {
+            a.resize(oldSize);
+            throw;
+        }
+        return a.size() - oldSize;
+    }
+
+}  // End namespace fst_io_detail
+
+
+// *********************************************************************
+// Loading functions
+// *********************************************************************
+
+
+// fstReadInts - from file
+// Append the integers in text file path to a. Return number appended.
+// Requirements on Types:
+//     T is an integral type.
+// Strong Guarantee for the items of a
+// Exception neutral
+template <typename T, typename Policy>
+std::size_t fstReadInts(FSTArray<T, Policy> & a,
+                        const char * path)
+{
+    fst_io_detail::Input in(path);
+    return fst_io_detail::readInts(a, in);
+}
+
+
+// fstReadBinary - from file
+// Append the items stored in binary file path to a. Return number
+//  appended.
+// Requirements on Types:
+//     T is trivially copyable.
+// Strong Guarantee for the items of a
+// Exception neutral
+template <typename T, typename Policy>
+std::size_t fstReadBinary(FSTArray<T, Policy> & a,
+                          const char * path)
+{
+    fst_io_detail::Input in(path);
+    return fst_io_detail::readBinary(a, in);
+}
+
+
+#ifdef FSTARRAY_IO_POSIX
+
+// fstReadInts - from descriptor
+// Append the integers in the text read from fd (e.g., a pipe, or 0 for
+//  standard input) to a, up to end of input. fd is not closed.
+// Requirements on Types:
+//     T is an integral type.
+// Strong Guarantee for the items of a
+// Exception neutral
+template <typename T, typename Policy>
+std::size_t fstReadInts(FSTArray<T, Policy> & a,
+                        int fd)
+{
+    fst_io_detail::Input in(fd);
+    return fst_io_detail::readInts(a, in);
+}
+
+
+// fstReadBinary - from descriptor
+// Append the items read from fd to a, up to end of input. fd is not
+//  closed.
+// Requirements on Types:
+//     T is trivially copyable.
+// Strong Guarantee for the items of a
+// Exception neutral
+template <typename T, typename Policy>
+std::size_t fstReadBinary(FSTArray<T, Policy> & a,
+                          int fd)
+{
+    fst_io_detail::Input in(fd);
+    return fst_io_detail::readBinary(a, in);
+}
+
+#endif  //#ifdef FSTARRAY_IO_POSIX
+
+
+#endif  //#ifndef FILE_FSTARRAY_IO_H_INCLUDED
+
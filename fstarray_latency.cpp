@@ -0,0 +1,416 @@
+// fstarray_latency.cpp
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Per-operation latency profiler for class template FSTArray
+// Replays workload traces (fstarray_trace.h) on an FSTArray<int>,
+//  timing every operation into a histogram (fsthistogram.h) per
+//  operation kind, and reports p50/p99/p99.9/max. On Linux, also counts
+//  cycles, instructions, cache misses & branch misses for each workload
+//  with perf_event_open, if the kernel allows it (else those are blank).
+// Usage:
+//     fstarray_latency [-o FILE.csv] [-s SCALE] [WORKLOAD ...]
+//  Workloads: append, midinsert, fifo, randerase (default: all).
+//  SCALE multiplies the workload sizes (default 1).
+// Latencies include the cost of reading the clock, shown as "clock".
+// Build optimized (CMAKE_BUILD_TYPE=Release).
+
+#include "fstarray.h"        // For class template FSTArray
+#include "fsthistogram.h"    // For class FSTHistogram
+#include "fstarray_trace.h"  // For FSTTrace, fstApply, workloads
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+#include <iomanip>
+using std::setw;
+#include <fstream>
+using std::ofstream;
+#include <ostream>
+using std::ostream;
+#include <string>
+using std::string;
+#include <chrono>
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <cstdlib>
+using std::atof;
+#include <cstring>
+using std::strcmp;
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// *********************************************************************
+// Hardware Counters
+// *********************************************************************
+
+
+// class PerfCounters
+// A group of hardware counters for this thread, via perf_event_open.
+//  If they cannot be opened (not Linux, no PMU, or forbidden by
+//  perf_event_paranoid), available() is false and nothing is counted.
+class PerfCounters {
+
+public:
+
+    enum { EVENTS = 4 };
+
+    static const char * name(int i)
+    {
+        static const char * const names[EVENTS] = {
+            "cycles", "instructions", "cache_misses", "branch_misses"
+        };
+        return names[i];
+    }
+
+    PerfCounters()
+        :_leader(-1)
+    {
+        for (int i = 0; i < EVENTS; ++i)
+        {
+            _fd[i] = -1;
+            _value[i] = 0;
+        }
+#ifdef __linux__
+        const uint64_t configs[EVENTS] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (int i = 0; i < EVENTS; ++i)
+        {
+            perf_event_attr attr {};
+            attr.size = sizeof attr;
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = (i == 0);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            _fd[i] = int(syscall(SYS_perf_event_open, &attr, 0, -1,
+                                 _leader, 0));
+            if (_fd[i] < 0)
+            {
+                _close();
+                return;
+            }
+            if (i == 0)
+                _leader = _fd[0];
+        }
+#endif
+    }
+
+    ~PerfCounters()
+    {
+        _close();
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters & operator=(const PerfCounters &) = delete;
+
+    bool available() const
+    {
+        return _leader >= 0;
+    }
+
+    // start, stop
+    // Count between these calls; stop saves the counts.
+    void start()
+    {
+#ifdef __linux__
+        if (!available())
+            return;
+        ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void stop()
+    {
+#ifdef __linux__
+        if (!available())
+            return;
+        ioctl(_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        for (int i = 0; i < EVENTS; ++i)
+        {
+            uint64_t v = 0;
+            if (read(_fd[i], &v, sizeof v) != ssize_t(sizeof v))
+                v = 0;
+            _value[i] = v;
+        }
+#endif
+    }
+
+    uint64_t value(int i) const
+    {
+        return _value[i];
+    }
+
+private:
+
+    void _close()
+    {
+#ifdef __linux__
+        for (int i = EVENTS-1; i >= 0; --i)
+        {
+            if (_fd[i] >= 0)
+                close(_fd[i]);
+            _fd[i] = -1;
+        }
+#endif
+        _leader = -1;
+    }
+
+    int _leader;              // Group leader fd, or -1 if unavailable
+    int _fd[EVENTS];          // One fd per counter
+    uint64_t _value[EVENTS];  // Counts from last start/stop
+
+};  // End class PerfCounters
+
+
+// *********************************************************************
+// Profiling
+// *********************************************************************
+
+
+// struct Result
+// Histograms & counters for one workload.
+struct Result {
+    string name;
+    FSTHistogram byOp[size_t(FSTOp::COUNT)];
+    FSTHistogram all;
+    bool haveCounters = false;
+    uint64_t counters[PerfCounters::EVENTS] = {};
+};
+
+
+// nowNs
+// Return a steady-clock time, in ns.
+inline uint64_t nowNs()
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+// profile
+// Replay trace on a fresh FSTArray<int>, timing each operation.
+void profile(const FSTTrace & trace,
+             PerfCounters & perf,
+             Result & r)
+{
+    FSTArray<int> a;
+
+    perf.start();
+    for (size_t i = 0; i < trace.size(); ++i)
+    {
+        const FSTTraceEvent & e = trace[i];
+        uint64_t t0 = nowNs();
+        fstApply(a, e, int(i), i);
+        uint64_t t1 = nowNs();
+        r.byOp[size_t(e.op)].record(t1 - t0);
+    }
+    perf.stop();
+
+    for (size_t k = 0; k < size_t(FSTOp::COUNT); ++k)
+        r.all.merge(r.byOp[k]);
+    r.haveCounters = perf.available();
+    for (int c = 0; c < PerfCounters::EVENTS; ++c)
+        r.counters[c] = perf.value(c);
+}
+
+
+// clockCost
+// Return a histogram of back-to-back clock reads: the floor of every
+//  latency reported.
+FSTHistogram clockCost()
+{
+    FSTHistogram h;
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint64_t t0 = nowNs();
+        uint64_t t1 = nowNs();
+        h.record(t1 - t0);
+    }
+    return h;
+}
+
+
+// *********************************************************************
+// Output
+// *********************************************************************
+
+
+// printRow
+// Print one table row.
+void printRow(const string & workload,
+              const string & op,
+              const FSTHistogram & h)
+{
+    cout << "  " << std::left << setw(10) << workload << setw(16) << op
+         << std::right << setw(10) << h.count()
+         << setw(10) << h.percentile(50.0)
+         << setw(10) << h.percentile(99.0)
+         << setw(10) << h.percentile(99.9)
+         << setw(12) << h.max() << endl;
+}
+
+
+// csvRow
+// Write one CSV row; counters only on the "all" row of a workload.
+void csvRow(ostream & out,
+            const string & workload,
+            const string & op,
+            const FSTHistogram & h,
+            const Result * counters)
+{
+    out << workload << "," << op << "," << h.count() << ","
+        << h.percentile(50.0) << "," << h.percentile(99.0) << ","
+        << h.percentile(99.9) << "," << h.max() << ","
+        << std::fixed << std::setprecision(1) << h.mean();
+    for (int c = 0; c < PerfCounters::EVENTS; ++c)
+    {
+        out << ",";
+        if (counters != nullptr && counters->haveCounters)
+            out << counters->counters[c];
+    }
+    out << "\n";
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// struct Workload
+// Name & trace maker for one workload; size is scaled by -s.
+struct Workload {
+    const char * name;
+    FSTTrace (*make)(size_t);
+    size_t size;
+};
+
+FSTTrace makeAppend(size_t n)    { return fstAppendHeavyTrace(n); }
+FSTTrace makeMidInsert(size_t n) { return fstMidInsertTrace(n); }
+FSTTrace makeFifo(size_t n)      { return fstFifoTrace(n); }
+FSTTrace makeRandErase(size_t n) { return fstRandomEraseTrace(n); }
+
+const Workload workloads[] = {
+    { "append", makeAppend, 2000000 },
+    { "midinsert", makeMidInsert, 50000 },
+    { "fifo", makeFifo, 200000 },
+    { "randerase", makeRandErase, 50000 },
+};
+
+
+// Main program
+// Profile the workloads named on the command line, or all of them.
+int main(int argc,
+         char *argv[])
+{
+    string csvPath;
+    double scale = 1.0;
+    bool any = false;
+    bool chosen[sizeof workloads / sizeof workloads[0]] = {};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i+1 < argc)
+            csvPath = argv[++i];
+        else if (strcmp(argv[i], "-s") == 0 && i+1 < argc)
+            scale = atof(argv[++i]);
+        else
+        {
+            bool found = false;
+            for (size_t w = 0; w < sizeof workloads / sizeof workloads[0];
+                 ++w)
+            {
+                if (strcmp(argv[i], workloads[w].name) == 0)
+                    chosen[w] = found = true;
+            }
+            if (!found)
+            {
+                cerr << "Usage: " << argv[0]
+                     << " [-o FILE.csv] [-s SCALE] [WORKLOAD ...]\n"
+                     << "Workloads:";
+                for (const auto & w : workloads)
+                    cerr << " " << w.name;
+                cerr << endl;
+                return 1;
+            }
+            any = true;
+        }
+    }
+
+    PerfCounters perf;
+    FSTHistogram clock = clockCost();
+
+    ofstream csv;
+    if (!csvPath.empty())
+    {
+        csv.open(csvPath);
+        if (!csv)
+        {
+            cerr << "Cannot write " << csvPath << endl;
+            return 1;
+        }
+        csv << "workload,op,count,p50_ns,p99_ns,p999_ns,max_ns,mean_ns";
+        for (int c = 0; c < PerfCounters::EVENTS; ++c)
+            csv << "," << PerfCounters::name(c);
+        csv << "\n";
+        csvRow(csv, "clock", "now", clock, nullptr);
+    }
+
+    cout << "Latencies in ns; hardware counters "
+         << (perf.available() ? "on" : "unavailable") << "\n" << endl;
+    cout << "  " << std::left << setw(10) << "workload" << setw(16) << "op"
+         << std::right << setw(10) << "count" << setw(10) << "p50"
+         << setw(10) << "p99" << setw(10) << "p99.9" << setw(12) << "max"
+         << endl;
+    printRow("clock", "now", clock);
+
+    for (size_t w = 0; w < sizeof workloads / sizeof workloads[0]; ++w)
+    {
+        if (any && !chosen[w])
+            continue;
+        Result r;
+        r.name = workloads[w].name;
+        FSTTrace trace = workloads[w].make(
+            size_t(double(workloads[w].size) * scale));
+        profile(trace, perf, r);
+
+        for (size_t k = 0; k < size_t(FSTOp::COUNT); ++k)
+        {
+            if (r.byOp[k].count() == 0)
+                continue;
+            printRow(r.name, fstOpName(FSTOp(k)), r.byOp[k]);
+            if (csv.is_open())
+                csvRow(csv, r.name, fstOpName(FSTOp(k)), r.byOp[k],
+                       nullptr);
+        }
+        printRow(r.name, "all", r.all);
+        if (csv.is_open())
+            csvRow(csv, r.name, "all", r.all, &r);
+        if (r.haveCounters)
+        {
+            cout << "  " << setw(26) << "";
+            for (int c = 0; c < PerfCounters::EVENTS; ++c)
+                cout << " " << PerfCounters::name(c) << "="
+                     << r.counters[c];
+            cout << endl;
+        }
+    }
+    return 0;
+}
+
@@ -0,0 +1,345 @@
+// fstarray_replay.cpp
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Trace replay tool for FSTArray and candidate implementations
+// Replays a binary trace (fstarray_trace.h) against each container
+//  configuration, and reports time, number of allocations, bytes
+//  allocated, peak heap use, and heap use at the end of the trace.
+// Usage:
+//     fstarray_replay TRACE [CONFIG ...]    Replay TRACE file
+//     fstarray_replay -g WORKLOAD N TRACE   Write a synthetic trace
+//  Configurations: fstarray, shrink (FSTShrinkQuarter policy), async,
+//  vector (default: all).
+//  Workloads for -g: append, midinsert, fifo, randerase, bursty.
+// Allocator variant: target fstarray_replay_cache is this program built
+//  with FSTARRAY_BUFFER_CACHE.
+// Traces are recorded with FSTTraceRecorder and fstWriteTrace.
+// Build optimized (CMAKE_BUILD_TYPE=Release).
+
+#include "fstarray.h"        // For class template FSTArray
+#include "fstasyncarray.h"   // For class template FSTAsyncArray
+#include "fstarray_trace.h"  // For FSTTrace, fstApply, trace files
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+#include <iomanip>
+using std::setw;
+#include <fstream>
+using std::ifstream;
+using std::ofstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+#include <chrono>
+#include <cstddef>
+using std::size_t;
+#include <cstdlib>
+using std::malloc;
+using std::free;
+using std::strtoull;
+#include <cstring>
+using std::strcmp;
+#include <new>
+using std::bad_alloc;
+#include <stdexcept>
+using std::runtime_error;
+#include <atomic>
+using std::atomic;
+
+
+// *********************************************************************
+// Allocation Accounting
+// *********************************************************************
+
+
+// Counters updated by the replacement allocation functions below.
+//  Atomic, since FSTAsyncArray allocates on a background thread.
+atomic<size_t> allocCount(0);  // Number of allocations
+atomic<size_t> allocBytes(0);  // Total bytes allocated
+atomic<size_t> liveBytes(0);   // Bytes currently allocated
+atomic<size_t> peakBytes(0);   // Greatest value of liveBytes since reset
+
+// Each block starts with a header holding its size; the caller's
+//  memory follows, at maximum fundamental alignment.
+const size_t HEADER = alignof(std::max_align_t);
+
+
+// countedAlloc, countedFree
+// Allocate/free a block, keeping the counters above.
+void * countedAlloc(size_t n)
+{
+    void * raw = malloc(HEADER + n);
+    if (raw == nullptr)
+        throw bad_alloc();
+    *static_cast<size_t *>(raw) = n;
+    ++allocCount;
+    allocBytes += n;
+    size_t live = (liveBytes += n);
+    size_t peak = peakBytes.load();
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live))
+        ;
+    return static_cast<char *>(raw) + HEADER;
+}
+
+void countedFree(void * p) noexcept
+{
+    if (p == nullptr)
+        return;
+    void * raw = static_cast<char *>(p) - HEADER;
+    liveBytes -= *static_cast<size_t *>(raw);
+    free(raw);
+}
+
+
+// Replacement allocation functions
+void * operator new(size_t n)                   { return countedAlloc(n); }
+void * operator new[](size_t n)                 { return countedAlloc(n); }
+void operator delete(void * p) noexcept         { countedFree(p); }
+void operator delete[](void * p) noexcept       { countedFree(p); }
+void operator delete(void * p, size_t) noexcept { countedFree(p); }
+void operator delete[](void * p, size_t) noexcept
+                                                { countedFree(p); }
+
+
+// *********************************************************************
+// Configurations
+// *********************************************************************
+
+
+// class VectorArray
+// std::vector with the FSTArray interface used by fstApply, as a
+//  baseline.
+class VectorArray {
+
+public:
+
+    using value_type = int;
+    using iterator = vector<int>::iterator;
+
+    explicit VectorArray(size_t size=0)
+        :_v(size)
+    {}
+
+    iterator begin()
+    {
+        return _v.begin();
+    }
+
+    size_t size() const
+    {
+        return _v.size();
+    }
+
+    void resize(size_t n)
+    {
+        _v.resize(n);
+    }
+
+    void push_back(int item)
+    {
+        _v.push_back(item);
+    }
+
+    void pop_back()
+    {
+        _v.pop_back();
+    }
+
+    void insert(iterator pos, int item)
+    {
+        _v.insert(pos, item);
+    }
+
+    void erase(iterator pos)
+    {
+        _v.erase(pos);
+    }
+
+    void unordered_erase(iterator pos)
+    {
+        *pos = _v.back();
+        _v.pop_back();
+    }
+
+private:
+
+    vector<int> _v;
+
+};  // End class VectorArray
+
+
+// struct Stats
+// Measurements for one replay.
+struct Stats {
+    double seconds;
+    size_t allocs;
+    size_t bytes;
+    size_t peak;
+    size_t endBytes;
+    size_t finalSize;
+};
+
+
+// replay
+// Replay trace on a fresh Array; return measurements. Peak is heap use
+//  above what was live at the start.
+template <typename Array>
+Stats replay(const FSTTrace & trace)
+{
+    size_t allocsBefore = allocCount;
+    size_t bytesBefore = allocBytes;
+    size_t liveBefore = liveBytes;
+    peakBytes = liveBytes.load();
+
+    Stats s;
+    auto start = std::chrono::steady_clock::now();
+    {
+        Array a;
+        for (size_t i = 0; i < trace.size(); ++i)
+            fstApply(a, trace[i], int(i), i);
+        s.finalSize = a.size();
+        s.endBytes = liveBytes - liveBefore;
+    }
+    std::chrono::duration<double> d =
+        std::chrono::steady_clock::now() - start;
+
+    s.seconds = d.count();
+    s.allocs = allocCount - allocsBefore;
+    s.bytes = allocBytes - bytesBefore;
+    s.peak = peakBytes - liveBefore;
+    return s;
+}
+
+
+// struct Config
+// Name & replay function for one configuration.
+struct Config {
+    const char * name;
+    Stats (*run)(const FSTTrace &);
+};
+
+const Config configs[] = {
+    { "fstarray", replay<FSTArray<int>> },
+    { "shrink", replay<FSTArray<int, FSTShrinkQuarter>> },
+    { "async", replay<FSTAsyncArray<int>> },
+    { "vector", replay<VectorArray> },
+};
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// generate
+// Write a synthetic trace file. Return exit status.
+int generate(const char * workload,
+             size_t n,
+             const char * path)
+{
+    FSTTrace trace(0);
+    if (strcmp(workload, "append") == 0)
+        trace = fstAppendHeavyTrace(n);
+    else if (strcmp(workload, "midinsert") == 0)
+        trace = fstMidInsertTrace(n);
+    else if (strcmp(workload, "fifo") == 0)
+        trace = fstFifoTrace(n);
+    else if (strcmp(workload, "randerase") == 0)
+        trace = fstRandomEraseTrace(n);
+    else if (strcmp(workload, "bursty") == 0)
+        trace = fstBurstyTrace(n);
+    else
+    {
+        cerr << "Unknown workload: " << workload << endl;
+        return 1;
+    }
+
+    ofstream out(path, std::ios::binary);
+    fstWriteTrace(out, trace);
+    if (!out)
+    {
+        cerr << "Cannot write " << path << endl;
+        return 1;
+    }
+    cout << "Wrote " << trace.size() << " events to " << path << endl;
+    return 0;
+}
+
+
+// Main program
+// Replay a trace against the named configurations, or all of them.
+int main(int argc,
+         char *argv[])
+{
+    if (argc == 5 && strcmp(argv[1], "-g") == 0)
+        return generate(argv[2], size_t(strtoull(argv[3], nullptr, 10)),
+                        argv[4]);
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " TRACE [CONFIG ...]\n"
+             << "       " << argv[0] << " -g WORKLOAD N TRACE\n"
+             << "Configurations:";
+        for (const auto & c : configs)
+            cerr << " " << c.name;
+        cerr << endl;
+        return 1;
+    }
+
+    FSTTrace trace(0);
+    try
+    {
+        ifstream in(argv[1], std::ios::binary);
+        if (!in)
+            throw runtime_error(string("cannot open ") + argv[1]);
+        trace = fstReadTrace(in);
+    }
+    catch (runtime_error & e)
+    {
+        cerr << argv[0] << ": " << e.what() << endl;
+        return 1;
+    }
+
+    double span = trace.size() == 0
+                ? 0.0 : double(trace[trace.size()-1].time) * 1.0e-9;
+    cout << argv[1] << ": " << trace.size() << " events, recorded over "
+         << span << " s\n" << endl;
+    cout << "  " << std::left << setw(10) << "config" << std::right
+         << setw(12) << "seconds" << setw(10) << "allocs"
+         << setw(14) << "bytes" << setw(14) << "peak bytes"
+         << setw(14) << "end bytes" << setw(12) << "final size" << endl;
+
+    for (const auto & c : configs)
+    {
+        bool run = (argc == 2);
+        for (int i = 2; i < argc; ++i)
+        {
+            if (strcmp(argv[i], c.name) == 0)
+                run = true;
+        }
+        if (!run)
+            continue;
+
+        Stats s;
+        try
+        {
+            s = c.run(trace);
+        }
+        catch (runtime_error & e)
+        {
+            cerr << argv[0] << ": " << e.what() << endl;
+            return 1;
+        }
+        cout << "  " << std::left << setw(10) << c.name << std::right
+             << std::fixed << std::setprecision(6) << setw(12)
+             << s.seconds << setw(10) << s.allocs << setw(14) << s.bytes
+             << setw(14) << s.peak << setw(14) << s.endBytes
+             << setw(12) << s.finalSize << endl;
+    }
+    return 0;
+}
+
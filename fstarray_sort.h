@@ -0,0 +1,510 @@
+// fstarray_sort.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Sorting for FSTArray: radix sort, parallel merge sort, radix select,
+//  and an adaptive front end
+
+#ifndef FILE_FSTARRAY_SORT_H_INCLUDED
+#define FILE_FSTARRAY_SORT_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::uint8_t etc.
+#include <algorithm>
+// For std::sort
+// For std::nth_element
+// For std::merge
+// For std::move
+// For std::swap
+#include <bit>
+// For std::bit_cast
+// For std::bit_floor
+#include <exception>
+// For std::exception_ptr
+// For std::current_exception
+// For std::rethrow_exception
+#include <functional>
+// For std::less
+#include <iterator>
+// For std::make_move_iterator
+#include <thread>
+// For std::thread
+#include <type_traits>
+// For std::is_arithmetic_v
+// For std::is_signed_v
+// For std::is_floating_point_v
+// For std::is_invocable_r_v
+// For std::enable_if_t
+#include <vector>
+// For std::vector
+
+// Sorting entry points:
+//     fstSort(a)                Adaptive: std::sort for small arrays,
+//                               radix sort for arithmetic items, parallel
+//                               merge sort (of radix- or std::sort-ed
+//                               runs) for large arrays on several cores.
+//     fstSort(a, comp)          Same, comparison-based only.
+//     fstRadixSort(a)           LSD radix sort, arithmetic items.
+//     fstParallelSort(a, comp)  Parallel merge sort.
+//     fstNthElement(a, k)       Like std::nth_element; radix select for
+//                               arithmetic items.
+//     fstPartialSort(a, k)      Like std::partial_sort: first k items
+//                               are the smallest, in order.
+// Order: for arithmetic items, the radix routines use the total order
+//  of the item's bits: the usual order for integers; for floating-point
+//  items, -0.0 before +0.0, and NaNs at the ends (by sign). Without
+//  NaNs, this agrees with operator<. Items wider than 8 bytes (long
+//  double) have no radix key; all routines sort them with operator<.
+// Guarantees: all are Basic Guarantee, Exception neutral. Any throw
+//  leaves the array holding some permutation of its items, except that
+//  with a throwing comparison or move, items may be moved-from.
+
+
+// *********************************************************************
+// Implementation details
+// *********************************************************************
+
+
+namespace fst_sort_detail {
+
+    // Arrays below this size are sorted with std::sort
+    constexpr std::size_t SMALL = 256;
+    // Arrays at or above this size are sorted in parallel, when threads
+    //  are available; also the least items per thread
+    constexpr std::size_t PARALLEL_MIN = std::size_t(1) << 18;
+    // Radix select finishes with std::nth_element below this size
+    constexpr std::size_t SELECT_SMALL = std::size_t(1) << 16;
+
+    // Key<T>: unsigned type as wide as T
+    template <std::size_t bytes> struct UnsignedOf;
+    template <> struct UnsignedOf<1> { using type = std::uint8_t; };
+    template <> struct UnsignedOf<2> { using type = std::uint16_t; };
+    template <> struct UnsignedOf<4> { using type = std::uint32_t; };
+    template <> struct UnsignedOf<8> { using type = std::uint64_t; };
+
+    template <typename T>
+    using Key = typename UnsignedOf<sizeof(T)>::type;
+
+    // RADIX<T>: T is sorted by key (arithmetic, with a key type). Wider
+    //  types (long double) have no key & are sorted with operator<.
+    template <typename T>
+    constexpr bool RADIX = std::is_arithmetic_v<T> && sizeof(T) <= 8;
+
+    // key
+    // Return unsigned key for v, whose unsigned order is the sort order
+    //  of v (see top of file).
+    template <typename T>
+    Key<T> key(T v) noexcept
+    {
+        using K = Key<T>;
+        constexpr K TOP = K(K(1) << (8*sizeof(T) - 1));
+        if constexpr (std::is_same_v<T, bool>)
+            return K(v);
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            K bits = std::bit_cast<K>(v);
+            return (bits & TOP) ? K(~bits) : K(bits | TOP);
+        }
+        else if constexpr (std::is_signed_v<T>)
+            return K(K(v) ^ TOP);
+        else
+            return K(v);
+    }
+
+    // digit
+    // Return byte d (0 = least significant) of the key of v.
+    template <typename T>
+    unsigned digit(T v,
+                   unsigned d) noexcept
+    {
+        return unsigned(key(v) >> (8*d)) & 0xffu;
+    }
+
+    // radixSort
+    // LSD radix sort of data[0 .. n-1], one byte per pass, using
+    //  scratch[0 .. n-1]. One counting pass makes all histograms; passes
+    //  whose byte is the same in every item are skipped.
+    // No-Throw Guarantee
+    template <typename T>
+    void radixSort(T * data,
+                   T * scratch,
+                   std::size_t n) noexcept
+    {
+        constexpr unsigned DIGITS = sizeof(T);
+        if (n < 2)
+            return;
+        std::size_t counts[DIGITS][256] = {};  // 16 KB at most
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto k = key(data[i]);
+            for (unsigned d = 0; d < DIGITS; ++d)
+                ++counts[d][unsigned(k >> (8*d)) & 0xffu];
+        }
+
+        T * src = data;
+        T * dst = scratch;
+        for (unsigned d = 0; d < DIGITS; ++d)
+        {
+            std::size_t * c = counts[d];
+            if (c[digit(src[0], d)] == n)
+                continue;  // All items agree in this byte
+            std::size_t sum = 0;
+            for (unsigned b = 0; b < 256; ++b)
+            {
+                std::size_t count = c[b];
+                c[b] = sum;
+                sum += count;
+            }
+            for (std::size_t i = 0; i < n; ++i)
+                dst[c[digit(src[i], d)]++] = src[i];
+            std::swap(src, dst);
+        }
+        if (src != data)
+            std::copy(src, src + n, data);
+    }
+
+    // KeyLess
+    // Comparison in radix order, for std:: algorithms.
+    template <typename T>
+    struct KeyLess {
+        bool operator()(T a, T b) const noexcept
+        {
+            return key(a) < key(b);
+        }
+    };
+
+    // radixSelect
+    // Rearrange data[0 .. n-1] as std::nth_element would, with nth at
+    //  data[k], in radix order: MSD, one byte at a time. Each round
+    //  counts the current byte over the remaining range, picks the
+    //  bucket holding position k, and partitions the range three ways
+    //  around it.
+    // Pre:
+    //     k < n.
+    // No-Throw Guarantee
+    template <typename T>
+    void radixSelect(T * data,
+                     std::size_t n,
+                     std::size_t k) noexcept
+    {
+        std::size_t lo = 0;
+        std::size_t hi = n;
+        for (int d = int(sizeof(T)) - 1; d >= 0; --d)
+        {
+            if (hi - lo <= SELECT_SMALL)
+                break;
+            std::size_t counts[256] = {};
+            for (std::size_t i = lo; i < hi; ++i)
+                ++counts[digit(data[i], unsigned(d))];
+            unsigned b = 0;
+            std::size_t below = 0;
+            while (below + counts[b] <= k - lo)
+                below += counts[b++];
+
+            // Three-way partition: byte < b, == b, > b
+            std::size_t lt = lo;
+            std::size_t i = lo;
+            std::size_t gt = hi;
+            while (i < gt)
+            {
+                unsigned v = digit(data[i], unsigned(d));
+                if (v < b)
+                    std::swap(data[lt++], data[i++]);
+                else if (v > b)
+                    std::swap(data[i], data[--gt]);
+                else
+                    ++i;
+            }
+            lo = lt;
+            hi = gt;
+        }
+        if (hi - lo > 1)
+            std::nth_element(data + lo, data + k, data + hi, KeyLess<T>());
+    }
+
+    // runParallel
+    // Call f(i) for i in 0 .. count-1, each on its own thread (i ==
+    //  count-1 on this one). Waits for all; rethrows the first
+    //  exception, if any.
+    // Basic Guarantee
+    template <typename Func>
+    void runParallel(std::size_t count,
+                     Func f)
+    {
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> threads;
+        threads.reserve(count);
+        auto body = [&](std::size_t i)
+        {
+            try
+            {
+                f(i);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        };
+        try
+        {
+            for (std::size_t i = 0; i + 1 < count; ++i)
+                threads.emplace_back(body, i);
+        }
+        catch (...)
+        {
+            for (auto & t : threads)
+                t.join();
+            throw;
+        }
+        body(count - 1);
+        for (auto & t : threads)
+            t.join();
+        for (auto & e : errors)
+        {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    // parallelMergeSort
+    // Sort data[0 .. n-1] in parts (a power of 2) runs, each sorted by
+    //  sortRun(first, scratch, count) on its own thread, then merge
+    //  pairs of runs in parallel rounds, ping-ponging with scratch.
+    // Basic Guarantee
+    // Exception neutral
+    template <typename T, typename Compare, typename SortRun>
+    void parallelMergeSort(T * data,
+                           T * scratch,
+                           std::size_t n,
+                           std::size_t parts,
+                           Compare comp,
+                           SortRun sortRun)
+    {
+        auto bound = [&](std::size_t i)
+        {
+            return n / parts * i + std::min(i, n % parts);
+        };
+        runParallel(parts, [&](std::size_t i)
+        {
+            sortRun(data + bound(i), scratch + bound(i),
+                    bound(i+1) - bound(i));
+        });
+
+        T * src = data;
+        T * dst = scratch;
+        for (std::size_t width = 1; width < parts; width *= 2)
+        {
+            runParallel(parts / (2*width), [&](std::size_t j)
+            {
+                std::size_t first = bound(2*width*j);
+                std::size_t mid = bound(2*width*j + width);
+                std::size_t last = bound(2*width*(j+1));
+                std::merge(std::make_move_iterator(src + first),
+                           std::make_move_iterator(src + mid),
+                           std::make_move_iterator(src + mid),
+                           std::make_move_iterator(src + last),
+                           dst + first, comp);
+            });
+            std::swap(src, dst);
+        }
+        if (src != data)
+            std::move(src, src + n, data);
+    }
+
+    // threadCount
+    // Return threads to use for n items: a power of 2, at most
+    //  maxThreads (0 means hardware concurrency), with at least
+    //  PARALLEL_MIN items each.
+    inline std::size_t threadCount(std::size_t n,
+                                   unsigned maxThreads) noexcept
+    {
+        std::size_t t = maxThreads != 0 ? maxThreads
+                                        : std::thread::hardware_concurrency();
+        t = std::min(t, n / PARALLEL_MIN);
+        return t == 0 ? 1 : std::bit_floor(t);
+    }
+
+    // sortRange
+    // Sort data[0 .. n-1] on this thread: std::sort when small, radix
+    //  sort (with a scratch FSTArray) for RADIX items. RADIX items are
+    //  always in radix order.
+    // Basic Guarantee
+    // Exception neutral
+    template <typename T>
+    void sortRange(T * data,
+                   std::size_t n)
+    {
+        if constexpr (RADIX<T>)
+        {
+            if (n < SMALL)
+                std::sort(data, data + n, KeyLess<T>());
+            else
+            {
+                FSTArray<T> scratch(n);
+                radixSort(data, &scratch[0], n);
+            }
+        }
+        else
+            std::sort(data, data + n);
+    }
+
+}  // End namespace fst_sort_detail
+
+
+// *********************************************************************
+// Sorting functions
+// *********************************************************************
+
+
+// fstRadixSort
+// Sort a by LSD radix sort, with an FSTArray scratch buffer of the same
+//  size. O(n) for fixed-width keys. Items wider than 8 bytes are sorted
+//  with std::sort instead.
+// Requirements on Types:
+//     T is an arithmetic type.
+// Basic Guarantee (throws only if the scratch buffer cannot be
+//  allocated; then a is unchanged)
+template <typename T, typename Policy>
+void fstRadixSort(FSTArray<T, Policy> & a)
+{
+    static_assert(std::is_arithmetic_v<T>,
+                  "fstRadixSort requires an arithmetic item type");
+    if (a.size() < 2)
+        return;
+    if constexpr (!fst_sort_detail::RADIX<T>)
+        std::sort(&a[0], &a[0] + a.size());
+    else
+    {
+        FSTArray<T> scratch(a.size());
+        fst_sort_detail::radixSort(&a[0], &scratch[0], a.size());
+    }
+}
+
+
+// fstParallelSort
+// Sort a by parallel merge sort: runs sorted with std::sort on up to
+//  maxThreads threads (0: hardware concurrency), then merged in
+//  parallel rounds. Not stable.
+// Requirements on Types:
+//     T is default-constructible & movable; comp is a strict weak order.
+// Basic Guarantee
+// Exception neutral
+template <typename T, typename Policy, typename Compare=std::less<T>>
+void fstParallelSort(FSTArray<T, Policy> & a,
+                     Compare comp=Compare(),
+                     unsigned maxThreads=0)
+{
+    std::size_t n = a.size();
+    std::size_t parts = fst_sort_detail::threadCount(n, maxThreads);
+    if (parts <= 1)
+    {
+        if (n > 1)
+            std::sort(&a[0], &a[0] + n, comp);
+        return;
+    }
+    FSTArray<T> scratch(n);
+    fst_sort_detail::parallelMergeSort(&a[0], &scratch[0], n, parts, comp,
+        [&](T * first, T *, std::size_t count)
+        {
+            std::sort(first, first + count, comp);
+        });
+}
+
+
+// fstSort
+// Sort a, choosing the algorithm by size & type (see top of file).
+//  maxThreads limits parallelism (0: hardware concurrency; 1: none).
+// Requirements on Types:
+//     T is default-constructible & movable, and has operator<.
+// Basic Guarantee
+// Exception neutral
+template <typename T, typename Policy>
+void fstSort(FSTArray<T, Policy> & a,
+             unsigned maxThreads=0)
+{
+    using namespace fst_sort_detail;
+    std::size_t n = a.size();
+    std::size_t parts = threadCount(n, maxThreads);
+    if (parts <= 1)
+    {
+        if (n > 1)
+            sortRange(&a[0], n);
+        return;
+    }
+    if constexpr (!RADIX<T>)
+        fstParallelSort(a, std::less<T>(), maxThreads);
+    else
+    {
+        FSTArray<T> scratch(n);
+        parallelMergeSort(&a[0], &scratch[0], n, parts, KeyLess<T>(),
+            [](T * first, T * buf, std::size_t count)
+            {
+                radixSort(first, buf, count);
+            });
+    }
+}
+
+
+// fstSort - with comparison
+// Sort a by comp: std::sort, or parallel merge sort for large arrays.
+// Requirements on Types:
+//     T is default-constructible & movable; comp is a strict weak order.
+// Basic Guarantee
+// Exception neutral
+template <typename T, typename Policy, typename Compare,
+          typename = std::enable_if_t<
+              std::is_invocable_r_v<bool, Compare &, const T &, const T &>>>
+void fstSort(FSTArray<T, Policy> & a,
+             Compare comp,
+             unsigned maxThreads=0)
+{
+    fstParallelSort(a, comp, maxThreads);
+}
+
+
+// fstNthElement
+// Rearrange a so that a[k] holds the item that would be there if a were
+//  sorted, with no greater item before it and no lesser item after it.
+//  Radix select for arithmetic items: O(n) with small constants, no
+//  comparisons.
+// Pre:
+//     k < a.size().
+// Basic Guarantee
+// Exception neutral
+template <typename T, typename Policy>
+void fstNthElement(FSTArray<T, Policy> & a,
+                   std::size_t k)
+{
+    if constexpr (fst_sort_detail::RADIX<T>)
+        fst_sort_detail::radixSelect(&a[0], a.size(), k);
+    else
+        std::nth_element(&a[0], &a[0] + k, &a[0] + a.size());
+}
+
+
+// fstPartialSort
+// Rearrange a so that a[0 .. k-1] are its k smallest items, in order;
+//  the rest are in unspecified order. Selects, then sorts the first k.
+// Pre:
+//     k <= a.size().
+// Basic Guarantee
+// Exception neutral
+template <typename T, typename Policy>
+void fstPartialSort(FSTArray<T, Policy> & a,
+                    std::size_t k)
+{
+    if (k == 0)
+        return;
+    if (k < a.size())
+        fstNthElement(a, k);
+    fst_sort_detail::sortRange(&a[0], k);
+}
+
+
+#endif  //#ifndef FILE_FSTARRAY_SORT_H_INCLUDED
+
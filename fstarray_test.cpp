@@ -6,11 +6,34 @@
 // Test program for class template FSTArray
 // For Project 5, Exercise A
 // Uses the "doctest" unit-testing framework, version 2
-// Requires doctest.h, fstarray.h
+// Requires doctest.h, fstarray.h, fstslotmap.h, fstbuffercache.h,
+//  fstasyncarray.h, fstfixedarray.h, fsthistogram.h, fstarray_trace.h,
+//  fstpackedarray.h, fstfrozenarray.h, fstarray_sort.h, fstarray_io.h,
+//  fstarray_asyncio.h, fstsharedarray.h, fstrcuarray.h,
+//  fstshardedarray.h, fstarray_gather.h, fstarray_expr.h, fstarrayview.h,
+//  fstarray_hash.h
 
 // Includes for code to be tested
 #include "fstarray.h"        // For class template FSTArray
 #include "fstarray.h"        // Double-inclusion check, for testing only
+#include "fstslotmap.h"      // For class template FSTSlotMap
+#include "fstbuffercache.h"  // For class template FSTBufferCache
+#include "fstasyncarray.h"   // For class template FSTAsyncArray
+#include "fstfixedarray.h"   // For class template FSTFixedArray
+#include "fsthistogram.h"    // For class FSTHistogram
+#include "fstarray_trace.h"  // For class template FSTTraceRecorder
+#include "fstpackedarray.h"  // For class template FSTPackedArray
+#include "fstfrozenarray.h"  // For class FSTFrozenArray
+#include "fstarray_sort.h"   // For fstSort etc.
+#include "fstarray_io.h"     // For fstReadInts, fstReadBinary
+#include "fstarray_asyncio.h"  // For fstSaveAsync, fstLoadAsync
+#include "fstsharedarray.h"  // For class template FSTSharedArray
+#include "fstrcuarray.h"     // For class template FSTRcuArray
+#include "fstshardedarray.h"  // For class template FSTShardedArray
+#include "fstarray_gather.h"  // For fstGather, fstScatter
+#include "fstarray_expr.h"  // For class template FSTExpr
+#include "fstarrayview.h"  // For class templates FSTArrayView etc.
+#include "fstarray_hash.h"  // For fstHash, std::hash<FSTArray>
 
 // Includes for the "doctest" unit-testing framework
 #define DOCTEST_CONFIG_IMPLEMENT
@@ -43,6 +66,28 @@ using std::equal;
 using std::runtime_error;
 #include <cassert>
 // For assert
+#include <sstream>
+// For std::stringstream
+#include <fstream>
+// For std::ofstream
+#include <filesystem>
+// For std::filesystem::temp_directory_path
+#include <cstdio>
+// For std::remove
+#include <unistd.h>
+// For fork, dup, getpid, _exit
+#include <sys/wait.h>
+// For waitpid
+#include <thread>
+// For std::thread
+#include <atomic>
+// For std::atomic
+#include <span>
+// For std::span
+#include <iterator>
+// For std::distance
+#include <unordered_set>
+// For std::unordered_set
 
 // Printable name for this test suite
 const string test_suite_name =
@@ -793,6 +838,101 @@ TEST_CASE( "FSTArray bracket operator" )
 }
 
 
+TEST_CASE( "FSTArray at" )
+{
+    SUBCASE( "at - in range" )
+    {
+        const size_t SIZE = size_t(10);
+        FSTArray<int> ti(SIZE);
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            ti.at(i) = 15-int(i)*int(i);
+        }
+
+        {
+        INFO( "at (non-const) - check values" );
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            REQUIRE( ti.at(i) == 15-int(i)*int(i) );
+            REQUIRE( &ti.at(i) == &ti[i] );
+        }
+        }
+
+        const FSTArray<int> & ctiref = ti;
+        {
+        INFO( "at (const) - check values" );
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            REQUIRE( ctiref.at(i) == 15-int(i)*int(i) );
+        }
+        }
+    }
+
+    SUBCASE( "at - out of range" )
+    {
+        const size_t SIZE = size_t(10);
+        FSTArray<int> ti(SIZE);
+        const FSTArray<int> & ctiref = ti;
+        bool throws_proper_type;
+
+        try
+        {
+            ti.at(SIZE);
+            throws_proper_type = false;
+        }
+        catch (std::out_of_range & e)
+        {
+            throws_proper_type = true;
+        }
+        catch (...)
+        {
+            throws_proper_type = false;
+        }
+        {
+        INFO( "at (non-const) - index == size throws std::out_of_range" );
+        REQUIRE( throws_proper_type );
+        }
+
+        try
+        {
+            ctiref.at(size_t(-1));
+            throws_proper_type = false;
+        }
+        catch (std::out_of_range & e)
+        {
+            throws_proper_type = true;
+        }
+        catch (...)
+        {
+            throws_proper_type = false;
+        }
+        {
+        INFO( "at (const) - huge index throws std::out_of_range" );
+        REQUIRE( throws_proper_type );
+        }
+
+        ti.resize(0);
+        try
+        {
+            ti.at(0);
+            throws_proper_type = false;
+        }
+        catch (std::out_of_range & e)
+        {
+            throws_proper_type = true;
+        }
+        catch (...)
+        {
+            throws_proper_type = false;
+        }
+        {
+        INFO( "at - empty array throws std::out_of_range" );
+        REQUIRE( throws_proper_type );
+        }
+    }
+}
+
+
 TEST_CASE( "FSTArray copy ctor" )
 {
     SUBCASE( "Copy ctor - separate arrays" )
@@ -1292,6 +1432,179 @@ TEST_CASE( "FSTArray resize" )
 
 
 
+TEST_CASE( "FSTArray shrink_to_fit" )
+{
+    SUBCASE( "Shrink after resize smaller" )
+    {
+        FSTArray<int> ti(1000);
+        for (size_t i = 0; i < ti.size(); ++i)
+        {
+            ti[i] = int(i)*3;
+        }
+        ti.resize(10);
+        {
+        INFO( "resize smaller keeps capacity" );
+        REQUIRE( ti.capacity() >= 1000 );
+        }
+        ti.shrink_to_fit();
+        {
+        INFO( "shrink_to_fit - capacity reduced" );
+        REQUIRE( ti.capacity() >= 10 );
+        REQUIRE( ti.capacity() < 1000 );
+        }
+        {
+        INFO( "shrink_to_fit - values kept" );
+        REQUIRE( ti.size() == 10 );
+        for (size_t i = 0; i < ti.size(); ++i)
+        {
+            REQUIRE( ti[i] == int(i)*3 );
+        }
+        }
+        ti.push_back(-1);
+        {
+        INFO( "push_back after shrink_to_fit" );
+        REQUIRE( ti.size() == 11 );
+        REQUIRE( ti[10] == -1 );
+        }
+    }
+
+    SUBCASE( "Shrink empty array" )
+    {
+        FSTArray<int> ti(100);
+        ti.resize(0);
+        ti.shrink_to_fit();
+        {
+        INFO( "shrink_to_fit of empty array releases buffer" );
+        REQUIRE( ti.capacity() == 0 );
+        REQUIRE( ti.size() == 0 );
+        }
+        ti.push_back(7);
+        {
+        INFO( "push_back after releasing buffer" );
+        REQUIRE( ti.size() == 1 );
+        REQUIRE( ti[0] == 7 );
+        }
+    }
+
+    SUBCASE( "reserve" )
+    {
+        FSTArray<int> ti(3);
+        ti[2] = 5;
+        ti.reserve(1000);
+        auto b = ti.begin();
+        {
+        INFO( "reserve - capacity grows, values kept" );
+        REQUIRE( ti.capacity() >= 1000 );
+        REQUIRE( ti.size() == 3 );
+        REQUIRE( ti[2] == 5 );
+        }
+        ti.resize(999);
+        {
+        INFO( "reserve - no reallocation below reserved capacity" );
+        REQUIRE( ti.begin() == b );
+        }
+        ti.reserve(10);
+        {
+        INFO( "reserve - smaller request does nothing" );
+        REQUIRE( ti.capacity() >= 1000 );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTArray shrink policy" )
+{
+    SUBCASE( "Default policy keeps buffer" )
+    {
+        FSTArray<int> ti(1000);
+        int * savedata = ti.begin();
+        ti.resize(1);
+        ti.erase(ti.begin());
+        {
+        INFO( "Default policy - resize smaller keeps the address" );
+        REQUIRE( ti.begin() == savedata );
+        REQUIRE( ti.capacity() >= 1000 );
+        }
+    }
+
+    SUBCASE( "Quarter policy shrinks with hysteresis" )
+    {
+        FSTArray<int, FSTShrinkQuarter> ti(1000);
+        for (size_t i = 0; i < ti.size(); ++i)
+        {
+            ti[i] = int(i);
+        }
+        size_t bigcap = ti.capacity();
+        ti.resize(300);
+        {
+        INFO( "Quarter policy - no shrink above a quarter full" );
+        REQUIRE( ti.capacity() == bigcap );
+        }
+        ti.resize(100);
+        {
+        INFO( "Quarter policy - shrink below a quarter full" );
+        REQUIRE( ti.capacity() < bigcap );
+        REQUIRE( ti.capacity() >= 200 );
+        REQUIRE( ti.size() == 100 );
+        REQUIRE( ti[99] == 99 );
+        }
+        while (ti.size() > 0)
+        {
+            ti.pop_back();
+        }
+        {
+        INFO( "Quarter policy - never below minimum capacity" );
+        REQUIRE( ti.capacity() == 16 );
+        }
+
+        // Alternating push_back & pop_back must not reallocate each time
+        for (int i = 0; i < 40; ++i)
+        {
+            ti.push_back(i);
+        }
+        int realloccount = 0;
+        for (int i = 0; i < 1000; ++i)
+        {
+            int * savedata = ti.begin();
+            if (i % 2 == 0)
+                ti.push_back(i);
+            else
+                ti.pop_back();
+            if (ti.begin() != savedata)
+                ++realloccount;
+        }
+        {
+        INFO( "Quarter policy - no thrashing" );
+        REQUIRE( realloccount <= 1 );
+        }
+    }
+
+    SUBCASE( "Quarter policy keeps reserved space while growing" )
+    {
+        FSTArray<int, FSTShrinkQuarter> ti(0);
+        ti.reserve(100000);
+        size_t bigcap = ti.capacity();
+        int * savedata = ti.begin();
+        int realloccount = 0;
+        for (int i = 0; i < 99999; ++i)
+        {
+            ti.push_back(i);
+            if (ti.begin() != savedata)
+            {
+                ++realloccount;
+                savedata = ti.begin();
+            }
+        }
+        {
+        INFO( "Quarter policy - push_back does not undo reserve" );
+        REQUIRE( bigcap >= size_t(100000) );
+        REQUIRE( ti.capacity() == bigcap );
+        REQUIRE( realloccount == 0 );
+        }
+    }
+}
+
+
 TEST_CASE( "FSTArray insert" )
 {
     const size_t SIZE = size_t(10);
@@ -1626,6 +1939,140 @@ TEST_CASE( "FSTArray insert & erase" )
 
 
 
+TEST_CASE( "FSTArray unordered_erase & erase_if" )
+{
+    const size_t SIZE = size_t(10);
+    FSTArray<int> ti_original(SIZE);
+    for (size_t i = 0; i < SIZE; ++i)
+    {
+        ti_original[i] = 15-int(i)*int(i);
+    }
+
+    SUBCASE( "unordered_erase in middle" )
+    {
+        FSTArray<int> ti = ti_original;
+        int * savedata = ti.begin();
+        auto iter = ti.unordered_erase(ti.begin()+3);
+
+        {
+        INFO( "unordered_erase - no reallocate-and-copy" );
+        REQUIRE( ti.begin() == savedata );
+        }
+        {
+        INFO( "unordered_erase - check size" );
+        REQUIRE( ti.size() == SIZE-1 );
+        }
+        {
+        INFO( "unordered_erase - return value" );
+        REQUIRE( iter == ti.begin()+3 );
+        }
+        {
+        INFO( "unordered_erase - last item moved into hole" );
+        for (size_t i = 0; i < SIZE-1; ++i)
+        {
+            size_t j = (i == size_t(3) ? SIZE-1 : i);
+            REQUIRE( ti[i] == 15-int(j)*int(j) );
+        }
+        }
+    }
+
+    SUBCASE( "unordered_erase at end" )
+    {
+        FSTArray<int> ti = ti_original;
+        auto iter = ti.unordered_erase(ti.end()-1);
+
+        {
+        INFO( "unordered_erase at end - check size & return value" );
+        REQUIRE( ti.size() == SIZE-1 );
+        REQUIRE( iter == ti.end() );
+        }
+        {
+        INFO( "unordered_erase at end - check values" );
+        for (size_t i = 0; i < SIZE-1; ++i)
+        {
+            REQUIRE( ti[i] == 15-int(i)*int(i) );
+        }
+        }
+    }
+
+    SUBCASE( "erase_if - trivially copyable" )
+    {
+        FSTArray<int> ti = ti_original;
+        size_t removed = ti.erase_if([](int x) { return x % 2 == 0; });
+
+        vector<int> expected;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            int v = 15-int(i)*int(i);
+            if (v % 2 != 0)
+                expected.push_back(v);
+        }
+
+        {
+        INFO( "erase_if - check count & size" );
+        REQUIRE( removed == SIZE-expected.size() );
+        REQUIRE( ti.size() == expected.size() );
+        }
+        {
+        INFO( "erase_if - survivors keep their order" );
+        REQUIRE( equal(ti.begin(), ti.end(), expected.begin()) );
+        }
+    }
+
+    SUBCASE( "erase_if - non-trivial type" )
+    {
+        FSTArray<string> ts(0);
+        for (size_t i = 0; i < SIZE; ++i)
+            ts.push_back(string(i, 'x'));
+        size_t removed = ts.erase_if([](const string & x)
+                                     { return x.size() % 3 == 0; });
+
+        {
+        INFO( "erase_if (string) - check count & values" );
+        REQUIRE( removed == size_t(4) );
+        REQUIRE( ts.size() == SIZE-4 );
+        for (size_t i = 0; i < ts.size(); ++i)
+        {
+            REQUIRE( ts[i].size() % 3 != 0 );
+            if (i > 0)
+            {
+                REQUIRE( ts[i-1].size() < ts[i].size() );
+            }
+        }
+        }
+    }
+
+    SUBCASE( "erase_if - throwing predicate" )
+    {
+        FSTArray<int> ti = ti_original;
+        int calls = 0;
+        try
+        {
+            ti.erase_if([&calls](int x) {
+                if (++calls == 5)
+                    throw runtime_error("P");
+                return x % 2 == 0;
+            });
+        }
+        catch (runtime_error & e)
+        {
+        }
+
+        // Items 0..3 judged: 15, 14, 11, 6 -> 14 & 6 removed
+        {
+        INFO( "erase_if - judged items applied, rest kept" );
+        REQUIRE( ti.size() == SIZE-2 );
+        REQUIRE( ti[0] == 15 );
+        REQUIRE( ti[1] == 11 );
+        for (size_t i = 4; i < SIZE; ++i)
+        {
+            REQUIRE( ti[i-2] == 15-int(i)*int(i) );
+        }
+        }
+    }
+}
+
+
 TEST_CASE( "FSTArray push_back" )
 {
     const size_t SIZE = size_t(10);
@@ -1714,6 +2161,36 @@ TEST_CASE( "FSTArray push_back" )
         REQUIRE( ti.end() == ti.begin() + SIZE2 );
         }
     }
+
+
+    SUBCASE( "push_back & insert of own item, reallocating" )
+    {
+        FSTArray<string> ts(16);   // size == capacity
+        for (size_t i = 0; i < ts.size(); ++i)
+        {
+            ts[i] = string(30, char('a'+i));
+        }
+        ts.push_back(ts[3]);
+        {
+        INFO( "push_back own item - check value" );
+        REQUIRE( ts.size() == 17 );
+        REQUIRE( ts[16] == string(30, 'd') );
+        }
+
+        FSTArray<string> ts2(16);
+        for (size_t i = 0; i < ts2.size(); ++i)
+        {
+            ts2[i] = string(30, char('a'+i));
+        }
+        ts2.insert(ts2.begin(), ts2[15]);
+        {
+        INFO( "insert own item - check values" );
+        REQUIRE( ts2.size() == 17 );
+        REQUIRE( ts2[0] == string(30, 'p') );
+        REQUIRE( ts2[1] == string(30, 'a') );
+        REQUIRE( ts2[16] == string(30, 'p') );
+        }
+    }
 }
 
 
@@ -2415,6 +2892,2200 @@ TEST_CASE( "FSTArray exceptions" )
 }
 
 
+TEST_CASE( "FSTSlotMap insert, erase, handles" )
+{
+    SUBCASE( "Handles survive erase of other items" )
+    {
+        FSTSlotMap<int> sm;
+        vector<FSTSlotMap<int>::Handle> hs;
+        for (int i = 0; i < 100; ++i)
+            hs.push_back(sm.insert(i*i));
+
+        {
+        INFO( "Slot map - size after inserts" );
+        REQUIRE( sm.size() == size_t(100) );
+        }
+
+        // Erase every third item
+        for (size_t i = 0; i < hs.size(); i += 3)
+            sm.erase(hs[i]);
+
+        {
+        INFO( "Slot map - size after erases" );
+        REQUIRE( sm.size() == size_t(100-34) );
+        }
+        {
+        INFO( "Slot map - remaining handles still find their items" );
+        for (size_t i = 0; i < hs.size(); ++i)
+        {
+            if (i % 3 == 0)
+            {
+                REQUIRE_FALSE( sm.contains(hs[i]) );
+            }
+            else
+            {
+                REQUIRE( sm.contains(hs[i]) );
+                REQUIRE( sm[hs[i]] == int(i*i) );
+            }
+        }
+        }
+        {
+        INFO( "Slot map - dense range holds exactly the live items" );
+        long long sum = 0;
+        for (auto it = sm.begin(); it != sm.end(); ++it)
+            sum += *it;
+        long long expected = 0;
+        for (size_t i = 0; i < hs.size(); ++i)
+        {
+            if (i % 3 != 0)
+                expected += (long long)(i*i);
+        }
+        REQUIRE( sum == expected );
+        }
+        {
+        INFO( "Slot map - handleAt agrees with dense order" );
+        for (size_t d = 0; d < sm.size(); ++d)
+        {
+            REQUIRE( &sm[sm.handleAt(d)] == sm.begin() + d );
+        }
+        }
+    }
+
+    SUBCASE( "Reused slot does not revive old handle" )
+    {
+        FSTSlotMap<int> sm;
+        auto h1 = sm.insert(1);
+        sm.erase(h1);
+        auto h2 = sm.insert(2);
+
+        {
+        INFO( "Slot map - slot is reused with a new generation" );
+        REQUIRE( h2.index == h1.index );
+        REQUIRE( h2 != h1 );
+        REQUIRE_FALSE( sm.contains(h1) );
+        REQUIRE( sm[h2] == 2 );
+        }
+
+        bool throws_proper_type;
+        try
+        {
+            sm.erase(h1);
+            throws_proper_type = false;
+        }
+        catch (std::out_of_range & e)
+        {
+            throws_proper_type = true;
+        }
+        catch (...)
+        {
+            throws_proper_type = false;
+        }
+        {
+        INFO( "Slot map - erase with stale handle throws std::out_of_range" );
+        REQUIRE( throws_proper_type );
+        REQUIRE( sm.size() == size_t(1) );
+        }
+    }
+
+    SUBCASE( "Handle from another map" )
+    {
+        FSTSlotMap<int> sa;
+        auto ha = sa.insert(1);
+        sa.erase(ha);
+        ha = sa.insert(2);      // Slot 0, generation 1
+
+        FSTSlotMap<int> sb;
+        auto hb = sb.insert(3);
+        sb.erase(hb);           // Slot 0 free, generation 1
+
+        {
+        INFO( "Slot map - free slot with matching generation is not live" );
+        REQUIRE( ha.index == hb.index );
+        REQUIRE( ha.generation == hb.generation + 1 );
+        REQUIRE_FALSE( sb.contains(ha) );
+        }
+
+        bool throws_proper_type;
+        try
+        {
+            sb.erase(ha);
+            throws_proper_type = false;
+        }
+        catch (std::out_of_range & e)
+        {
+            throws_proper_type = true;
+        }
+        catch (...)
+        {
+            throws_proper_type = false;
+        }
+        {
+        INFO( "Slot map - erase with foreign handle throws; size unchanged" );
+        REQUIRE( throws_proper_type );
+        REQUIRE( sb.size() == size_t(0) );
+        REQUIRE( sb.empty() );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTBufferCache take, give, limits, flush" )
+{
+    SUBCASE( "Buffers are reused by capacity class" )
+    {
+        FSTBufferCache<int> cache;
+
+        {
+        INFO( "Buffer cache - roundCapacity" );
+        REQUIRE( FSTBufferCache<int>::roundCapacity(0) == size_t(0) );
+        REQUIRE( FSTBufferCache<int>::roundCapacity(16) == size_t(16) );
+        REQUIRE( FSTBufferCache<int>::roundCapacity(17) == size_t(32) );
+        }
+        {
+        INFO( "Buffer cache - no power of two above the largest: unrounded" );
+        const size_t TOP = size_t(1) << (8*sizeof(size_t) - 1);
+        REQUIRE( FSTBufferCache<int>::roundCapacity(TOP) == TOP );
+        REQUIRE( FSTBufferCache<int>::roundCapacity(TOP+1) == TOP+1 );
+        REQUIRE( FSTBufferCache<int>::roundCapacity(size_t(-1))
+                 == size_t(-1) );
+        REQUIRE( cache.take(TOP+1) == nullptr );
+        int dummy;
+        REQUIRE_FALSE( cache.give(&dummy, TOP+1) );
+        }
+
+        int * a = new int[32];
+        int * b = new int[64];
+        {
+        INFO( "Buffer cache - empty cache hands out nothing" );
+        REQUIRE( cache.take(32) == nullptr );
+        }
+        REQUIRE( cache.give(a, 32) );
+        REQUIRE( cache.give(b, 64) );
+        {
+        INFO( "Buffer cache - byte count" );
+        REQUIRE( cache.cachedBytes() == 96*sizeof(int) );
+        }
+        {
+        INFO( "Buffer cache - take returns buffer of matching class" );
+        REQUIRE( cache.take(16) == nullptr );
+        REQUIRE( cache.take(64) == b );
+        REQUIRE( cache.take(32) == a );
+        REQUIRE( cache.take(32) == nullptr );
+        REQUIRE( cache.cachedBytes() == size_t(0) );
+        }
+        delete [] a;
+        delete [] b;
+    }
+
+    SUBCASE( "Limits & flush" )
+    {
+        FSTBufferCache<int> cache;
+        cache.setLimits(1, 1000);
+
+        int * a = new int[16];
+        int * b = new int[16];
+        int * c = new int[1024];
+        {
+        INFO( "Buffer cache - per-class & byte limits refuse buffers" );
+        REQUIRE( cache.give(a, 16) );
+        REQUIRE_FALSE( cache.give(b, 16) );
+        REQUIRE_FALSE( cache.give(c, 1024) );
+        }
+        delete [] b;
+        delete [] c;
+
+        cache.flush();
+        {
+        INFO( "Buffer cache - flush empties cache" );
+        REQUIRE( cache.cachedBytes() == size_t(0) );
+        REQUIRE( cache.take(16) == nullptr );
+        }
+
+        cache.setEnabled(false);
+        int * d = new int[16];
+        {
+        INFO( "Buffer cache - disabled cache refuses buffers" );
+        REQUIRE_FALSE( cache.give(d, 16) );
+        }
+        delete [] d;
+    }
+}
+
+// struct CacheTeardownProbe
+// Thread-local object made before its thread's FSTBufferCache<int>, so
+//  destroyed after it; records what localIfAlive then returns.
+struct CacheTeardownProbe {
+    std::atomic<int> * result = nullptr;
+
+    ~CacheTeardownProbe()
+    {
+        if (result != nullptr)
+            *result = FSTBufferCache<int>::localIfAlive() == nullptr ? 1
+                                                                    : 2;
+    }
+};
+
+
+TEST_CASE( "FSTBufferCache teardown" )
+{
+    std::atomic<int> result(0);
+    bool aliveDuring = false;
+    std::thread t([&]()
+    {
+        thread_local CacheTeardownProbe probe;
+        probe.result = &result;
+        aliveDuring = FSTBufferCache<int>::localIfAlive()
+                   == &FSTBufferCache<int>::local();
+    });
+    t.join();
+    {
+    INFO( "localIfAlive - the cache while the thread runs" );
+    REQUIRE( aliveDuring );
+    }
+    {
+    INFO( "localIfAlive - nullptr after the cache is destroyed" );
+    REQUIRE( result == 1 );
+    }
+}
+
+
+TEST_CASE( "FSTAsyncArray background growth" )
+{
+    SUBCASE( "Many push_back calls, with background growth" )
+    {
+        const size_t SIZE = size_t(200000);
+        FSTAsyncArray<int> ta;
+        ta.setMinAsyncSize(64);
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            ta.push_back(int(i));
+            if (i % 9999 == 0)
+            {
+                ta.pop_back();
+                ta.push_back(int(i));
+            }
+        }
+
+        {
+        INFO( "Async array - size & capacity" );
+        REQUIRE( ta.size() == SIZE );
+        REQUIRE( ta.capacity() > SIZE );
+        }
+        {
+        INFO( "Async array - check values (const access)" );
+        const FSTAsyncArray<int> & ctaref = ta;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            REQUIRE( ctaref[i] == int(i) );
+        }
+        }
+    }
+
+    SUBCASE( "Other operations wait for background growth" )
+    {
+        FSTAsyncArray<int> ta;
+        ta.setMinAsyncSize(64);
+        for (int i = 0; i < 1000; ++i)
+            ta.push_back(i);
+        ta.insert(ta.begin(), -1);
+        ta[1] = 100;
+        ta.erase(ta.end()-1);
+        FSTAsyncArray<int> tb(std::move(ta));
+        FSTAsyncArray<int> tc(tb);
+
+        {
+        INFO( "Async array - insert, bracket, erase, move, copy" );
+        REQUIRE( tc.size() == size_t(1000) );
+        REQUIRE( tc[0] == -1 );
+        REQUIRE( tc[1] == 100 );
+        for (size_t i = 2; i < tc.size(); ++i)
+        {
+            REQUIRE( tc[i] == int(i)-1 );
+        }
+        }
+    }
+
+    SUBCASE( "pop_back below the items being copied" )
+    {
+        FSTAsyncArray<int> ta;
+        ta.setMinAsyncSize(4);
+        for (int i = 0; i < 12; ++i)
+            ta.push_back(i);
+        for (int i = 0; i < 5; ++i)
+            ta.pop_back();
+
+        {
+        INFO( "Async array - pop_back during growth, then bracket" );
+        REQUIRE( ta[0] == 0 );
+        REQUIRE( ta.size() == size_t(7) );
+        for (size_t i = 0; i < ta.size(); ++i)
+        {
+            REQUIRE( ta[i] == int(i) );
+        }
+        }
+    }
+}
+
+
+// makeSquaresTable
+// Build, at compile time if asked, an FSTFixedArray of the squares of
+//  0 .. 9, using push_back, insert & erase.
+constexpr FSTFixedArray<int, 16> makeSquaresTable()
+{
+    FSTFixedArray<int, 16> t;
+    for (int i = 1; i < 10; ++i)
+        t.push_back(i*i);
+    t.insert(t.begin(), -1);
+    t[0] = 0;
+    t.push_back(-1);
+    t.erase(t.end()-1);
+    return t;
+}
+
+
+TEST_CASE( "FSTFixedArray" )
+{
+    SUBCASE( "Built at compile time" )
+    {
+        constexpr auto table = makeSquaresTable();
+        static_assert(table.size() == 10, "compile-time table size");
+        static_assert(table[0] == 0 && table[9] == 81,
+                      "compile-time table values");
+
+        {
+        INFO( "Fixed array - compile-time table values" );
+        for (size_t i = 0; i < table.size(); ++i)
+        {
+            REQUIRE( table[i] == int(i*i) );
+        }
+        }
+    }
+
+    SUBCASE( "Capacity limit" )
+    {
+        FSTFixedArray<int, 4> tf(3);
+        tf.push_back(7);
+        bool throws_proper_type;
+        try
+        {
+            tf.push_back(8);
+            throws_proper_type = false;
+        }
+        catch (std::length_error & e)
+        {
+            throws_proper_type = true;
+        }
+        catch (...)
+        {
+            throws_proper_type = false;
+        }
+
+        {
+        INFO( "Fixed array - push_back past capacity throws std::length_error" );
+        REQUIRE( throws_proper_type );
+        REQUIRE( tf.size() == size_t(4) );
+        REQUIRE( tf[3] == 7 );
+        }
+
+        try
+        {
+            tf.resize(5);
+            throws_proper_type = false;
+        }
+        catch (std::length_error & e)
+        {
+            throws_proper_type = true;
+        }
+        catch (...)
+        {
+            throws_proper_type = false;
+        }
+        {
+        INFO( "Fixed array - resize past capacity throws std::length_error" );
+        REQUIRE( throws_proper_type );
+        REQUIRE( tf.size() == size_t(4) );
+        }
+    }
+
+    SUBCASE( "insert & erase keep order" )
+    {
+        FSTFixedArray<string, 8> tf;
+        tf.push_back("b");
+        tf.push_back("d");
+        tf.insert(tf.begin(), "a");
+        tf.insert(tf.begin()+2, "c");
+        tf.insert(tf.end(), tf[0]);
+        tf.erase(tf.begin()+1);
+
+        {
+        INFO( "Fixed array - insert & erase values" );
+        REQUIRE( tf.size() == size_t(4) );
+        REQUIRE( tf[0] == "a" );
+        REQUIRE( tf[1] == "c" );
+        REQUIRE( tf[2] == "d" );
+        REQUIRE( tf[3] == "a" );
+        }
+    }
+}
+
+
+// constexprOpsResult
+// Exercise FSTArray during constant evaluation: push_back (with
+//  reallocation), insert, erase, resize, swap, copy, move, iterators.
+//  Return a checksum of the final contents.
+constexpr long long constexprOpsResult()
+{
+    FSTArray<int> a;
+    for (int i = 0; i < 40; ++i)
+        a.push_back(i);
+    a.insert(a.begin(), -5);
+    a.erase(a.begin()+10);
+    a.resize(30);
+    a.pop_back();
+
+    FSTArray<int> b(3);
+    b[0] = 100;
+    b[1] = 200;
+    b[2] = 300;
+    a.swap(b);
+    FSTArray<int> c(b);
+    FSTArray<int> d(std::move(a));
+
+    long long sum = 0;
+    for (auto it = c.begin(); it != c.end(); ++it)
+        sum += *it;
+    for (auto x : d)
+        sum += 1000 * x;
+    return sum + 1000000 * (long long)(c.size());
+}
+
+
+// constexprPrimes
+// Primes below N, by a sieve using FSTArray at compile time, copied
+//  out to an FSTFixedArray.
+template <size_t N>
+constexpr FSTFixedArray<int, N> constexprPrimes()
+{
+    FSTArray<bool> composite(N);
+    for (size_t i = 0; i < N; ++i)
+        composite[i] = false;
+    FSTFixedArray<int, N> primes;
+    for (size_t i = 2; i < N; ++i)
+    {
+        if (composite[i])
+            continue;
+        primes.push_back(int(i));
+        for (size_t j = i*i; j < N; j += i)
+            composite[j] = true;
+    }
+    return primes;
+}
+
+
+TEST_CASE( "FSTArray constexpr" )
+{
+    SUBCASE( "Operations in constant evaluation" )
+    {
+        constexpr long long result = constexprOpsResult();
+        static_assert(result == constexprOpsResult(),
+                      "constexpr FSTArray operations");
+
+        {
+        INFO( "constexpr - compile-time result matches run-time result" );
+        long long (* volatile runtimeFunc)() = constexprOpsResult;
+        REQUIRE( result == runtimeFunc() );
+        }
+    }
+
+    SUBCASE( "Compile-time table" )
+    {
+        constexpr auto primes = constexprPrimes<100>();
+        static_assert(primes.size() == 25, "25 primes below 100");
+        static_assert(primes[0] == 2 && primes[24] == 97,
+                      "first & last primes below 100");
+
+        {
+        INFO( "constexpr - table of primes" );
+        REQUIRE( primes[4] == 11 );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTHistogram & FSTArray traces" )
+{
+    SUBCASE( "Histogram percentiles" )
+    {
+        FSTHistogram h;
+        {
+        INFO( "Empty histogram" );
+        REQUIRE( h.count() == 0 );
+        REQUIRE( h.percentile(50.0) == 0 );
+        }
+
+        for (unsigned long long v = 1; v <= 1000; ++v)
+            h.record(v);
+        h.record(1000000);
+        {
+        INFO( "Histogram - count, min, max" );
+        REQUIRE( h.count() == 1001 );
+        REQUIRE( h.min() == 1 );
+        REQUIRE( h.max() == 1000000 );
+        }
+        {
+        INFO( "Histogram - values below 128 exact" );
+        REQUIRE( h.percentile(5.0) == 50 );
+        }
+        {
+        INFO( "Histogram - larger values within 1/64" );
+        auto p50 = h.percentile(50.0);
+        auto p99 = h.percentile(99.0);
+        REQUIRE( p50 >= 501 );
+        REQUIRE( p50 <= 501 + 501/64 );
+        REQUIRE( p99 >= 991 );
+        REQUIRE( p99 <= 991 + 991/64 );
+        }
+        {
+        INFO( "Histogram - p100 is max" );
+        REQUIRE( h.percentile(100.0) == 1000000 );
+        }
+
+        FSTHistogram h2;
+        h2.record(5, 3);
+        h.merge(h2);
+        {
+        INFO( "Histogram - merge" );
+        REQUIRE( h.count() == 1004 );
+        REQUIRE( h.min() == 1 );
+        }
+    }
+
+    SUBCASE( "Record & replay" )
+    {
+        FSTArray<int> live(0);
+        FSTTraceRecorder<int> rec(live);
+        for (int i = 0; i < 20; ++i)
+            rec.push_back(i);
+        rec.insert(live.begin()+5, 100);
+        rec.erase(live.begin()+2);
+        rec.unordered_erase(live.begin());
+        rec.pop_back();
+        rec.resize(10);
+        {
+        INFO( "Recorder - trace length" );
+        REQUIRE( rec.trace().size() == 26 );
+        REQUIRE( rec.trace()[0].op == FSTOp::CONSTRUCT );
+        REQUIRE( rec.trace()[21].op == FSTOp::INSERT );
+        REQUIRE( rec.trace()[21].arg == 5 );
+        REQUIRE( rec.trace()[21].time >= rec.trace()[20].time );
+        }
+
+        FSTTrace trace = rec.takeTrace();
+        FSTArray<int> copy(7);   // CONSTRUCT event replaces it
+        for (size_t i = 0; i < trace.size(); ++i)
+        {
+            int item = (i <= 20) ? int(i)-1 : 100;
+            fstApply(copy, trace[i], item, i);
+        }
+        {
+        INFO( "Replay - same result as live array" );
+        REQUIRE( copy.size() == live.size() );
+        REQUIRE( equal(live.begin(), live.end(), copy.begin()) );
+        }
+        {
+        INFO( "Recorder - new trace starts from current size" );
+        REQUIRE( rec.trace().size() == 1 );
+        REQUIRE( rec.trace()[0].op == FSTOp::CONSTRUCT );
+        REQUIRE( rec.trace()[0].arg == live.size() );
+        }
+    }
+
+    SUBCASE( "Replay rejects events invalid for the array" )
+    {
+        FSTTrace t(0);
+        t.push_back(FSTTraceEvent{ FSTOp::CONSTRUCT, 3 });
+        t.push_back(FSTTraceEvent{ FSTOp::INSERT, 3 });
+        t.push_back(FSTTraceEvent{ FSTOp::ERASE, 4 });
+        FSTArray<int> a(0);
+        size_t failedAt = 0;
+        string message;
+        try
+        {
+            for (size_t i = 0; i < t.size(); ++i)
+            {
+                failedAt = i;
+                fstApply(a, t[i], 1, i);
+            }
+        }
+        catch (std::runtime_error & e)
+        {
+            message = e.what();
+        }
+        {
+        INFO( "Replay - bad position throws, naming the event" );
+        REQUIRE( failedAt == 2 );
+        REQUIRE( message.find("event 2") != string::npos );
+        REQUIRE( a.size() == 4 );
+        }
+
+        FSTArray<int> empty(0);
+        bool threw = false;
+        try
+        {
+            fstApply(empty, FSTTraceEvent{ FSTOp::POP_BACK, 0 }, 1, 0);
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "Replay - pop_back on empty array throws" );
+        REQUIRE( threw );
+        REQUIRE( empty.size() == 0 );
+        }
+
+        threw = false;
+        try
+        {
+            fstApply(empty, FSTTraceEvent{ FSTOp::RESIZE, size_t(-1) }, 1,
+                     0);
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "Replay - huge resize throws" );
+        REQUIRE( threw );
+        }
+    }
+
+    SUBCASE( "Binary trace file round trip" )
+    {
+        FSTTrace t(0);
+        t.push_back(FSTTraceEvent{ FSTOp::CONSTRUCT, 3, 0 });
+        t.push_back(FSTTraceEvent{ FSTOp::INSERT, 300, 1000 });
+        t.push_back(FSTTraceEvent{ FSTOp::RESIZE, size_t(1) << 40,
+                                   5000000000ULL });
+        std::stringstream ss;
+        fstWriteTrace(ss, t);
+        FSTTrace u = fstReadTrace(ss);
+        {
+        INFO( "Trace file - events read back" );
+        REQUIRE( u.size() == 3 );
+        REQUIRE( u[1].op == FSTOp::INSERT );
+        REQUIRE( u[1].arg == 300 );
+        REQUIRE( u[1].time == 1000 );
+        REQUIRE( u[2].arg == size_t(1) << 40 );
+        REQUIRE( u[2].time == 5000000000ULL );
+        }
+
+        std::stringstream bad("FSTT\x01\x05");
+        bool threw = false;
+        try
+        {
+            FSTTrace v = fstReadTrace(bad);
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "Trace file - truncated file throws" );
+        REQUIRE( threw );
+        }
+    }
+
+    SUBCASE( "Synthetic workloads replay to expected size" )
+    {
+        FSTArray<int> a(0);
+        FSTTrace t = fstRandomEraseTrace(300, 7);
+        for (size_t i = 0; i < t.size(); ++i)
+            fstApply(a, t[i], 1, i);
+        {
+        INFO( "Random-erase workload ends empty" );
+        REQUIRE( t.size() == 600 );
+        REQUIRE( a.size() == 0 );
+        }
+
+        FSTTrace f = fstFifoTrace(50, 10);
+        for (size_t i = 0; i < f.size(); ++i)
+            fstApply(a, f[i], 1, i);
+        {
+        INFO( "FIFO workload keeps window" );
+        REQUIRE( a.size() == 10 );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTPackedArray & FSTBitArray" )
+{
+    SUBCASE( "Bit array - proxy reference, count, find" )
+    {
+        FSTBitArray b(200);
+        {
+        INFO( "Bit array - ctor from size gives all false" );
+        REQUIRE( b.size() == 200 );
+        REQUIRE( b.popcount() == 0 );
+        REQUIRE( b.bytes() >= 200/8 );
+        REQUIRE( b.bytes() < 200 );
+        }
+
+        for (size_t i = 0; i < b.size(); i += 3)
+            b[i] = true;
+        b[199] = b[0];
+        {
+        INFO( "Bit array - set through proxy" );
+        REQUIRE( b[3] );
+        REQUIRE( !b[4] );
+        REQUIRE( b[199] );
+        REQUIRE( b.popcount() == 68 );
+        REQUIRE( b.count(true) == 68 );
+        REQUIRE( b.count(false) == 132 );
+        }
+        {
+        INFO( "Bit array - find" );
+        REQUIRE( b.find(true, 1) == 3 );
+        REQUIRE( b.find(false) == 1 );
+        REQUIRE( b.find(true, 199) == 199 );
+        b[199] = false;
+        REQUIRE( b.find(true, 199) == 200 );
+        }
+    }
+
+    SUBCASE( "Packed array - same behavior as FSTArray<unsigned>" )
+    {
+        // Each width against an unpacked model, through inserts & erases
+        //  that cross word boundaries
+        auto check = [](auto a, unsigned maxVal)
+        {
+            FSTArray<unsigned> model(0);
+            unsigned long long x = 12345;
+            for (int op = 0; op < 3000; ++op)
+            {
+                x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+                unsigned v = unsigned(x >> 33) % (maxVal + 1);
+                size_t pos = model.size() == 0
+                           ? 0 : size_t(x >> 20) % model.size();
+                switch ((x >> 60) % 5)
+                {
+                case 0:
+                case 1:
+                    a.insert(a.begin() + pos, v);
+                    model.insert(model.begin() + pos, v);
+                    break;
+                case 2:
+                    a.push_back(v);
+                    model.push_back(v);
+                    break;
+                case 3:
+                    if (model.size() != 0)
+                    {
+                        a.erase(a.begin() + pos);
+                        model.erase(model.begin() + pos);
+                    }
+                    break;
+                default:
+                    a.resize(pos);
+                    model.resize(pos);
+                    break;
+                }
+                if (a.size() != model.size())
+                    return false;
+            }
+            a.resize(a.size() + 70);
+            model.resize(model.size() + 70);
+            for (size_t i = model.size() - 70; i < model.size(); ++i)
+                model[i] = 0;
+            size_t zeros = 0;
+            for (size_t i = 0; i < model.size(); ++i)
+            {
+                if (unsigned(a[i]) != model[i])
+                    return false;
+                zeros += (model[i] == 0);
+            }
+            FSTArray<unsigned> out(model.size());
+            a.unpack(0, a.size(), &out[0]);
+            return a.count(0) == zeros
+                && a.find(0) == size_t(std::find(model.begin(), model.end(),
+                                                 0u) - model.begin())
+                && equal(out.begin(), out.end(), model.begin());
+        };
+
+        {
+        INFO( "Packed array - 1 bit" );
+        REQUIRE( check(FSTPackedArray<1>(), 1) );
+        }
+        {
+        INFO( "Packed array - 3 bits (unused top bit in each word)" );
+        REQUIRE( check(FSTPackedArray<3>(), 7) );
+        }
+        {
+        INFO( "Packed array - 4 bits" );
+        REQUIRE( check(FSTPackedArray<4>(), 15) );
+        }
+        {
+        INFO( "Packed array - 7 bits" );
+        REQUIRE( check(FSTPackedArray<7>(), 127) );
+        }
+        {
+        INFO( "Packed array - 32 bits" );
+        REQUIRE( check(FSTPackedArray<32>(), 4000000000u) );
+        }
+    }
+
+    SUBCASE( "Packed array - at, copy, swap" )
+    {
+        FSTPackedArray<5> a(10);
+        a[9] = 31;
+        a[8] = 33;  // Cut to 5 bits
+        FSTPackedArray<5> b(a);
+        FSTPackedArray<5> c;
+        c.swap(b);
+        {
+        INFO( "Packed array - values cut to width" );
+        REQUIRE( a[8] == 1 );
+        REQUIRE( a.at(9) == 31 );
+        }
+        {
+        INFO( "Packed array - copy & swap" );
+        REQUIRE( b.size() == 0 );
+        REQUIRE( c.size() == 10 );
+        REQUIRE( c[9] == 31 );
+        }
+        bool threw = false;
+        try
+        {
+            (void)a.at(10);
+        }
+        catch (std::out_of_range &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "Packed array - at out of range throws" );
+        REQUIRE( threw );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTFrozenArray freeze & thaw" )
+{
+    // makeArray
+    // Return array of n items from the given distribution.
+    auto makeArray = [](size_t n, int dist)
+    {
+        FSTArray<int> a(n);
+        unsigned long long x = 311;
+        long long sum = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+            int r = int(x >> 32);
+            switch (dist)
+            {
+            case 0:  a[i] = r; break;                         // Anything
+            case 1:  a[i] = int(unsigned(r) % 1000); break;   // Counters
+            case 2:  sum += unsigned(r) % 16;                 // Sorted IDs
+                     a[i] = int(sum); break;
+            case 3:  a[i] = (i % 2) ? 2147483647 : -2147483647-1;
+                     break;                                   // Extremes
+            default: a[i] = -5; break;                        // Constant
+            }
+        }
+        return a;
+    };
+
+    SUBCASE( "Every item read back, all distributions & sizes" )
+    {
+        bool ok = true;
+        for (int dist = 0; dist < 5; ++dist)
+        {
+            for (size_t n : { 0, 1, 2, 127, 128, 129, 1000 })
+            {
+                FSTArray<int> a = makeArray(n, dist);
+                FSTFrozenArray f(a);
+                FSTArray<int> t = f.thaw();
+                ok = ok && f.size() == n && t.size() == n
+                        && equal(a.begin(), a.end(), t.begin());
+                for (size_t i = 0; i < n; ++i)
+                    ok = ok && f[i] == a[i];
+                long long s1 = 0;
+                long long s2 = 0;
+                f.forEach([&](int v) { s1 += v; });
+                for (size_t i = 0; i < n; ++i)
+                    s2 += a[i];
+                ok = ok && s1 == s2;
+            }
+        }
+        {
+        INFO( "Frozen array - operator[], thaw, forEach match original" );
+        REQUIRE( ok );
+        }
+    }
+
+    SUBCASE( "Compression" )
+    {
+        FSTFrozenArray counters(makeArray(12800, 1));
+        FSTFrozenArray ids(makeArray(12800, 2));
+        FSTFrozenArray constant(makeArray(12800, 4));
+        FSTFrozenArray random(makeArray(12800, 0));
+        const size_t raw = 12800 * sizeof(int);
+        {
+        INFO( "Frozen array - values below 1000 take about 10 bits" );
+        REQUIRE( counters.bytes() < raw * 3 / 8 );
+        }
+        {
+        INFO( "Frozen array - sorted IDs pack by gap, not range" );
+        REQUIRE( ids.bytes() < raw / 3 );
+        }
+        {
+        INFO( "Frozen array - constant blocks take no packed words" );
+        REQUIRE( constant.bytes() < raw / 16 );
+        }
+        {
+        INFO( "Frozen array - random data costs only block headers" );
+        REQUIRE( random.bytes() < raw + raw / 16 );
+        }
+    }
+
+    SUBCASE( "at & empty" )
+    {
+        FSTFrozenArray e;
+        FSTFrozenArray f(makeArray(3, 1));
+        bool threw = false;
+        try
+        {
+            (void)f.at(3);
+        }
+        catch (std::out_of_range &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "Frozen array - empty & at" );
+        REQUIRE( e.empty() );
+        REQUIRE( e.thaw().size() == 0 );
+        REQUIRE( f.at(2) == f[2] );
+        REQUIRE( threw );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTArray sorting" )
+{
+    // Pseudorandom numbers, the same each run
+    unsigned long long x = 311;
+    auto next = [&]()
+    {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        return x >> 16;
+    };
+
+    SUBCASE( "Radix sort - ints, negative & duplicate" )
+    {
+        FSTArray<int> a(5000);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = int(next() % 2001) - 1000;
+        vector<int> v(a.begin(), a.end());
+        fstRadixSort(a);
+        std::sort(v.begin(), v.end());
+        {
+        INFO( "Radix sort - same as std::sort" );
+        REQUIRE( equal(a.begin(), a.end(), v.begin()) );
+        }
+    }
+
+    SUBCASE( "Radix sort - doubles" )
+    {
+        FSTArray<double> a(3000);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = (double(next() % 100000) - 50000.0) / 7.0;
+        a[0] = -1.0e300;
+        a[1] = 1.0e-300;
+        vector<double> v(a.begin(), a.end());
+        fstRadixSort(a);
+        std::sort(v.begin(), v.end());
+        {
+        INFO( "Radix sort - doubles, same as std::sort" );
+        REQUIRE( equal(a.begin(), a.end(), v.begin()) );
+        }
+    }
+
+    SUBCASE( "long double - no radix key, sorted with operator<" )
+    {
+        // Large enough for 2 threads in fstSort
+        FSTArray<long double> a(600000);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = (static_cast<long double>(next() % 100000) - 50000.0L)
+                 / 7.0L;
+        FSTArray<long double> b(a);
+        FSTArray<long double> c(a);
+        FSTArray<long double> d(a);
+        vector<long double> v(a.begin(), a.end());
+        std::sort(v.begin(), v.end());
+        fstRadixSort(a);
+        fstSort(b, 4);
+        const size_t k = 300000;
+        fstNthElement(c, k);
+        fstPartialSort(d, 1000);
+        {
+        INFO( "long double - fstRadixSort, fstSort, select, partial" );
+        REQUIRE( equal(a.begin(), a.end(), v.begin()) );
+        REQUIRE( equal(b.begin(), b.end(), v.begin()) );
+        REQUIRE( c[k] == v[k] );
+        REQUIRE( equal(d.begin(), d.begin() + 1000, v.begin()) );
+        }
+    }
+
+    SUBCASE( "Adaptive & parallel sort" )
+    {
+        // Large enough for 2 threads
+        FSTArray<long long> a(600000);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = (long long)(next()) - (1LL << 46);
+        FSTArray<long long> b(a);
+        vector<long long> v(a.begin(), a.end());
+        std::sort(v.begin(), v.end());
+        fstSort(a, 4);
+        fstParallelSort(b, std::less<long long>(), 4);
+        {
+        INFO( "fstSort - parallel radix runs, merged" );
+        REQUIRE( equal(a.begin(), a.end(), v.begin()) );
+        }
+        {
+        INFO( "fstParallelSort" );
+        REQUIRE( equal(b.begin(), b.end(), v.begin()) );
+        }
+
+        FSTArray<string> s(2000);
+        for (size_t i = 0; i < s.size(); ++i)
+            s[i] = std::to_string(next() % 500);
+        vector<string> w(s.begin(), s.end());
+        fstSort(s, std::greater<string>());
+        std::sort(w.begin(), w.end(), std::greater<string>());
+        {
+        INFO( "fstSort - strings, with comparison" );
+        REQUIRE( equal(s.begin(), s.end(), w.begin()) );
+        }
+    }
+
+    SUBCASE( "nth_element & partial sort" )
+    {
+        FSTArray<unsigned> a(200000);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = unsigned(next() % 100000);
+        FSTArray<unsigned> b(a);
+        vector<unsigned> v(a.begin(), a.end());
+        std::sort(v.begin(), v.end());
+
+        const size_t k = 123456;
+        fstNthElement(a, k);
+        bool ok = (a[k] == v[k]);
+        for (size_t i = 0; i < a.size(); ++i)
+            ok = ok && (i < k ? a[i] <= a[k] : a[i] >= a[k]);
+        {
+        INFO( "fstNthElement - radix select" );
+        REQUIRE( ok );
+        }
+
+        fstPartialSort(b, 1000);
+        {
+        INFO( "fstPartialSort - smallest items, in order" );
+        REQUIRE( equal(b.begin(), b.begin() + 1000, v.begin()) );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTArray loading from files" )
+{
+    const string path = (std::filesystem::temp_directory_path()
+                         / "fstarray_test_load.tmp").string();
+
+    // load
+    // Write text to the file, and append its ints to a. Return whether
+    //  fstReadInts threw.
+    auto load = [&](const string & text, FSTArray<int> & a)
+    {
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << text;
+        }
+        try
+        {
+            fstReadInts(a, path.c_str());
+        }
+        catch (std::runtime_error &)
+        {
+            return true;
+        }
+        return false;
+    };
+
+    SUBCASE( "Text - separators, signs, limits" )
+    {
+        FSTArray<int> a(1);
+        a[0] = 9;
+        bool threw = load("1 -2,3\t+4\r\n 2147483647\n-2147483648", a);
+        const int expect[] = { 9, 1, -2, 3, 4, 2147483647,
+                               -2147483647-1 };
+        {
+        INFO( "fstReadInts - appends parsed values" );
+        REQUIRE( !threw );
+        REQUIRE( a.size() == 7 );
+        REQUIRE( equal(a.begin(), a.end(), expect) );
+        }
+    }
+
+    SUBCASE( "Text - errors leave array as it was" )
+    {
+        FSTArray<int> a(2);
+        a[0] = 1;
+        a[1] = 2;
+        {
+        INFO( "fstReadInts - out of range" );
+        REQUIRE( load("5 2147483648", a) );
+        REQUIRE( a.size() == 2 );
+        }
+        {
+        INFO( "fstReadInts - bad character" );
+        REQUIRE( load("5 6x 7", a) );
+        REQUIRE( load("-", a) );
+        REQUIRE( a.size() == 2 );
+        REQUIRE( a[1] == 2 );
+        }
+        bool threw = false;
+        try
+        {
+            fstReadInts(a, "/nonexistent/fstarray_test_load");
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "fstReadInts - missing file" );
+        REQUIRE( threw );
+        }
+    }
+
+    SUBCASE( "Text - numbers across read blocks" )
+    {
+        // About 2 MB: numbers cross the 1 MB block boundary
+        string text;
+        FSTArray<int> expect(0);
+        for (int i = 0; i < 250000; ++i)
+        {
+            int v = (i * 7919) % 2000003 - 1000000;
+            expect.push_back(v);
+            text += std::to_string(v);
+            text += (i % 5 == 4) ? "\n" : " ";
+        }
+        FSTArray<int> a(0);
+        bool threw = load(text, a);
+        {
+        INFO( "fstReadInts - large file" );
+        REQUIRE( !threw );
+        REQUIRE( a.size() == expect.size() );
+        REQUIRE( equal(a.begin(), a.end(), expect.begin()) );
+        }
+    }
+
+    SUBCASE( "Binary - round trip, partial item" )
+    {
+        FSTArray<double> a(1000);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = double(i) / 3.0;
+        {
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char *>(&a[0]),
+                      std::streamsize(a.size() * sizeof(double)));
+        }
+        FSTArray<double> b(0);
+        size_t n = fstReadBinary(b, path.c_str());
+        {
+        INFO( "fstReadBinary - same items, capacity from file size" );
+        REQUIRE( n == 1000 );
+        REQUIRE( equal(a.begin(), a.end(), b.begin()) );
+        REQUIRE( b.capacity() < 1100 );
+        }
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::app);
+            out.put('x');
+        }
+        bool threw = false;
+        try
+        {
+            fstReadBinary(b, path.c_str());
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "fstReadBinary - partial item throws, array unchanged" );
+        REQUIRE( threw );
+        REQUIRE( b.size() == 1000 );
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+
+TEST_CASE( "FSTArray asynchronous save & load" )
+{
+    const string path = (std::filesystem::temp_directory_path()
+                         / "fstarray_test_async.tmp").string();
+
+    SUBCASE( "Round trip, several chunks" )
+    {
+        FSTIoOptions opts;
+        opts.chunkBytes = 4096;  // 10000 longs: 20 chunks
+        FSTArray<long> a(10000);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = long(i * i) - 5000;
+        auto saving = fstSaveAsync(std::move(a), path, opts);
+        {
+        INFO( "fstSaveAsync - array moved into the save" );
+        REQUIRE( a.size() == 0 );
+        }
+        a = saving.get();
+        {
+        INFO( "fstSaveAsync - array returned by the future" );
+        REQUIRE( a.size() == 10000 );
+        REQUIRE( a[9999] == 9999L * 9999L - 5000 );
+        REQUIRE( std::filesystem::file_size(path) == 10000 * sizeof(long) );
+        }
+        FSTArray<long> b = fstLoadAsync<long>(path, opts).get();
+        {
+        INFO( "fstLoadAsync - same items" );
+        REQUIRE( b.size() == a.size() );
+        REQUIRE( equal(a.begin(), a.end(), b.begin()) );
+        }
+        FSTArray<long> c = fstLoadAsync<long>(path).get();
+        FSTArray<long> d(0);
+        fstReadBinary(d, path.c_str());
+        {
+        INFO( "fstLoadAsync - one chunk; fstReadBinary reads the format" );
+        REQUIRE( equal(a.begin(), a.end(), c.begin()) );
+        REQUIRE( equal(a.begin(), a.end(), d.begin()) );
+        }
+    }
+
+    SUBCASE( "Direct I/O, odd size" )
+    {
+        FSTIoOptions opts;
+        opts.direct = true;
+        opts.chunkBytes = 8192;
+        FSTArray<char> a(20001);  // Not a multiple of the alignment
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = char('a' + i % 26);
+        FSTArray<char> saved = fstSaveAsync(FSTArray<char>(a), path,
+                                            opts).get();
+        FSTArray<char> b = fstLoadAsync<char>(path, opts).get();
+        {
+        INFO( "direct - exact size, same items" );
+        REQUIRE( std::filesystem::file_size(path) == 20001 );
+        REQUIRE( b.size() == 20001 );
+        REQUIRE( equal(a.begin(), a.end(), b.begin()) );
+        REQUIRE( equal(a.begin(), a.end(), saved.begin()) );
+        }
+    }
+
+    SUBCASE( "Empty array" )
+    {
+        FSTArray<int> a = fstSaveAsync(FSTArray<int>(0), path).get();
+        FSTArray<int> b = fstLoadAsync<int>(path).get();
+        {
+        INFO( "empty - empty file, empty array" );
+        REQUIRE( a.size() == 0 );
+        REQUIRE( std::filesystem::file_size(path) == 0 );
+        REQUIRE( b.size() == 0 );
+        }
+    }
+
+    SUBCASE( "Errors" )
+    {
+        FSTArray<int> a(3);
+        a[2] = 42;
+        auto saving = fstSaveAsync(std::move(a),
+                                   "/nonexistent/fstarray_test_async");
+        bool threw = false;
+        try
+        {
+            saving.get();
+        }
+        catch (FSTIoError<FSTArray<int>> & e)
+        {
+            threw = true;
+            a = std::move(e.array());
+        }
+        {
+        INFO( "fstSaveAsync - bad path throws FSTIoError, array kept" );
+        REQUIRE( threw );
+        REQUIRE( a.size() == 3 );
+        REQUIRE( a[2] == 42 );
+        }
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "12345";
+        }
+        threw = false;
+        try
+        {
+            fstLoadAsync<int>(path).get();
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "fstLoadAsync - partial item throws" );
+        REQUIRE( threw );
+        }
+        threw = false;
+        try
+        {
+            fstLoadAsync<int>("/nonexistent/fstarray_test_async").get();
+        }
+        catch (std::system_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "fstLoadAsync - missing file throws" );
+        REQUIRE( threw );
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+
+TEST_CASE( "FSTSharedArray shared memory" )
+{
+    SUBCASE( "Writer & reader mappings" )
+    {
+        auto w = FSTSharedArray<int>::createAnonymous(1000);
+        {
+        INFO( "createAnonymous - empty, writable" );
+        REQUIRE( w.size() == 0 );
+        REQUIRE( w.capacity() == 1000 );
+        REQUIRE( w.writable() );
+        REQUIRE( w.version() == 0 );
+        }
+        for (int i = 0; i < 10; ++i)
+            w.push_back(i * 3);
+        w.resize(12);
+        auto r = FSTSharedArray<int>::fromFd(::dup(w.fd()));
+        {
+        INFO( "fromFd - same items, another mapping" );
+        REQUIRE( !r.writable() );
+        REQUIRE( r.size() == 12 );
+        REQUIRE( r.begin() != w.begin() );
+        REQUIRE( r[9] == 27 );
+        REQUIRE( r[11] == 0 );
+        REQUIRE( r.version() == 22 );
+        }
+        w.write([](FSTSharedArray<int> & a)
+        {
+            a[0] = 100;
+            a.push_back(5);
+            a.pop_back();
+            a.push_back(7);
+        });
+        FSTArray<int> copy(0);
+        r.snapshot(copy);
+        long sum = r.read([](const int * first, const int * last)
+        {
+            long total = 0;
+            for (; first != last; ++first)
+                total += *first;
+            return total;
+        });
+        {
+        INFO( "write - one change, seen by readers" );
+        REQUIRE( r.version() == 24 );
+        REQUIRE( copy.size() == 13 );
+        REQUIRE( copy[0] == 100 );
+        REQUIRE( copy[12] == 7 );
+        REQUIRE( sum == 100 + 3 * 45 + 7 );
+        }
+        const int src[] = { 4, 5, 6 };
+        w.assign(src, src + 3);
+        {
+        INFO( "assign - replaces items" );
+        REQUIRE( r.size() == 3 );
+        REQUIRE( equal(r.begin(), r.end(), src) );
+        }
+        bool threwLength = false;
+        try
+        {
+            w.resize(1001);
+        }
+        catch (std::length_error &)
+        {
+            threwLength = true;
+        }
+        bool threwLogic = false;
+        try
+        {
+            r.push_back(1);
+        }
+        catch (std::logic_error &)
+        {
+            threwLogic = true;
+        }
+        {
+        INFO( "errors - past capacity, writing a reader" );
+        REQUIRE( threwLength );
+        REQUIRE( threwLogic );
+        REQUIRE( w.size() == 3 );
+        }
+    }
+
+    SUBCASE( "Named segment, another process" )
+    {
+        const string name = "/fstarray_test_" + std::to_string(::getpid());
+        auto w = FSTSharedArray<long>::create(name, 100000);
+        for (long i = 0; i < 100000; ++i)
+            w.push_back(i);
+        pid_t child = ::fork();
+        if (child == 0)
+        {
+            // Child: map by name, check the sum in place
+            int status = 1;
+            try
+            {
+                auto r = FSTSharedArray<long>::open(name);
+                long sum = r.read([](const long * first, const long * last)
+                {
+                    long total = 0;
+                    for (; first != last; ++first)
+                        total += *first;
+                    return total;
+                });
+                status = (sum == 99999L * 100000 / 2) ? 0 : 2;
+            }
+            catch (...)
+            {}
+            ::_exit(status);
+        }
+        int status = -1;
+        ::waitpid(child, &status, 0);
+        bool threw = false;
+        try
+        {
+            FSTSharedArray<int>::open(name);
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "open - other process reads items in place" );
+        REQUIRE( WIFEXITED(status) );
+        REQUIRE( WEXITSTATUS(status) == 0 );
+        }
+        {
+        INFO( "open - wrong item type throws" );
+        REQUIRE( threw );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTRcuArray read-copy-update" )
+{
+    SUBCASE( "Versions & reclamation" )
+    {
+        FSTArray<int> init(3);
+        init[0] = 1;
+        init[1] = 2;
+        init[2] = 3;
+        FSTRcuArray<int> rcu(init, 4);
+        auto r = rcu.reader();
+        const FSTArray<int> & v1 = r.view();
+        rcu.push_back(4);
+        rcu.insert(0, 0);
+        rcu.erase(2);
+        {
+        INFO( "update - old view unchanged, new view has changes" );
+        REQUIRE( v1.size() == 3 );
+        REQUIRE( v1[2] == 3 );
+        REQUIRE( rcu.current().size() == 4 );
+        REQUIRE( r.view().size() == 4 );
+        REQUIRE( r.view()[0] == 0 );
+        REQUIRE( r.view()[2] == 3 );
+        }
+        {
+        INFO( "update - versions kept until reader is quiescent" );
+        REQUIRE( rcu.retiredCount() == 3 );
+        }
+        r.quiescent();
+        rcu.resize(2);
+        {
+        INFO( "update - quiescent reader lets old versions go" );
+        REQUIRE( rcu.retiredCount() == 1 );
+        REQUIRE( r.view().size() == 2 );
+        }
+        r.offline();
+        rcu.update([](FSTArray<int> & a)
+        {
+            a.push_back(10);
+            a.push_back(11);
+        });
+        {
+        INFO( "update - offline reader holds nothing back" );
+        REQUIRE( rcu.retiredCount() == 0 );
+        REQUIRE( rcu.current().size() == 4 );
+        }
+        bool threw = false;
+        try
+        {
+            rcu.update([](FSTArray<int> & a)
+            {
+                a.push_back(99);
+                throw std::runtime_error("no");
+            });
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "update - throwing change is not published" );
+        REQUIRE( threw );
+        REQUIRE( rcu.current().size() == 4 );
+        }
+        auto r2 = rcu.reader();
+        auto r3 = rcu.reader();
+        auto r4 = rcu.reader();
+        threw = false;
+        try
+        {
+            auto r5 = rcu.reader();
+        }
+        catch (std::length_error &)
+        {
+            threw = true;
+        }
+        {
+        INFO( "reader - at most maxReaders" );
+        REQUIRE( threw );
+        }
+    }
+
+    SUBCASE( "Concurrent readers & writer" )
+    {
+        // Every version holds 0 .. size-1; readers check that
+        FSTArray<int> init(0);
+        FSTRcuArray<int> rcu(init);
+        std::atomic<bool> stop(false);
+        std::atomic<int> bad(0);
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+            readers.emplace_back([&]()
+            {
+                auto r = rcu.reader();
+                while (!stop.load())
+                {
+                    const FSTArray<int> & v = r.view();
+                    for (std::size_t i = 0; i < v.size(); ++i)
+                        if (v[i] != int(i))
+                            ++bad;
+                    r.quiescent();
+                }
+            });
+        for (int i = 0; i < 2000; ++i)
+        {
+            if (i % 7 == 6)
+                rcu.pop_back();
+            else
+                rcu.push_back(int(rcu.current().size()));
+        }
+        stop = true;
+        for (auto & th : readers)
+            th.join();
+        rcu.synchronize();
+        {
+        INFO( "concurrent - readers see only whole versions" );
+        REQUIRE( bad == 0 );
+        REQUIRE( rcu.retiredCount() == 0 );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTShardedArray accumulate & merge" )
+{
+    SUBCASE( "Small: concat & merge" )
+    {
+        FSTShardedArray<int> sh(3);
+        sh.push_back(0, 1);
+        sh.push_back(0, 5);
+        sh.push_back(2, 2);
+        sh.push_back(2, 5);
+        sh.push_back(2, 9);
+        const int cat[] = { 1, 5, 2, 5, 9 };
+        const int merged[] = { 1, 2, 5, 5, 9 };
+        FSTArray<int> c = sh.concat();
+        FSTArray<int> m = sh.mergeSorted();
+        {
+        INFO( "concat - shard order; mergeSorted - sorted" );
+        REQUIRE( sh.shardCount() == 3 );
+        REQUIRE( sh.size() == 5 );
+        REQUIRE( c.size() == 5 );
+        REQUIRE( equal(c.begin(), c.end(), cat) );
+        REQUIRE( m.size() == 5 );
+        REQUIRE( equal(m.begin(), m.end(), merged) );
+        }
+        bool threw = false;
+        try
+        {
+            sh.push_back(3, 0);
+        }
+        catch (std::out_of_range &)
+        {
+            threw = true;
+        }
+        sh.clear();
+        {
+        INFO( "push_back - bad shard throws; clear empties" );
+        REQUIRE( threw );
+        REQUIRE( sh.empty() );
+        REQUIRE( sh.concat().size() == 0 );
+        REQUIRE( sh.mergeSorted().size() == 0 );
+        }
+    }
+
+    SUBCASE( "Large: threads append, parallel merge" )
+    {
+        // 4 threads append sorted runs; result is compared with a sort
+        const std::size_t PER = 300000;
+        FSTShardedArray<long> sh(4);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 4; ++t)
+            threads.emplace_back([&, t]()
+            {
+                FSTArray<long> & mine = sh.shard(t);
+                for (std::size_t i = 0; i < PER * (t+1) / 2; ++i)
+                    mine.push_back(long(i * (t+2) % 1000003) / 3);
+                std::sort(mine.begin(), mine.end());
+            });
+        for (auto & th : threads)
+            th.join();
+        FSTArray<long> expect(0);
+        for (std::size_t t = 0; t < 4; ++t)
+            for (long v : sh.shard(t))
+                expect.push_back(v);
+        FSTArray<long> c = sh.concat(4);
+        std::sort(expect.begin(), expect.end());
+        FSTArray<long> m = sh.mergeSorted(std::less<long>(), 4);
+        {
+        INFO( "parallel - concat keeps shard order, merge sorts" );
+        REQUIRE( c.size() == sh.size() );
+        REQUIRE( equal(sh.shard(0).begin(), sh.shard(0).end(), c.begin()) );
+        REQUIRE( c[c.size()-1] == sh.shard(3)[sh.shard(3).size()-1] );
+        REQUIRE( m.size() == expect.size() );
+        REQUIRE( equal(m.begin(), m.end(), expect.begin()) );
+        }
+    }
+}
+
+
+TEST_CASE( "FSTArray gather & scatter" )
+{
+    // Array of 300K ints (several buckets), a[i] = 3*i + 1
+    const std::size_t N = 300000;
+    FSTArray<int> a(N);
+    for (std::size_t i = 0; i < N; ++i)
+        a[i] = int(3*i + 1);
+    FSTArray<int> idx(0);
+    for (std::size_t k = 0; k < 10007; ++k)
+        idx.push_back(int(k * 7919 % N));
+    idx.push_back(int(N-1));
+    idx.push_back(0);
+
+    const FSTIndexOrder orders[] = { FSTIndexOrder::given,
+        FSTIndexOrder::bucketed, FSTIndexOrder::sorted };
+    for (FSTIndexOrder order : orders)
+    {
+        FSTGatherOptions opts;
+        opts.order = order;
+        FSTArray<int> out(5);
+        fstGather(a, idx, out, opts);
+        bool same = out.size() == idx.size();
+        for (std::size_t k = 0; same && k < idx.size(); ++k)
+            same = out[k] == 3*idx[k] + 1;
+        {
+        INFO( "fstGather - out[k] == a[idx[k]], each order" );
+        REQUIRE( same );
+        }
+
+        // Scatter with a repeated index: last value wins
+        FSTArray<int> b(a);
+        FSTArray<std::size_t> sidx(0);
+        FSTArray<int> vals(0);
+        for (std::size_t k = 0; k < 5000; ++k)
+        {
+            sidx.push_back(k * 104729 % N);
+            vals.push_back(-int(k));
+        }
+        sidx.push_back(104729 % N);  // Repeats position 1
+        vals.push_back(-99);
+        fstScatter(b, sidx, vals, opts);
+        bool ok = b[104729 % N] == -99 && b[0] == 0;
+        for (std::size_t k = 2; ok && k < 5000; ++k)
+            ok = b[k * 104729 % N] == -int(k);
+        {
+        INFO( "fstScatter - values written, last repeat wins" );
+        REQUIRE( ok );
+        REQUIRE( b[5] == a[5] );
+        }
+    }
+
+    // Small array: in cache (AVX2 path, when built with AVX2)
+    FSTArray<int> small(1000);
+    for (std::size_t i = 0; i < small.size(); ++i)
+        small[i] = int(i) * 5;
+    FSTArray<int> sidx(0);
+    for (int k = 0; k < 1003; ++k)
+        sidx.push_back(k * 37 % 1000);
+    FSTArray<int> sout(0);
+    fstGather(small, sidx, sout);
+    bool same = sout.size() == sidx.size();
+    for (std::size_t k = 0; same && k < sidx.size(); ++k)
+        same = sout[k] == 5 * sidx[k];
+    {
+    INFO( "fstGather - small array" );
+    REQUIRE( same );
+    }
+
+    FSTArray<long> idx64(2);
+    idx64[0] = 4;
+    idx64[1] = long(N);
+    FSTArray<int> out(1);
+    out[0] = 42;
+    bool threw = false;
+    try
+    {
+        fstGather(a, idx64, out);
+    }
+    catch (std::out_of_range &)
+    {
+        threw = true;
+    }
+    {
+    INFO( "fstGather - bad index throws, out unchanged" );
+    REQUIRE( threw );
+    REQUIRE( out.size() == 1 );
+    REQUIRE( out[0] == 42 );
+    }
+    idx64[1] = -1;
+    threw = false;
+    try
+    {
+        fstScatter(a, idx64, out);
+    }
+    catch (std::out_of_range &)
+    {
+        threw = true;
+    }
+    {
+    INFO( "fstScatter - size mismatch or bad index throws" );
+    REQUIRE( threw );
+    REQUIRE( a[4] == 13 );
+    }
+}
+
+
+TEST_CASE( "FSTArray lazy arithmetic expressions" )
+{
+    const std::size_t N = 1000;
+    FSTArray<double> a(N);
+    FSTArray<double> b(N);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        a[i] = double(i);
+        b[i] = 0.5 * double(i) + 1.0;
+    }
+
+    // Three operands, with a scalar; destination keeps its buffer
+    FSTArray<double> c(N);
+    const double * buffer = &c[0];
+    c = a * 2.0 + b;
+    bool same = c.size() == N;
+    for (std::size_t i = 0; same && i < N; ++i)
+        same = c[i] == a[i] * 2.0 + b[i];
+    {
+    INFO( "c = a * 2 + b - computed in c's buffer" );
+    REQUIRE( same );
+    REQUIRE( &c[0] == buffer );
+    }
+
+    // Six operands, all operators, scalars on either side
+    FSTArray<double> d = (a - b) * (a + 1.0) / (2.0 + b) - -a / 4.0;
+    same = d.size() == N;
+    for (std::size_t i = 0; same && i < N; ++i)
+        same = d[i] == (a[i] - b[i]) * (a[i] + 1.0) / (2.0 + b[i])
+                       - -a[i] / 4.0;
+    {
+    INFO( "Construct from six-operand expression" );
+    REQUIRE( same );
+    }
+
+    // Element access without assigning; mixed item types
+    FSTArray<int> k(N);
+    for (std::size_t i = 0; i < N; ++i)
+        k[i] = int(i % 7);
+    auto e = k * 0.5 + a;
+    {
+    INFO( "Expression - size & items, int times double" );
+    REQUIRE( e.size() == N );
+    REQUIRE( e[9] == 2 * 0.5 + 9.0 );
+    }
+
+    // Destination as operand
+    FSTArray<double> x(a);
+    x = x * x - x;
+    same = true;
+    for (std::size_t i = 0; same && i < N; ++i)
+        same = x[i] == a[i] * a[i] - a[i];
+    {
+    INFO( "x = x * x - x - in place" );
+    REQUIRE( same );
+    }
+
+    // Resizing the destination: smaller, larger, empty
+    FSTArray<double> small(10);
+    small = a + b;
+    FSTArray<double> big(5 * N);
+    const double * bigBuffer = &big[0];
+    big = a - b;
+    {
+    INFO( "Destination resized; spare capacity reused" );
+    REQUIRE( small.size() == N );
+    REQUIRE( small[N-1] == a[N-1] + b[N-1] );
+    REQUIRE( big.size() == N );
+    REQUIRE( &big[0] == bigBuffer );
+    REQUIRE( big[3] == a[3] - b[3] );
+    }
+    FSTArray<double> none(0);
+    big = none * 3.0;
+    {
+    INFO( "Empty operands" );
+    REQUIRE( big.size() == 0 );
+    }
+
+    bool threw = false;
+    try
+    {
+        c = a + small * 2.0 + none;
+    }
+    catch (std::out_of_range &)
+    {
+        threw = true;
+    }
+    {
+    INFO( "Operand sizes differ - throws, destination unchanged" );
+    REQUIRE( threw );
+    REQUIRE( c.size() == N );
+    REQUIRE( c[7] == a[7] * 2.0 + b[7] );
+    }
+}
+
+
+// sumView
+// Return sum of items of v; takes arrays & views alike.
+int sumView(FSTArrayView<const int> v)
+{
+    int total = 0;
+    for (int x : v)
+        total += x;
+    return total;
+}
+
+
+TEST_CASE( "FSTArray views & slices" )
+{
+    FSTArray<int> a(100);
+    for (std::size_t i = 0; i < a.size(); ++i)
+        a[i] = int(i);
+
+    // Views of an array, & subviews
+    FSTArrayView v(a);
+    FSTArrayView<int> mid = v.subview(10, 20);
+    {
+    INFO( "View & subview - no copy" );
+    REQUIRE( v.size() == 100 );
+    REQUIRE( v.begin() == &a[0] );
+    REQUIRE( mid.size() == 20 );
+    REQUIRE( mid[0] == 10 );
+    REQUIRE( &mid[19] == &a[29] );
+    REQUIRE( v.first(3).size() == 3 );
+    REQUIRE( v.last(3)[0] == 97 );
+    REQUIRE( mid.subview(5, 0).empty() );
+    }
+    mid[1] = -11;
+    {
+    INFO( "Writes through a view reach the array" );
+    REQUIRE( a[11] == -11 );
+    }
+    a[11] = 11;
+
+    const FSTArray<int> & ca = a;
+    FSTArrayView cv(ca);
+    static_assert(std::is_same_v<decltype(cv), FSTArrayView<const int>>);
+    {
+    INFO( "Read-only views from arrays & views" );
+    REQUIRE( sumView(a) == 4950 );
+    REQUIRE( sumView(mid) == 390 );
+    REQUIRE( sumView(cv.subview(90, 10)) == 945 );
+    REQUIRE( sumView(FSTArrayView<int>()) == 0 );
+    }
+
+    // Strided views
+    FSTStridedView<int> evens = v.strided(2);
+    FSTStridedView<int> sixes = evens.strided(3);
+    FSTStridedView<const int> s = v.subview(1, 10).strided(3);
+    {
+    INFO( "Strided views" );
+    REQUIRE( evens.size() == 50 );
+    REQUIRE( evens[7] == 14 );
+    REQUIRE( sixes.size() == 17 );
+    REQUIRE( sixes[16] == 96 );
+    REQUIRE( s.size() == 4 );
+    REQUIRE( s[3] == 10 );
+    REQUIRE( std::distance(s.begin(), s.end()) == 4 );
+    REQUIRE( evens.subview(10, 5)[4] == 28 );
+    }
+    int total = 0;
+    for (int x : sixes)
+        total += x;
+    std::reverse(evens.begin(), evens.end());
+    {
+    INFO( "Strided iterators - loops & algorithms" );
+    REQUIRE( total == 6 * (16 * 17 / 2) );
+    REQUIRE( a[0] == 98 );
+    REQUIRE( a[1] == 1 );
+    REQUIRE( a[98] == 0 );
+    }
+    std::reverse(evens.begin(), evens.end());
+
+    FSTArray<int> copy = s.toArray();
+    {
+    INFO( "toArray copies the items" );
+    REQUIRE( copy.size() == 4 );
+    REQUIRE( copy[1] == 4 );
+    REQUIRE( v.subview(5, 3).toArray()[2] == 7 );
+    }
+
+    bool threw = false;
+    try
+    {
+        v.subview(90, 11);
+    }
+    catch (std::out_of_range &)
+    {
+        threw = true;
+    }
+    bool threwStride = false;
+    try
+    {
+        v.strided(0);
+    }
+    catch (std::invalid_argument &)
+    {
+        threwStride = true;
+    }
+    bool threwAt = false;
+    try
+    {
+        v.at(100);
+    }
+    catch (std::out_of_range &)
+    {
+        threwAt = true;
+    }
+    {
+    INFO( "Bad subview, stride & index throw" );
+    REQUIRE( threw );
+    REQUIRE( threwStride );
+    REQUIRE( threwAt );
+    }
+
+    // std::span
+    std::span<int> sp = mid;
+    FSTArrayView<const int> fromSpan(sp);
+    {
+    INFO( "std::span interop" );
+    REQUIRE( sp.data() == &a[10] );
+    REQUIRE( sp.size() == 20 );
+    REQUIRE( fromSpan.begin() == &a[10] );
+    REQUIRE( sumView(std::span<const int>(sp)) == 390 );
+    }
+
+    // Shared owning slices
+    FSTArray<int> b(a);
+    const int * bufferStart = &b[0];
+    FSTArraySlice<int> whole(std::move(b));
+    FSTArraySlice<int> part = whole.slice(40, 20);
+    FSTArraySlice<int> inner = part.slice(5, 5);
+    {
+    INFO( "Slices share one buffer" );
+    REQUIRE( b.size() == 0 );
+    REQUIRE( whole.begin() == bufferStart );
+    REQUIRE( part.begin() == bufferStart + 40 );
+    REQUIRE( inner[0] == 45 );
+    REQUIRE( inner.useCount() == 3 );
+    REQUIRE( sumView(inner) == 235 );
+    }
+    whole = FSTArraySlice<int>();
+    part = FSTArraySlice<int>();
+    threw = false;
+    try
+    {
+        inner.slice(3, 3);
+    }
+    catch (std::out_of_range &)
+    {
+        threw = true;
+    }
+    {
+    INFO( "Slice keeps buffer alive" );
+    REQUIRE( inner.useCount() == 1 );
+    REQUIRE( inner.view()[4] == 49 );
+    REQUIRE( inner.toArray()[1] == 46 );
+    REQUIRE( threw );
+    REQUIRE( whole.empty() );
+    REQUIRE( whole.useCount() == 0 );
+    }
+}
+
+
+TEST_CASE( "FSTArray comparison & hashing" )
+{
+    FSTArray<int> a(1000);
+    for (std::size_t i = 0; i < a.size(); ++i)
+        a[i] = int(i * 7);
+    FSTArray<int> b(a);
+    FSTArray<int> shorter(a);
+    shorter.resize(999);
+    {
+    INFO( "Equality - same items, differing item, differing size" );
+    REQUIRE( a == b );
+    REQUIRE( !(a != b) );
+    REQUIRE( a != shorter );
+    b[500] = -1;
+    REQUIRE( a != b );
+    REQUIRE( FSTArray<int>(0) == FSTArray<int>(0) );
+    }
+
+    // Order: lexicographic, then by size
+    {
+    INFO( "Ordering of int arrays" );
+    REQUIRE( b < a );
+    REQUIRE( a > b );
+    REQUIRE( shorter < a );
+    REQUIRE( shorter <= a );
+    REQUIRE( a >= a );
+    REQUIRE( (a <=> a) == 0 );
+    REQUIRE( (b <=> a) < 0 );
+    REQUIRE( FSTArray<int>(0) < shorter );
+    }
+
+    FSTArray<unsigned char> bytes(3);
+    bytes[0] = 1;
+    bytes[1] = 200;
+    bytes[2] = 3;
+    FSTArray<unsigned char> bytes2(bytes);
+    bytes2[1] = 7;
+    FSTArray<string> words(2);
+    words[0] = "apple";
+    words[1] = "pear";
+    FSTArray<string> words2(words);
+    words2[1] = "peach";
+    FSTArray<double> d(2);
+    d[0] = 1.0;
+    d[1] = 0.0;
+    FSTArray<double> d2(d);
+    d2[1] = -0.0;
+    {
+    INFO( "Other item types - memcmp order, <=>, floating point" );
+    REQUIRE( bytes2 < bytes );
+    REQUIRE( words2 < words );
+    REQUIRE( words == FSTArray<string>(words) );
+    REQUIRE( d == d2 );
+    }
+
+    // Hashing
+    std::hash<FSTArray<int>> h;
+    {
+    INFO( "Equal arrays hash alike" );
+    REQUIRE( h(a) == h(FSTArray<int>(a)) );
+    REQUIRE( std::hash<FSTArray<double>>()(d)
+             == std::hash<FSTArray<double>>()(d2) );
+    REQUIRE( std::hash<FSTArray<string>>()(words)
+             != std::hash<FSTArray<string>>()(words2) );
+    }
+
+    // Distinct small changes give distinct hashes: every length 0..300,
+    //  & every one-item change of a 300-item array
+    FSTArray<std::size_t> hashes(0);
+    FSTArray<int> grow(0);
+    for (int n = 0; n <= 300; ++n)
+    {
+        hashes.push_back(h(grow));
+        grow.push_back(0);
+    }
+    grow.resize(300);
+    for (std::size_t i = 0; i < grow.size(); ++i)
+    {
+        grow[i] = 1;
+        hashes.push_back(h(grow));
+        grow[i] = 0;
+    }
+    fstSort(hashes);
+    bool distinct = true;
+    for (std::size_t i = 1; i < hashes.size(); ++i)
+        distinct = distinct && hashes[i] != hashes[i-1];
+    {
+    INFO( "No collisions among lengths & one-item changes" );
+    REQUIRE( distinct );
+    }
+
+    // Swapping two 64-byte stripes changes the hash
+    FSTArray<int> striped(64);
+    for (std::size_t i = 0; i < striped.size(); ++i)
+        striped[i] = int(i / 16);
+    FSTArray<int> swapped(striped);
+    std::swap_ranges(&swapped[0], &swapped[0] + 16, &swapped[0] + 16);
+    {
+    INFO( "Stripe order matters; seeds differ" );
+    REQUIRE( h(striped) != h(swapped) );
+    REQUIRE( fstHash(striped, 1) != fstHash(striped, 2) );
+    REQUIRE( fstHashBytes("abc", 3) == fstHashBytes("abcd", 3) );
+    REQUIRE( fstHashBytes("abc", 3) != fstHashBytes("abd", 3) );
+    }
+
+    std::unordered_set<FSTArray<int>> seen;
+    seen.insert(a);
+    seen.insert(b);
+    seen.insert(FSTArray<int>(a));
+    {
+    INFO( "FSTArray as unordered_set key" );
+    REQUIRE( seen.size() == 2 );
+    REQUIRE( seen.count(shorter) == 0 );
+    }
+}
+
+
 // *********************************************************************
 // Main Program
 // *********************************************************************
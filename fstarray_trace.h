@@ -0,0 +1,535 @@
+// fstarray_trace.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Operation traces for FSTArray: recording, replay, binary trace
+//  files, and synthetic workloads
+
+#ifndef FILE_FSTARRAY_TRACE_H_INCLUDED
+#define FILE_FSTARRAY_TRACE_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::uint64_t
+#include <random>
+// For std::mt19937_64
+#include <chrono>
+// For std::chrono::steady_clock
+#include <istream>
+// For std::istream
+#include <ostream>
+// For std::ostream
+#include <stdexcept>
+// For std::runtime_error
+#include <string>
+// For std::string
+// For std::to_string
+
+
+// *********************************************************************
+// Trace events
+// *********************************************************************
+
+
+// enum class FSTOp
+// Modifying FSTArray operation kinds recorded in a trace.
+enum class FSTOp : unsigned char {
+    CONSTRUCT,        // arg: size; replaces the array with a new one
+    PUSH_BACK,
+    POP_BACK,
+    INSERT,           // arg: position
+    ERASE,            // arg: position
+    UNORDERED_ERASE,  // arg: position
+    RESIZE,           // arg: new size
+    COUNT             // Number of kinds; not an operation
+};
+
+
+// fstOpName
+// Return printable name of op.
+// No-Throw Guarantee
+inline const char * fstOpName(FSTOp op) noexcept
+{
+    switch (op)
+    {
+    case FSTOp::CONSTRUCT:       return "construct";
+    case FSTOp::PUSH_BACK:       return "push_back";
+    case FSTOp::POP_BACK:        return "pop_back";
+    case FSTOp::INSERT:          return "insert";
+    case FSTOp::ERASE:           return "erase";
+    case FSTOp::UNORDERED_ERASE: return "unordered_erase";
+    case FSTOp::RESIZE:          return "resize";
+    default:                     return "?";
+    }
+}
+
+
+// struct FSTTraceEvent
+// One operation in a trace. Positions are indices, so a trace replays
+//  on any array holding the same number of items.
+struct FSTTraceEvent {
+    FSTOp         op;
+    std::size_t   arg;       // Position or size; 0 if unused
+    std::uint64_t time = 0;  // ns since recording began; 0 if synthetic
+};
+
+// A trace is an array of events, in order
+using FSTTrace = FSTArray<FSTTraceEvent>;
+
+
+// fstCheckEvent
+// Throw std::runtime_error, naming event index, if e is not valid for
+//  an array of size size with items of itemSize bytes: a position past
+//  the end, pop_back on an empty array, or a size too large to
+//  allocate (whose capacity computation would overflow).
+// Strong Guarantee
+inline void fstCheckEvent(const FSTTraceEvent & e,
+                          std::size_t index,
+                          std::size_t size,
+                          std::size_t itemSize)
+{
+    const char * problem = nullptr;
+    switch (e.op)
+    {
+    case FSTOp::CONSTRUCT:
+    case FSTOp::RESIZE:
+        if (e.arg > std::size_t(-1) / 4 / itemSize)
+            problem = "size too large";
+        break;
+    case FSTOp::POP_BACK:
+        if (size == 0)
+            problem = "array is empty";
+        break;
+    case FSTOp::INSERT:
+        if (e.arg > size)
+            problem = "position past end";
+        break;
+    case FSTOp::ERASE:
+    case FSTOp::UNORDERED_ERASE:
+        if (e.arg >= size)
+            problem = "position past end";
+        break;
+    case FSTOp::PUSH_BACK:
+        break;
+    default:
+        problem = "bad operation";
+        break;
+    }
+    if (problem != nullptr)
+        throw std::runtime_error("FST trace: event "
+            + std::to_string(index) + " (" + fstOpName(e.op) + ", arg "
+            + std::to_string(e.arg) + ", array size "
+            + std::to_string(size) + "): " + problem);
+}
+
+
+// fstApply
+// Perform event e, at position index of its trace, on array a; item is
+//  the value for push_back & insert. Works on any type with the FSTArray
+//  interface.
+// Throws std::runtime_error, naming index, if e is not valid for a's
+//  current size (see fstCheckEvent); a is then unchanged. So a trace
+//  read from a file cannot write outside a.
+// Exception neutral
+template <typename Array>
+void fstApply(Array & a,
+              const FSTTraceEvent & e,
+              const typename Array::value_type & item,
+              std::size_t index)
+{
+    fstCheckEvent(e, index, a.size(), sizeof(typename Array::value_type));
+    switch (e.op)
+    {
+    case FSTOp::CONSTRUCT:
+        a = Array(e.arg);
+        break;
+    case FSTOp::PUSH_BACK:
+        a.push_back(item);
+        break;
+    case FSTOp::POP_BACK:
+        a.pop_back();
+        break;
+    case FSTOp::INSERT:
+        a.insert(a.begin() + e.arg, item);
+        break;
+    case FSTOp::ERASE:
+        a.erase(a.begin() + e.arg);
+        break;
+    case FSTOp::UNORDERED_ERASE:
+        a.unordered_erase(a.begin() + e.arg);
+        break;
+    case FSTOp::RESIZE:
+        a.resize(e.arg);
+        break;
+    default:
+        break;
+    }
+}
+
+
+// *********************************************************************
+// class FSTTraceRecorder - Class definition
+// *********************************************************************
+
+
+// class FSTTraceRecorder
+// Wrapper around a live FSTArray that performs modifying operations on
+//  it and appends each to a trace, with a timestamp. Use it in place of
+//  the array in code whose workload is to be captured; reads go to
+//  array(). The trace begins with a CONSTRUCT event giving the array's
+//  size when wrapped (or, after takeTrace, when the trace was taken),
+//  so a replay starts from an array of that size.
+// Invariants:
+//     _array refers to the wrapped array, which outlives *this.
+//     _trace.size() >= 1, and _trace[0] is a CONSTRUCT event.
+//
+// value_type = value type of array elements
+template <typename valType>
+class FSTTraceRecorder {
+
+// ***** FSTTraceRecorder: types *****
+public:
+
+    using value_type = valType;
+    using size_type = std::size_t;
+    using iterator = typename FSTArray<value_type>::iterator;
+
+// ***** FSTTraceRecorder: ctors *****
+public:
+
+    // Ctor from array
+    // array may already hold items.
+    // Strong Guarantee
+    explicit FSTTraceRecorder(FSTArray<value_type> & array)
+        :_array(array),
+         _trace(0),
+         _start(std::chrono::steady_clock::now())
+    {
+        _record(FSTOp::CONSTRUCT, _array.size());
+    }
+
+    // Uncopyable (would record one workload twice)
+    FSTTraceRecorder(const FSTTraceRecorder &) = delete;
+    FSTTraceRecorder & operator=(const FSTTraceRecorder &) = delete;
+
+// ***** FSTTraceRecorder: general public functions *****
+public:
+
+    // array
+    // Return the wrapped array, for reads.
+    // No-Throw Guarantee
+    FSTArray<value_type> & array() const noexcept
+    {
+        return _array;
+    }
+
+    // trace
+    // Return the trace so far.
+    // No-Throw Guarantee
+    const FSTTrace & trace() const noexcept
+    {
+        return _trace;
+    }
+
+    // takeTrace
+    // Return the trace so far, and start a new one, beginning with a
+    //  CONSTRUCT event giving the array's current size.
+    // Strong Guarantee
+    FSTTrace takeTrace()
+    {
+        FSTTrace fresh(0);
+        fresh.push_back(_event(FSTOp::CONSTRUCT, _array.size()));
+        fresh.swap(_trace);
+        return fresh;
+    }
+
+    // Modifying operations
+    // As for FSTArray, and record the operation. If the operation
+    //  throws, it is not recorded.
+    // Exception neutral
+    void push_back(const value_type & item)
+    {
+        _array.push_back(item);
+        _record(FSTOp::PUSH_BACK, 0);
+    }
+
+    void pop_back()
+    {
+        _array.pop_back();
+        _record(FSTOp::POP_BACK, 0);
+    }
+
+    iterator insert(iterator pos, const value_type & item)
+    {
+        size_type index = size_type(pos - _array.begin());
+        iterator result = _array.insert(pos, item);
+        _record(FSTOp::INSERT, index);
+        return result;
+    }
+
+    iterator erase(iterator pos)
+    {
+        size_type index = size_type(pos - _array.begin());
+        iterator result = _array.erase(pos);
+        _record(FSTOp::ERASE, index);
+        return result;
+    }
+
+    iterator unordered_erase(iterator pos)
+    {
+        size_type index = size_type(pos - _array.begin());
+        iterator result = _array.unordered_erase(pos);
+        _record(FSTOp::UNORDERED_ERASE, index);
+        return result;
+    }
+
+    void resize(size_type newsize)
+    {
+        _array.resize(newsize);
+        _record(FSTOp::RESIZE, newsize);
+    }
+
+// ***** FSTTraceRecorder: internal-use functions *****
+private:
+
+    // _event
+    // Return an event stamped with the time since *this was constructed.
+    // No-Throw Guarantee
+    FSTTraceEvent _event(FSTOp op, size_type arg) const noexcept
+    {
+        auto elapsed = std::chrono::steady_clock::now() - _start;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            elapsed).count();
+        return FSTTraceEvent{ op, arg, std::uint64_t(ns) };
+    }
+
+    // _record
+    // Append an event to the trace (see _event).
+    // Exception neutral
+    void _record(FSTOp op, size_type arg)
+    {
+        _trace.push_back(_event(op, arg));
+    }
+
+// ***** FSTTraceRecorder: data members *****
+private:
+
+    FSTArray<value_type> & _array;  // Array being traced
+    FSTTrace               _trace;  // Operations so far
+    std::chrono::steady_clock::time_point
+                           _start;  // Time of construction
+
+};  // End class FSTTraceRecorder
+
+
+// *********************************************************************
+// Binary trace files
+// *********************************************************************
+
+
+// Format (all integers unsigned LEB128 varints, 1-10 bytes):
+//     "FSTT" 0x01               magic & version
+//     count                     number of events
+//     count times:
+//         op (1 byte)  arg  dt  dt = time minus previous event's time
+// Positions, sizes, and time deltas are mostly small, so a typical
+// event takes 3-5 bytes.
+
+
+// fstWriteVarint
+// Write v as an unsigned LEB128 varint.
+// Exception neutral
+inline void fstWriteVarint(std::ostream & out,
+                           std::uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out.put(char((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.put(char(v));
+}
+
+
+// fstReadVarint
+// Read an unsigned LEB128 varint.
+// Throws std::runtime_error on end of input or an overlong varint.
+inline std::uint64_t fstReadVarint(std::istream & in)
+{
+    std::uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int c = in.get();
+        if (c == std::istream::traits_type::eof())
+            throw std::runtime_error("FST trace: unexpected end of file");
+        v |= std::uint64_t(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+            return v;
+    }
+    throw std::runtime_error("FST trace: bad varint");
+}
+
+
+// fstWriteTrace
+// Write trace to out, in the binary format above. Times must not
+//  decrease.
+// Exception neutral
+inline void fstWriteTrace(std::ostream & out,
+                          const FSTTrace & trace)
+{
+    out.write("FSTT\x01", 5);
+    fstWriteVarint(out, trace.size());
+    std::uint64_t prev = 0;
+    for (std::size_t i = 0; i < trace.size(); ++i)
+    {
+        const FSTTraceEvent & e = trace[i];
+        out.put(char(e.op));
+        fstWriteVarint(out, e.arg);
+        fstWriteVarint(out, e.time - prev);
+        prev = e.time;
+    }
+}
+
+
+// fstReadTrace
+// Read a trace written by fstWriteTrace.
+// Throws std::runtime_error if the input is not a valid trace.
+inline FSTTrace fstReadTrace(std::istream & in)
+{
+    char magic[5] = {};
+    in.read(magic, 5);
+    if (!in || magic[0] != 'F' || magic[1] != 'S' || magic[2] != 'T'
+     || magic[3] != 'T' || magic[4] != '\x01')
+        throw std::runtime_error("FST trace: bad header");
+
+    std::uint64_t count = fstReadVarint(in);
+    FSTTrace trace(0);
+    std::uint64_t time = 0;
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+        int op = in.get();
+        if (op == std::istream::traits_type::eof())
+            throw std::runtime_error("FST trace: unexpected end of file");
+        if (op >= int(FSTOp::COUNT))
+            throw std::runtime_error("FST trace: bad operation");
+        std::size_t arg = std::size_t(fstReadVarint(in));
+        time += fstReadVarint(in);
+        trace.push_back(FSTTraceEvent{ FSTOp(op), arg, time });
+    }
+    return trace;
+}
+
+
+// *********************************************************************
+// Synthetic workloads
+// *********************************************************************
+
+
+// Each returns a trace that starts from an empty array. Given the same
+// arguments, each returns the same trace.
+
+
+// fstAppendHeavyTrace
+// ops operations: push_back, with a pop_back about 1 time in 16.
+// Strong Guarantee
+inline FSTTrace fstAppendHeavyTrace(std::size_t ops,
+                                    std::uint64_t seed=1)
+{
+    std::mt19937_64 rng(seed);
+    FSTTrace t(0);
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < ops; ++i)
+    {
+        if (size > 0 && rng() % 16 == 0)
+        {
+            t.push_back(FSTTraceEvent{ FSTOp::POP_BACK, 0 });
+            --size;
+        }
+        else
+        {
+            t.push_back(FSTTraceEvent{ FSTOp::PUSH_BACK, 0 });
+            ++size;
+        }
+    }
+    return t;
+}
+
+
+// fstMidInsertTrace
+// ops inserts, each at a random position (begin() through end()).
+// Strong Guarantee
+inline FSTTrace fstMidInsertTrace(std::size_t ops,
+                                  std::uint64_t seed=1)
+{
+    std::mt19937_64 rng(seed);
+    FSTTrace t(0);
+    for (std::size_t size = 0; size < ops; ++size)
+        t.push_back(FSTTraceEvent{ FSTOp::INSERT, rng() % (size+1) });
+    return t;
+}
+
+
+// fstFifoTrace
+// Queue use: push_back up to window items, then ops rounds of
+//  push_back & erase(begin()).
+// Strong Guarantee
+inline FSTTrace fstFifoTrace(std::size_t ops,
+                             std::size_t window=4096)
+{
+    FSTTrace t(0);
+    for (std::size_t i = 0; i < window; ++i)
+        t.push_back(FSTTraceEvent{ FSTOp::PUSH_BACK, 0 });
+    for (std::size_t i = 0; i < ops; ++i)
+    {
+        t.push_back(FSTTraceEvent{ FSTOp::PUSH_BACK, 0 });
+        t.push_back(FSTTraceEvent{ FSTOp::ERASE, 0 });
+    }
+    return t;
+}
+
+
+// fstRandomEraseTrace
+// push_back size items, then erase at random positions until empty.
+// Strong Guarantee
+inline FSTTrace fstRandomEraseTrace(std::size_t size,
+                                    std::uint64_t seed=1)
+{
+    std::mt19937_64 rng(seed);
+    FSTTrace t(0);
+    for (std::size_t i = 0; i < size; ++i)
+        t.push_back(FSTTraceEvent{ FSTOp::PUSH_BACK, 0 });
+    for (std::size_t left = size; left > 0; --left)
+        t.push_back(FSTTraceEvent{ FSTOp::ERASE, rng() % left });
+    return t;
+}
+
+
+// fstBurstyTrace
+// bursts rounds of: push_back up to peak items, then pop_back down to
+//  floor items. For studying memory held after a burst.
+// Pre:
+//     floor <= peak.
+// Strong Guarantee
+inline FSTTrace fstBurstyTrace(std::size_t bursts,
+                               std::size_t peak=100000,
+                               std::size_t floor=100)
+{
+    FSTTrace t(0);
+    std::size_t size = 0;
+    for (std::size_t b = 0; b < bursts; ++b)
+    {
+        for (; size < peak; ++size)
+            t.push_back(FSTTraceEvent{ FSTOp::PUSH_BACK, 0 });
+        for (; size > floor; --size)
+            t.push_back(FSTTraceEvent{ FSTOp::POP_BACK, 0 });
+    }
+    return t;
+}
+
+
+#endif  //#ifndef FILE_FSTARRAY_TRACE_H_INCLUDED
+
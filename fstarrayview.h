@@ -0,0 +1,851 @@
+// fstarrayview.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Non-owning views, strided views & shared owning slices of FSTArray
+
+#ifndef FILE_FSTARRAYVIEW_H_INCLUDED
+#define FILE_FSTARRAYVIEW_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+// For std::ptrdiff_t
+#include <algorithm>
+// For std::copy
+#include <iterator>
+// For std::random_access_iterator_tag
+#include <memory>
+// For std::shared_ptr
+// For std::make_shared
+#include <stdexcept>
+// For std::out_of_range
+// For std::invalid_argument
+#include <type_traits>
+// For std::remove_cv_t
+// For std::is_const_v
+// For std::is_same_v
+// For std::enable_if_t
+#include <utility>
+// For std::move
+#if __cplusplus >= 202002L
+#include <span>
+// For std::span
+#endif
+
+// Views let functions take part of an FSTArray without copying it:
+//     FSTArrayView<T>        Contiguous items, read & write.
+//     FSTArrayView<const T>  Contiguous items, read only.
+//     FSTStridedView<T>      Every step-th item (T may be const).
+//     FSTArraySlice<T>       Read-only slice of an FSTArray that the
+//                            slice shares ownership of.
+// An FSTArray converts to FSTArrayView implicitly, so a function taking
+//  FSTArrayView<const int> accepts an FSTArray<int>, a view, or a
+//  subview of either. subview, first, last & strided make new views;
+//  none allocate. Under C++20, views convert to & from std::span.
+// FSTArrayView & FSTStridedView do not own their items: like an
+//  iterator, a view of an FSTArray is invalidated by resizing,
+//  reallocating, or destroying the array.
+// FSTArraySlice instead holds a reference count on an FSTArray it was
+//  given, so slices may be stored & passed between threads; the array
+//  is destroyed with its last slice. A slice keeps the whole array
+//  alive, not just its own items.
+// Errors: subview etc. throw std::out_of_range if the range does not
+//  fit; strided throws std::invalid_argument if step is 0. operator[]
+//  checks its index only in hardening mode (FSTARRAY_HARDENED), as for
+//  FSTArray; at always checks.
+
+
+// *********************************************************************
+// Implementation details
+// *********************************************************************
+
+
+namespace fst_view_detail {
+
+    // checkRange
+    // Throw std::out_of_range unless [offset, offset+count) lies within
+    //  [0, size).
+    inline void checkRange(std::size_t offset,
+                           std::size_t count,
+                           std::size_t size)
+    {
+        if (offset > size || count > size - offset)
+            throw std::out_of_range("FSTArrayView: range out of bounds");
+    }
+
+    // checkIndex
+    // In hardening mode, throw std::out_of_range unless index < size.
+    inline void checkIndex([[maybe_unused]] std::size_t index,
+                           [[maybe_unused]] std::size_t size)
+    {
+#ifdef FSTARRAY_HARDENED
+        if (index >= size)
+            throw std::out_of_range("FSTArrayView: index out of range");
+#endif
+    }
+
+    // toArray
+    // Return FSTArray holding copies of [first, first+n).
+    // Strong Guarantee
+    // Exception neutral
+    template <typename T>
+    FSTArray<std::remove_cv_t<T>> toArray(const T * first,
+                                          std::size_t n)
+    {
+        FSTArray<std::remove_cv_t<T>> result(n);
+        if (n != 0)
+            std::copy(first, first + n, &result[0]);
+        return result;
+    }
+
+}  // End namespace fst_view_detail
+
+
+template <typename T>
+class FSTStridedView;
+
+
+// *********************************************************************
+// class FSTArrayView - Class definition
+// *********************************************************************
+
+
+// class FSTArrayView
+// Non-owning view of contiguous items (see top of file).
+// Invariants:
+//     _data points to _size items -- UNLESS _size == 0, in which case
+//      _data may be nullptr.
+// Requirements on Types:
+//     None beyond those of FSTArray, for conversions from FSTArray.
+//
+// T = item type; const T for a read-only view
+template <typename T>
+class FSTArrayView {
+
+// ***** FSTArrayView: types *****
+public:
+
+    // element_type: type of items, as seen through the view
+    using element_type = T;
+    // value_type: type of items, without const
+    using value_type = std::remove_cv_t<T>;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+    // iterator: random-access iterator type
+    using iterator = T *;
+
+// ***** FSTArrayView: ctors *****
+public:
+
+    // Default ctor
+    // Empty view.
+    // No-Throw Guarantee
+    FSTArrayView() noexcept
+        :_data(nullptr),
+         _size(0)
+    {}
+
+    // Ctor from pointer & size
+    // Pre:
+    //     [data, data+size) is a valid range.
+    // No-Throw Guarantee
+    FSTArrayView(T * data,
+                 size_type size) noexcept
+        :_data(data),
+         _size(size)
+    {}
+
+    // Ctor from FSTArray
+    // View of all of a. A read-only view may be made from a const array.
+    // No-Throw Guarantee
+    template <typename P>
+    FSTArrayView(FSTArray<value_type, P> & a) noexcept
+        :_data(a.size() == 0 ? nullptr : &a[0]),
+         _size(a.size())
+    {}
+
+    template <typename P, typename U=T,
+              typename = std::enable_if_t<std::is_const_v<U>>>
+    FSTArrayView(const FSTArray<value_type, P> & a) noexcept
+        :_data(a.size() == 0 ? nullptr : &a[0]),
+         _size(a.size())
+    {}
+
+    // Ctor from read-write view, making a read-only view
+    // No-Throw Guarantee
+    template <typename U,
+              typename = std::enable_if_t<std::is_same_v<const U, T>
+                                       && !std::is_same_v<U, T>>>
+    FSTArrayView(const FSTArrayView<U> & other) noexcept
+        :_data(other.begin()),
+         _size(other.size())
+    {}
+
+#if __cplusplus >= 202002L
+    // Ctor from std::span
+    // A read-only view may be made from a span of non-const items.
+    // No-Throw Guarantee
+    template <typename U, std::size_t Extent,
+              typename = std::enable_if_t<std::is_same_v<U, T>
+                                       || std::is_same_v<const U, T>>>
+    FSTArrayView(std::span<U, Extent> s) noexcept
+        :_data(s.data()),
+         _size(s.size())
+    {}
+#endif
+
+    // Compiler-generated copy ctor, copy op=, dctor are used.
+
+// ***** FSTArrayView: general public operators *****
+public:
+
+    // operator[]
+    // Pre:
+    //     index < size() (checked in hardening mode).
+    // No-Throw Guarantee, except in hardening mode
+    T & operator[](size_type index) const
+    {
+        fst_view_detail::checkIndex(index, _size);
+        return _data[index];
+    }
+
+#if __cplusplus >= 202002L
+    // operator std::span
+    // No-Throw Guarantee
+    operator std::span<T>() const noexcept
+    {
+        return std::span<T>(_data, _size);
+    }
+#endif
+
+// ***** FSTArrayView: general public functions *****
+public:
+
+    // at
+    // Like operator[], but always checks index.
+    // Throws std::out_of_range if index >= size().
+    T & at(size_type index) const
+    {
+        if (index >= _size)
+            throw std::out_of_range("FSTArrayView::at: index out of range");
+        return _data[index];
+    }
+
+    // size, empty
+    // No-Throw Guarantee
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    // begin, end
+    // No-Throw Guarantee
+    iterator begin() const noexcept
+    {
+        return _data;
+    }
+
+    iterator end() const noexcept
+    {
+        return _data + _size;
+    }
+
+    // subview
+    // Return view of count items starting at offset.
+    // Throws std::out_of_range if they are not all in this view.
+    // Strong Guarantee
+    FSTArrayView subview(size_type offset,
+                         size_type count) const
+    {
+        fst_view_detail::checkRange(offset, count, _size);
+        return FSTArrayView(_data + offset, count);
+    }
+
+    // first, last
+    // Return view of the first, last count items.
+    // Throws std::out_of_range if count > size().
+    // Strong Guarantee
+    FSTArrayView first(size_type count) const
+    {
+        return subview(0, count);
+    }
+
+    FSTArrayView last(size_type count) const
+    {
+        fst_view_detail::checkRange(0, count, _size);
+        return FSTArrayView(_data + (_size - count), count);
+    }
+
+    // strided
+    // Return view of items 0, step, 2*step, etc.
+    // Throws std::invalid_argument if step is 0.
+    // Strong Guarantee
+    FSTStridedView<T> strided(size_type step) const;
+
+    // toArray
+    // Return FSTArray holding copies of the items.
+    // Strong Guarantee
+    // Exception neutral
+    FSTArray<value_type> toArray() const
+    {
+        return fst_view_detail::toArray(_data, _size);
+    }
+
+// ***** FSTArrayView: data members *****
+private:
+
+    T *       _data;  // First item viewed
+    size_type _size;  // Number of items viewed
+
+};  // End class FSTArrayView
+
+
+// Deduction guides
+// FSTArrayView v(a) views a non-const FSTArray read-write, a const one
+//  read-only.
+template <typename T, typename P>
+FSTArrayView(FSTArray<T, P> &) -> FSTArrayView<T>;
+
+template <typename T, typename P>
+FSTArrayView(const FSTArray<T, P> &) -> FSTArrayView<const T>;
+
+
+// *********************************************************************
+// class FSTStridedIter - Class definition
+// *********************************************************************
+
+
+// class FSTStridedIter
+// Random-access iterator over every step-th item of an array. Holds an
+//  index rather than a pointer, so that the end iterator need not point
+//  into (or just past) the array.
+// Invariants:
+//     _stride > 0.
+//
+// T = item type; const T for a read-only iterator
+template <typename T>
+class FSTStridedIter {
+
+// ***** FSTStridedIter: types *****
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+// ***** FSTStridedIter: ctors *****
+public:
+
+    // Default ctor
+    // Singular iterator.
+    // No-Throw Guarantee
+    FSTStridedIter() noexcept
+        :_base(nullptr),
+         _index(0),
+         _stride(1)
+    {}
+
+    // Ctor from first item, index & stride
+    // Iterator to item base[index*stride].
+    // No-Throw Guarantee
+    FSTStridedIter(T * base,
+                   difference_type index,
+                   difference_type stride) noexcept
+        :_base(base),
+         _index(index),
+         _stride(stride)
+    {}
+
+// ***** FSTStridedIter: general public operators *****
+public:
+
+    reference operator*() const noexcept
+    {
+        return _base[_index * _stride];
+    }
+
+    pointer operator->() const noexcept
+    {
+        return _base + _index * _stride;
+    }
+
+    reference operator[](difference_type n) const noexcept
+    {
+        return _base[(_index + n) * _stride];
+    }
+
+    FSTStridedIter & operator++() noexcept
+    {
+        ++_index;
+        return *this;
+    }
+
+    FSTStridedIter operator++(int) noexcept
+    {
+        FSTStridedIter save = *this;
+        ++_index;
+        return save;
+    }
+
+    FSTStridedIter & operator--() noexcept
+    {
+        --_index;
+        return *this;
+    }
+
+    FSTStridedIter operator--(int) noexcept
+    {
+        FSTStridedIter save = *this;
+        --_index;
+        return save;
+    }
+
+    FSTStridedIter & operator+=(difference_type n) noexcept
+    {
+        _index += n;
+        return *this;
+    }
+
+    FSTStridedIter & operator-=(difference_type n) noexcept
+    {
+        _index -= n;
+        return *this;
+    }
+
+    friend FSTStridedIter operator+(FSTStridedIter it,
+                                    difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend FSTStridedIter operator+(difference_type n,
+                                    FSTStridedIter it) noexcept
+    {
+        return it += n;
+    }
+
+    friend FSTStridedIter operator-(FSTStridedIter it,
+                                    difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    // Comparisons are meaningful only between iterators into one view.
+    friend difference_type operator-(const FSTStridedIter & a,
+                                     const FSTStridedIter & b) noexcept
+    {
+        return a._index - b._index;
+    }
+
+    friend bool operator==(const FSTStridedIter & a,
+                           const FSTStridedIter & b) noexcept
+    {
+        return a._index == b._index;
+    }
+
+    friend bool operator!=(const FSTStridedIter & a,
+                           const FSTStridedIter & b) noexcept
+    {
+        return a._index != b._index;
+    }
+
+    friend bool operator<(const FSTStridedIter & a,
+                          const FSTStridedIter & b) noexcept
+    {
+        return a._index < b._index;
+    }
+
+    friend bool operator>(const FSTStridedIter & a,
+                          const FSTStridedIter & b) noexcept
+    {
+        return b < a;
+    }
+
+    friend bool operator<=(const FSTStridedIter & a,
+                           const FSTStridedIter & b) noexcept
+    {
+        return !(b < a);
+    }
+
+    friend bool operator>=(const FSTStridedIter & a,
+                           const FSTStridedIter & b) noexcept
+    {
+        return !(a < b);
+    }
+
+// ***** FSTStridedIter: data members *****
+private:
+
+    T *             _base;    // Item 0 of the view
+    difference_type _index;   // Current item, in items of the view
+    difference_type _stride;  // Distance between items
+
+};  // End class FSTStridedIter
+
+
+// *********************************************************************
+// class FSTStridedView - Class definition
+// *********************************************************************
+
+
+// class FSTStridedView
+// Non-owning view of every step-th item of an array (see top of file),
+//  e.g., one column of a row-major matrix.
+// Invariants:
+//     _stride > 0.
+//     _data[i*_stride] is an item, for 0 <= i < _size.
+//
+// T = item type; const T for a read-only view
+template <typename T>
+class FSTStridedView {
+
+// ***** FSTStridedView: types *****
+public:
+
+    // element_type: type of items, as seen through the view
+    using element_type = T;
+    // value_type: type of items, without const
+    using value_type = std::remove_cv_t<T>;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+    // iterator: random-access iterator type
+    using iterator = FSTStridedIter<T>;
+
+// ***** FSTStridedView: ctors *****
+public:
+
+    // Default ctor
+    // Empty view.
+    // No-Throw Guarantee
+    FSTStridedView() noexcept
+        :_data(nullptr),
+         _size(0),
+         _stride(1)
+    {}
+
+    // Ctor from pointer, size & stride
+    // View of items data[0], data[stride], ..., data[(size-1)*stride].
+    // Throws std::invalid_argument if stride is 0.
+    // Pre:
+    //     Those items exist.
+    FSTStridedView(T * data,
+                   size_type size,
+                   size_type stride)
+        :_data(data),
+         _size(size),
+         _stride(stride)
+    {
+        if (stride == 0)
+            throw std::invalid_argument("FSTStridedView: stride is 0");
+    }
+
+    // Ctor from read-write view, making a read-only view
+    // No-Throw Guarantee
+    template <typename U,
+              typename = std::enable_if_t<std::is_same_v<const U, T>
+                                       && !std::is_same_v<U, T>>>
+    FSTStridedView(const FSTStridedView<U> & other) noexcept
+        :_data(other.size() == 0 ? nullptr : &other[0]),
+         _size(other.size()),
+         _stride(other.stride())
+    {}
+
+    // Compiler-generated copy ctor, copy op=, dctor are used.
+
+// ***** FSTStridedView: general public operators *****
+public:
+
+    // operator[]
+    // Pre:
+    //     index < size() (checked in hardening mode).
+    // No-Throw Guarantee, except in hardening mode
+    T & operator[](size_type index) const
+    {
+        fst_view_detail::checkIndex(index, _size);
+        return _data[index * _stride];
+    }
+
+// ***** FSTStridedView: general public functions *****
+public:
+
+    // at
+    // Like operator[], but always checks index.
+    // Throws std::out_of_range if index >= size().
+    T & at(size_type index) const
+    {
+        if (index >= _size)
+            throw std::out_of_range(
+                "FSTStridedView::at: index out of range");
+        return _data[index * _stride];
+    }
+
+    // size, empty, stride
+    // No-Throw Guarantee
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] size_type stride() const noexcept
+    {
+        return _stride;
+    }
+
+    // begin, end
+    // No-Throw Guarantee
+    iterator begin() const noexcept
+    {
+        return iterator(_data, 0, std::ptrdiff_t(_stride));
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator(_data, std::ptrdiff_t(_size),
+                        std::ptrdiff_t(_stride));
+    }
+
+    // subview
+    // Return view of count items of this view, starting at offset.
+    // Throws std::out_of_range if they are not all in this view.
+    // Strong Guarantee
+    FSTStridedView subview(size_type offset,
+                           size_type count) const
+    {
+        fst_view_detail::checkRange(offset, count, _size);
+        return FSTStridedView(count == 0 ? _data : _data + offset * _stride,
+                              count, _stride);
+    }
+
+    // strided
+    // Return view of items 0, step, 2*step, etc., of this view.
+    // Throws std::invalid_argument if step is 0.
+    // Strong Guarantee
+    FSTStridedView strided(size_type step) const
+    {
+        if (step == 0)
+            throw std::invalid_argument("FSTStridedView: stride is 0");
+        return FSTStridedView(_data, (_size + step - 1) / step,
+                              _stride * step);
+    }
+
+    // toArray
+    // Return FSTArray holding copies of the items.
+    // Strong Guarantee
+    // Exception neutral
+    FSTArray<value_type> toArray() const
+    {
+        FSTArray<value_type> result(_size);
+        for (size_type i = 0; i < _size; ++i)
+            result[i] = _data[i * _stride];
+        return result;
+    }
+
+// ***** FSTStridedView: data members *****
+private:
+
+    T *       _data;    // First item viewed
+    size_type _size;    // Number of items viewed
+    size_type _stride;  // Distance between items
+
+};  // End class FSTStridedView
+
+
+// *********************************************************************
+// class FSTArrayView - Definitions of member templates
+// *********************************************************************
+
+
+// FSTArrayView::strided
+// See class definition.
+template <typename T>
+FSTStridedView<T> FSTArrayView<T>::strided(size_type step) const
+{
+    if (step == 0)
+        throw std::invalid_argument("FSTArrayView: stride is 0");
+    return FSTStridedView<T>(_data, (_size + step - 1) / step, step);
+}
+
+
+// *********************************************************************
+// class FSTArraySlice - Class definition
+// *********************************************************************
+
+
+// class FSTArraySlice
+// Read-only slice of an FSTArray, sharing ownership of the array (see
+//  top of file). Copying a slice, or slicing it, copies no items: it
+//  adds to the reference count. Items are read-only, so slices sharing
+//  an array may be read by different threads at once.
+// Invariants:
+//     _buffer == nullptr && _offset == 0 && _size == 0 (empty slice),
+//      or _offset + _size <= _buffer->size().
+// Requirements on Types:
+//     value_type is as for FSTArray.
+//
+// value_type = value type of array elements
+template <typename valType>
+class FSTArraySlice {
+
+// ***** FSTArraySlice: types *****
+public:
+
+    // value_type: type of data items
+    using value_type = valType;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+    // buffer_type: the shared array
+    using buffer_type = FSTArray<value_type>;
+    // iterator: random-access iterator type
+    using iterator = const value_type *;
+
+// ***** FSTArraySlice: ctors *****
+public:
+
+    // Default ctor
+    // Empty slice of no array.
+    // No-Throw Guarantee
+    FSTArraySlice() noexcept
+        :_buffer(),
+         _offset(0),
+         _size(0)
+    {}
+
+    // Ctor from array
+    // Slice of all of a, which the slice takes (a is left empty).
+    // Strong Guarantee
+    explicit FSTArraySlice(buffer_type && a)
+        :_buffer(std::make_shared<const buffer_type>(std::move(a))),
+         _offset(0),
+         _size(_buffer->size())
+    {}
+
+    // Ctor from shared array
+    // Slice of all of *buffer, sharing ownership of it.
+    // Pre:
+    //     Nothing modifies *buffer while slices of it exist.
+    // No-Throw Guarantee
+    explicit FSTArraySlice(std::shared_ptr<const buffer_type> buffer) noexcept
+        :_buffer(std::move(buffer)),
+         _offset(0),
+         _size(_buffer ? _buffer->size() : 0)
+    {}
+
+    // Compiler-generated copy/move ctor, op=, dctor are used.
+
+// ***** FSTArraySlice: general public operators *****
+public:
+
+    // operator[]
+    // Pre:
+    //     index < size() (checked in hardening mode).
+    // No-Throw Guarantee, except in hardening mode
+    const value_type & operator[](size_type index) const
+    {
+        fst_view_detail::checkIndex(index, _size);
+        return begin()[index];
+    }
+
+    // operator FSTArrayView
+    // View of this slice's items, valid while this slice exists.
+    // No-Throw Guarantee
+    operator FSTArrayView<const value_type>() const noexcept
+    {
+        return view();
+    }
+
+// ***** FSTArraySlice: general public functions *****
+public:
+
+    // size, empty
+    // No-Throw Guarantee
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    // begin, end
+    // No-Throw Guarantee
+    iterator begin() const noexcept
+    {
+        return _size == 0 ? nullptr : &(*_buffer)[_offset];
+    }
+
+    iterator end() const noexcept
+    {
+        return begin() + _size;
+    }
+
+    // view
+    // Return view of this slice's items, valid while this slice (or
+    //  another sharing its array) exists.
+    // No-Throw Guarantee
+    FSTArrayView<const value_type> view() const noexcept
+    {
+        return FSTArrayView<const value_type>(begin(), _size);
+    }
+
+    // slice
+    // Return slice of count items of this slice, starting at offset,
+    //  sharing this slice's array.
+    // Throws std::out_of_range if they are not all in this slice.
+    // Strong Guarantee
+    FSTArraySlice slice(size_type offset,
+                        size_type count) const
+    {
+        fst_view_detail::checkRange(offset, count, _size);
+        FSTArraySlice result(*this);
+        result._offset = _offset + offset;
+        result._size = count;
+        return result;
+    }
+
+    // useCount
+    // Return number of slices (& other owners) sharing this slice's
+    //  array; 0 for an empty default-constructed slice.
+    // No-Throw Guarantee
+    [[nodiscard]] long useCount() const noexcept
+    {
+        return _buffer.use_count();
+    }
+
+    // toArray
+    // Return FSTArray holding copies of this slice's items.
+    // Strong Guarantee
+    // Exception neutral
+    FSTArray<value_type> toArray() const
+    {
+        return fst_view_detail::toArray(begin(), _size);
+    }
+
+// ***** FSTArraySlice: data members *****
+private:
+
+    std::shared_ptr<const buffer_type> _buffer;  // Shared array
+    size_type                          _offset;  // First item, in array
+    size_type                          _size;    // Number of items
+
+};  // End class FSTArraySlice
+
+
+#endif  //#ifndef FILE_FSTARRAYVIEW_H_INCLUDED
+
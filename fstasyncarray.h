@@ -0,0 +1,394 @@
+// fstasyncarray.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// FSTArray with background reallocation for latency-sensitive appends
+
+#ifndef FILE_FSTASYNCARRAY_H_INCLUDED
+#define FILE_FSTASYNCARRAY_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <algorithm>
+// For std::copy
+#include <atomic>
+// For std::atomic
+#include <thread>
+// For std::thread
+#include <utility>
+// For std::move
+
+// *********************************************************************
+// class FSTAsyncArray - Class definition
+// *********************************************************************
+
+
+// class FSTAsyncArray
+// Drop-in replacement for FSTArray, with the same interface, for arrays
+//  that grow by push_back to tens of millions of items. With FSTArray,
+//  the push_back that crosses the capacity copies the whole array.
+//  Here, once size passes a high-water mark (3/4 of capacity, and at
+//  least minAsyncSize items), a background thread allocates a buffer of
+//  twice the capacity and copies the current items into it. push_back
+//  keeps appending to the tail of the old buffer meanwhile; when the
+//  copy is done, the next push_back copies only the items appended
+//  since, and switches buffers. The old buffer is freed by the next
+//  background copy (or the dctor), not on the append path.
+// Only appends & const access run alongside a copy. Any other
+//  modifying or non-const operation (operator[], begin, insert, resize,
+//  ...) first waits for the copy to finish. So there are no concurrent
+//  writes to items the background thread reads.
+// If the background allocation or copy fails, the larger buffer is
+//  dropped, and the array grows the ordinary way later.
+// Unlike FSTArray, a push_back that does not reach capacity may still
+//  invalidate references: a reference obtained before a background
+//  copy starts refers to the old buffer. Writing through it while the
+//  copy is in flight races the copy, and the write is lost when buffers
+//  switch. Get references again (operator[], begin) after push_back.
+// Invariants:
+//     _live holds the items.
+//     If _worker is joinable, a copy of _live[0 .. _copied) into _next
+//      is running or done (done iff _ready), and _live.size() >=
+//      _copied, and _live will not reallocate before the copy is
+//      finished.
+//     _retired is empty, or a buffer no longer in use.
+//
+// value_type = value type of array elements
+template <typename valType>
+class FSTAsyncArray {
+
+// ***** FSTAsyncArray: types *****
+public:
+
+    // Same as FSTArray
+    using value_type = valType;
+    using size_type = std::size_t;
+    using iterator = typename FSTArray<value_type>::iterator;
+    using const_iterator = typename FSTArray<value_type>::const_iterator;
+
+// ***** FSTAsyncArray: internal-use constants *****
+private:
+
+    // Default minimum size for background growth. Smaller arrays grow
+    //  in place, since their copy is cheap.
+    enum { DEFAULT_MIN_ASYNC = 1 << 16 };
+
+// ***** FSTAsyncArray: ctors, op=, dctor *****
+public:
+
+    // Default ctor & ctor from size
+    // Strong Guarantee
+    explicit FSTAsyncArray(size_type size=0)
+        :_live(size),
+         _next(0),
+         _retired(0),
+         _copied(0),
+         _ready(false),
+         _failed(false),
+         _minAsyncSize(DEFAULT_MIN_ASYNC)
+    {}
+
+    // Copy ctor
+    // Strong Guarantee
+    FSTAsyncArray(const FSTAsyncArray & other)
+        :_live(other._live),
+         _next(0),
+         _retired(0),
+         _copied(0),
+         _ready(false),
+         _failed(false),
+         _minAsyncSize(other._minAsyncSize)
+    {}
+
+    // Move ctor
+    // Waits for any background copy in other.
+    // No-Throw Guarantee
+    FSTAsyncArray(FSTAsyncArray && other) noexcept
+        :_live((other._finishGrowth(), std::move(other._live))),
+         _next(std::move(other._next)),
+         _retired(std::move(other._retired)),
+         _copied(0),
+         _ready(false),
+         _failed(false),
+         _minAsyncSize(other._minAsyncSize)
+    {}
+
+    // Copy assignment operator
+    // Strong Guarantee
+    FSTAsyncArray & operator=(const FSTAsyncArray & other)
+    {
+        FSTAsyncArray copyRhs(other);
+        swap(copyRhs);
+        return *this;
+    }
+
+    // Move assignment operator
+    // No-Throw Guarantee
+    FSTAsyncArray & operator=(FSTAsyncArray && other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    // Dctor
+    // Waits for any background copy.
+    // No-Throw Guarantee
+    ~FSTAsyncArray()
+    {
+        if (_worker.joinable())
+            _worker.join();
+    }
+
+// ***** FSTAsyncArray: general public operators *****
+public:
+
+    // operator[] - non-const & const
+    // Pre:
+    //     index < size().
+    // The non-const version waits for any background copy.
+    // No-Throw Guarantee
+    value_type & operator[](size_type index)
+    {
+        _finishGrowth();
+        return _live[index];
+    }
+
+    const value_type & operator[](size_type index) const
+    {
+        return _live[index];
+    }
+
+// ***** FSTAsyncArray: general public functions *****
+public:
+
+    // at - non-const & const
+    // Throws std::out_of_range if index >= size().
+    // Strong Guarantee
+    value_type & at(size_type index)
+    {
+        _finishGrowth();
+        return _live.at(index);
+    }
+
+    const value_type & at(size_type index) const
+    {
+        return _live.at(index);
+    }
+
+    // size, empty, capacity
+    // No-Throw Guarantee
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return _live.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _live.empty();
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return _live.capacity();
+    }
+
+    // begin, end - non-const & const
+    // The non-const versions wait for any background copy.
+    // No-Throw Guarantee
+    iterator begin() noexcept
+    {
+        _finishGrowth();
+        return _live.begin();
+    }
+    const_iterator begin() const noexcept
+    {
+        return _live.begin();
+    }
+
+    iterator end() noexcept
+    {
+        _finishGrowth();
+        return _live.end();
+    }
+    const_iterator end() const noexcept
+    {
+        return _live.end();
+    }
+
+    // resize, insert, erase, unordered_erase, erase_if
+    // As for FSTArray. Each waits for any background copy first.
+    // Strong Guarantee (erase_if: Basic Guarantee)
+    // Exception neutral
+    void resize(size_type newsize)
+    {
+        _finishGrowth();
+        _live.resize(newsize);
+    }
+
+    iterator insert(iterator pos, const value_type & item)
+    {
+        _finishGrowth();
+        return _live.insert(pos, item);
+    }
+
+    iterator erase(iterator pos)
+    {
+        _finishGrowth();
+        return _live.erase(pos);
+    }
+
+    iterator unordered_erase(iterator pos)
+    {
+        _finishGrowth();
+        return _live.unordered_erase(pos);
+    }
+
+    template <typename Pred>
+    size_type erase_if(Pred pred)
+    {
+        _finishGrowth();
+        return _live.erase_if(pred);
+    }
+
+    // swap
+    // Waits for any background copies.
+    // No-Throw Guarantee
+    void swap(FSTAsyncArray & other) noexcept
+    {
+        _finishGrowth();
+        other._finishGrowth();
+        _live.swap(other._live);
+        std::swap(_minAsyncSize, other._minAsyncSize);
+    }
+
+    // push_back
+    // Does not wait for a background copy unless the old buffer is full.
+    // Strong Guarantee
+    // Exception neutral
+    void push_back(const value_type & item)
+    {
+        if (_worker.joinable())
+        {
+            if (_ready.load(std::memory_order_acquire)
+             || _live.size() + 1 >= _live.capacity()
+             || _live.size() < _copied)
+                _finishGrowth();
+        }
+        _live.push_back(item);
+        if (!_worker.joinable()
+         && _live.size() >= _minAsyncSize
+         && _live.size() >= _live.capacity() / 4 * 3)
+            _startGrowth();
+    }
+
+    // pop_back
+    // Waits for a background copy only if size() would drop below the
+    //  number of items being copied.
+    // Strong Guarantee
+    // Exception neutral
+    void pop_back()
+    {
+        if (_worker.joinable() && _live.size() <= _copied)
+            _finishGrowth();
+        _live.pop_back();
+    }
+
+    // setMinAsyncSize
+    // Set the smallest size at which growth is done in the background.
+    // No-Throw Guarantee
+    void setMinAsyncSize(size_type minSize) noexcept
+    {
+        _minAsyncSize = minSize;
+    }
+
+// ***** FSTAsyncArray: internal-use functions *****
+private:
+
+    // _startGrowth
+    // Launch a background copy of _live into a buffer twice as large.
+    // If the thread cannot be started, do nothing; growth then happens
+    //  the ordinary way.
+    // No-Throw Guarantee
+    void _startGrowth() noexcept
+    {
+        const value_type * src = &_live[0];
+        size_type count = _live.size();
+        size_type newCapacity = 2 * _live.capacity();
+
+        _copied = count;
+        _ready.store(false, std::memory_order_relaxed);
+        _failed = false;
+        try {
+            _worker = std::thread([this, src, count, newCapacity]() {
+                _release(_retired);
+                try {
+                    FSTArray<value_type> next(newCapacity);
+                    std::copy(src, src + count, &next[0]);
+                    _next = std::move(next);
+                }
+                catch(...){
+                    _failed = true;
+                }
+                _ready.store(true, std::memory_order_release);
+            });
+        }
+        catch(...){
+            _copied = 0;
+        }
+    }
+
+    // _finishGrowth
+    // If a background copy was started, wait for it, copy over items
+    //  appended since, and switch to the new buffer.
+    // If anything fails, keep the old buffer.
+    // No-Throw Guarantee
+    void _finishGrowth() noexcept
+    {
+        if (!_worker.joinable())
+            return;
+        _worker.join();
+        if (!_failed)
+        {
+            try {
+                if (_live.size() > _copied)
+                    std::copy(&_live[0] + _copied, &_live[0] + _live.size(),
+                              &_next[0] + _copied);
+                _next.resize(_live.size());  // Never reallocates
+                _live.swap(_next);
+                _retired.swap(_next);
+            }
+            catch(...){
+            }
+        }
+        _release(_next);
+        _copied = 0;
+    }
+
+    // _release
+    // Free the buffer of arr, leaving it empty with capacity 0.
+    // No-Throw Guarantee
+    static void _release(FSTArray<value_type> & arr) noexcept
+    {
+        FSTArray<value_type> gone(std::move(arr));
+    }
+
+// ***** FSTAsyncArray: data members *****
+private:
+
+    FSTArray<value_type> _live;          // Our items
+    FSTArray<value_type> _next;          // Larger buffer being filled
+    FSTArray<value_type> _retired;       // Old buffer, to free later
+    size_type            _copied;        // Items copied in background
+    std::atomic<bool>    _ready;         // Background copy done
+    bool                 _failed;        // Background copy failed
+    size_type            _minAsyncSize;  // Smallest size to grow async
+    std::thread          _worker;        // Background copy, if any
+
+};  // End class FSTAsyncArray
+
+
+#endif  //#ifndef FILE_FSTASYNCARRAY_H_INCLUDED
+
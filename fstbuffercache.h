@@ -0,0 +1,325 @@
+// fstbuffercache.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Thread-local cache of FSTArray buffers, by power-of-two capacity
+// Used by fstarray.h when FSTARRAY_BUFFER_CACHE is defined.
+
+#ifndef FILE_FSTBUFFERCACHE_H_INCLUDED
+#define FILE_FSTBUFFERCACHE_H_INCLUDED
+
+#include <cstddef>
+// For std::size_t
+#include <cstring>
+// For std::memcpy
+#include <type_traits>
+// For std::is_trivial_v
+
+// *********************************************************************
+// class FSTBufferCache - Class definition
+// *********************************************************************
+
+
+// class FSTBufferCache
+// Per-thread, per-type cache of arrays allocated with new [], so that
+//  FSTArray objects that are made, grown, and destroyed over and over
+//  reuse buffers instead of going back to the allocator. Buffers are
+//  grouped by capacity class: class k holds buffers of exactly 2^k
+//  items. Cached buffers are kept on an intrusive free list (the link
+//  is stored in the buffer itself), so the cache needs no storage of
+//  its own.
+// Only trivial types are cached: a reused buffer then holds
+//  indeterminate values, just like a fresh new [] of such a type.
+// Limits: at most maxPerClass buffers per class, and at most maxBytes
+//  bytes in all. A buffer that would exceed a limit is not taken, and
+//  the caller frees it as usual.
+// Teardown: a thread's cache (local()) is destroyed at thread exit. On
+//  the main thread, that is before objects of static storage duration
+//  are destroyed, so an FSTArray global may free its buffer after the
+//  cache is gone. FSTArray therefore uses localIfAlive(), which returns
+//  nullptr from then on, and falls back to plain new [] & delete [].
+// Invariants:
+//     _isLocal is true only for the object returned by local().
+//     _head[k] is the first buffer of class k, or nullptr; each cached
+//      buffer begins with a pointer to the next, or nullptr.
+//     _count[k] is the length of the list at _head[k].
+//     _bytes is the total size of all cached buffers.
+// Requirements on Types:
+//     T is trivial.
+template <typename T>
+class FSTBufferCache {
+
+    static_assert(std::is_trivial_v<T>,
+                  "FSTBufferCache holds buffers of trivial types only");
+
+// ***** FSTBufferCache: types *****
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+// ***** FSTBufferCache: internal-use constants *****
+private:
+
+    // Number of capacity classes
+    enum { CLASSES = 8 * sizeof(size_type) };
+
+    // Largest power of two in a size_type; larger capacities have no
+    //  class, and are not rounded
+    static constexpr size_type MAX_CLASS_CAP = size_type(1) << (CLASSES-1);
+
+    // Default limits
+    enum { DEFAULT_PER_CLASS = 8 };
+    static constexpr size_type DEFAULT_BYTES = size_type(64) << 20;
+
+// ***** FSTBufferCache: ctors, dctor *****
+public:
+
+    // Default ctor
+    // No-Throw Guarantee
+    FSTBufferCache() noexcept
+        :_isLocal(false),
+         _enabled(true),
+         _maxPerClass(DEFAULT_PER_CLASS),
+         _maxBytes(DEFAULT_BYTES),
+         _bytes(0),
+         _hits(0),
+         _misses(0)
+    {
+        for (size_type k = 0; k < CLASSES; ++k)
+        {
+            _head[k] = nullptr;
+            _count[k] = 0;
+        }
+    }
+
+    // Dctor
+    // Frees all cached buffers (at thread exit, for local()).
+    // No-Throw Guarantee
+    ~FSTBufferCache()
+    {
+        flush();
+        if (_isLocal)
+            _localDestroyed() = true;
+    }
+
+    // Uncopyable
+    FSTBufferCache(const FSTBufferCache &) = delete;
+    FSTBufferCache & operator=(const FSTBufferCache &) = delete;
+
+// ***** FSTBufferCache: general public functions *****
+public:
+
+    // local
+    // Return the cache for the calling thread.
+    // No-Throw Guarantee
+    // Pre:
+    //     The calling thread's cache has not been destroyed (see
+    //      localIfAlive).
+    static FSTBufferCache & local() noexcept
+    {
+        static thread_local FSTBufferCache cache(_LocalTag{});
+        return cache;
+    }
+
+    // localIfAlive
+    // Return the cache for the calling thread, or nullptr if it has
+    //  already been destroyed (during thread exit, or, on the main
+    //  thread, during destruction of objects of static storage duration).
+    // No-Throw Guarantee
+    static FSTBufferCache * localIfAlive() noexcept
+    {
+        if (_localDestroyed())
+            return nullptr;
+        return &local();
+    }
+
+    // roundCapacity
+    // Return smallest power of two >= cap (cap itself if cap is 0, or if
+    //  there is no such power of two, so that allocating it fails).
+    // No-Throw Guarantee
+    static constexpr size_type roundCapacity(size_type cap) noexcept
+    {
+        if (cap > MAX_CLASS_CAP)
+            return cap;
+        size_type p = 1;
+        while (p < cap)
+            p <<= 1;
+        return cap == 0 ? 0 : p;
+    }
+
+    // take
+    // Return a cached buffer of exactly cap items, or nullptr if there
+    //  is none.
+    // Pre:
+    //     cap was returned by roundCapacity.
+    // No-Throw Guarantee
+    value_type * take(size_type cap) noexcept
+    {
+        size_type k = _classOf(cap);
+        value_type * buf = (k == CLASSES) ? nullptr : _head[k];
+        if (!_enabled || buf == nullptr || !_fits(cap))
+        {
+            ++_misses;
+            return nullptr;
+        }
+        _head[k] = _next(buf);
+        --_count[k];
+        _bytes -= cap * sizeof(value_type);
+        ++_hits;
+        return buf;
+    }
+
+    // give
+    // Offer a buffer of cap items, allocated with new [], to the cache.
+    //  Returns true if the cache took it; otherwise the caller still
+    //  owns it.
+    // Pre:
+    //     cap was returned by roundCapacity.
+    // No-Throw Guarantee
+    bool give(value_type * buf, size_type cap) noexcept
+    {
+        size_type bytes = cap * sizeof(value_type);
+        size_type k = _classOf(cap);
+        if (!_enabled || k == CLASSES || !_fits(cap)
+         || _count[k] >= _maxPerClass || _bytes + bytes > _maxBytes)
+            return false;
+        _setNext(buf, _head[k]);
+        _head[k] = buf;
+        ++_count[k];
+        _bytes += bytes;
+        return true;
+    }
+
+    // flush
+    // Free every cached buffer.
+    // No-Throw Guarantee
+    void flush() noexcept
+    {
+        for (size_type k = 0; k < CLASSES; ++k)
+        {
+            while (_head[k] != nullptr)
+            {
+                value_type * buf = _head[k];
+                _head[k] = _next(buf);
+                delete [] buf;
+            }
+            _count[k] = 0;
+        }
+        _bytes = 0;
+    }
+
+    // setEnabled
+    // Turn caching on or off. Turning it off flushes the cache.
+    // No-Throw Guarantee
+    void setEnabled(bool enabled) noexcept
+    {
+        _enabled = enabled;
+        if (!enabled)
+            flush();
+    }
+
+    // setLimits
+    // Set per-class buffer count & total byte limits. Buffers already
+    //  cached are kept until taken or flushed.
+    // No-Throw Guarantee
+    void setLimits(size_type maxPerClass, size_type maxBytes) noexcept
+    {
+        _maxPerClass = maxPerClass;
+        _maxBytes = maxBytes;
+    }
+
+    // Statistics
+    // No-Throw Guarantee
+    size_type cachedBytes() const noexcept
+    {
+        return _bytes;
+    }
+
+    size_type hits() const noexcept
+    {
+        return _hits;
+    }
+
+    size_type misses() const noexcept
+    {
+        return _misses;
+    }
+
+// ***** FSTBufferCache: internal-use functions *****
+private:
+
+    // struct _LocalTag
+    // Selects the ctor used by local().
+    struct _LocalTag {};
+
+    // Ctor for local()
+    // No-Throw Guarantee
+    explicit FSTBufferCache(_LocalTag) noexcept
+        :FSTBufferCache()
+    {
+        _isLocal = true;
+    }
+
+    // _localDestroyed
+    // Return flag, set when the calling thread's local() cache is
+    //  destroyed. A trivially destructible thread_local, so it may be
+    //  read until the thread ends.
+    static bool & _localDestroyed() noexcept
+    {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    // _classOf
+    // Return k such that cap == 2^k, or CLASSES if cap > MAX_CLASS_CAP.
+    static size_type _classOf(size_type cap) noexcept
+    {
+        if (cap > MAX_CLASS_CAP)
+            return CLASSES;
+        size_type k = 0;
+        while ((size_type(1) << k) < cap)
+            ++k;
+        return k;
+    }
+
+    // _fits
+    // Return true if a buffer of cap items can hold the list link.
+    static bool _fits(size_type cap) noexcept
+    {
+        return cap * sizeof(value_type) >= sizeof(value_type *);
+    }
+
+    // _next, _setNext
+    // Read/write the list link stored at the start of a cached buffer.
+    static value_type * _next(value_type * buf) noexcept
+    {
+        value_type * next;
+        std::memcpy(&next, static_cast<void *>(buf), sizeof next);
+        return next;
+    }
+
+    static void _setNext(value_type * buf, value_type * next) noexcept
+    {
+        std::memcpy(static_cast<void *>(buf), &next, sizeof next);
+    }
+
+// ***** FSTBufferCache: data members *****
+private:
+
+    bool         _isLocal;           // This is a thread's local() cache
+    bool         _enabled;           // Cache takes & hands out buffers
+    size_type    _maxPerClass;       // Limit on buffers per class
+    size_type    _maxBytes;          // Limit on total cached bytes
+    size_type    _bytes;             // Total cached bytes
+    size_type    _hits;              // take calls that returned a buffer
+    size_type    _misses;            // take calls that did not
+    value_type * _head[CLASSES];     // Free list for each class
+    size_type    _count[CLASSES];    // Length of each free list
+
+};  // End class FSTBufferCache
+
+
+#endif  //#ifndef FILE_FSTBUFFERCACHE_H_INCLUDED
+
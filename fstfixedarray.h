@@ -0,0 +1,245 @@
+// fstfixedarray.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Fixed-capacity, non-allocating sibling of FSTArray; usable in
+//  constant expressions
+
+#ifndef FILE_FSTFIXEDARRAY_H_INCLUDED
+#define FILE_FSTFIXEDARRAY_H_INCLUDED
+
+#include <cstddef>
+// For std::size_t
+#include <stdexcept>
+// For std::out_of_range
+// For std::length_error
+
+// *********************************************************************
+// class FSTFixedArray - Class definition
+// *********************************************************************
+
+
+// class FSTFixedArray
+// Resizable array of at most N items, stored inside the object (no heap
+//  use). Same interface as FSTArray, except that capacity() is always N
+//  and growing past N throws std::length_error. Every member function is
+//  constexpr, so arrays -- e.g., lookup tables -- can be built at compile
+//  time.
+// All N items always exist; those at positions size() and above hold
+//  value_type() or left-over values.
+// Invariants:
+//     0 <= _size <= N.
+// Requirements on Types:
+//     value_type is default-constructible & copy-assignable; for
+//      constexpr use, these must be constexpr.
+//     N > 0.
+//
+// value_type = value type of array elements
+// N = capacity
+template <typename valType, std::size_t N>
+class FSTFixedArray {
+
+    static_assert(N > 0, "FSTFixedArray capacity must be positive");
+
+// ***** FSTFixedArray: types *****
+public:
+
+    // value_type: type of data items
+    using value_type = valType;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+
+    // iterator, const_iterator: random-access iterator types
+    using iterator = value_type *;
+    using const_iterator = const value_type *;
+
+// ***** FSTFixedArray: ctors, op=, dctor *****
+public:
+
+    // Default ctor & ctor from size
+    // Throws std::length_error if size > N.
+    // Strong Guarantee
+    constexpr explicit FSTFixedArray(size_type size=0)
+        :_size(_checkSize(size)),
+         _data{}
+    {}
+
+    // Compiler-generated copy/move ctor, copy/move op=, dctor are used.
+    // They copy all N items, and are constexpr.
+
+// ***** FSTFixedArray: general public operators *****
+public:
+
+    // operator[] - non-const & const
+    // Pre:
+    //     index < size().
+    // No-Throw Guarantee
+    constexpr value_type & operator[](size_type index)
+    {
+        return _data[index];
+    }
+
+    constexpr const value_type & operator[](size_type index) const
+    {
+        return _data[index];
+    }
+
+// ***** FSTFixedArray: general public functions *****
+public:
+
+    // at - non-const & const
+    // Throws std::out_of_range if index >= size().
+    // Strong Guarantee
+    constexpr value_type & at(size_type index)
+    {
+        if (index >= _size)
+            throw std::out_of_range("FSTFixedArray::at: index out of range");
+        return _data[index];
+    }
+
+    constexpr const value_type & at(size_type index) const
+    {
+        if (index >= _size)
+            throw std::out_of_range("FSTFixedArray::at: index out of range");
+        return _data[index];
+    }
+
+    // size, empty, capacity
+    // No-Throw Guarantee
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] static constexpr size_type capacity() noexcept
+    {
+        return N;
+    }
+
+    // begin, end - non-const & const
+    // No-Throw Guarantee
+    constexpr iterator begin() noexcept
+    {
+        return _data;
+    }
+    constexpr const_iterator begin() const noexcept
+    {
+        return _data;
+    }
+
+    constexpr iterator end() noexcept
+    {
+        return _data + _size;
+    }
+    constexpr const_iterator end() const noexcept
+    {
+        return _data + _size;
+    }
+
+    // resize
+    // Throws std::length_error if newsize > N.
+    // Strong Guarantee
+    constexpr void resize(size_type newsize)
+    {
+        _size = _checkSize(newsize);
+    }
+
+    // insert
+    // Throws std::length_error if size() == N.
+    // Pre:
+    //     pos is in [begin(), end()].
+    // Strong Guarantee if value_type copy assignment cannot throw;
+    //  otherwise Basic Guarantee.
+    // Exception neutral
+    constexpr iterator insert(iterator pos, const value_type & item)
+    {
+        size_type index = size_type(pos - _data);
+        _checkSize(_size + 1);
+        value_type copy = item;  // item may be one of ours
+        for (size_type i = _size; i > index; --i)
+            _data[i] = _data[i-1];
+        _data[index] = copy;
+        ++_size;
+        return _data + index;
+    }
+
+    // erase
+    // Pre:
+    //     pos is in [begin(), end()).
+    // Strong Guarantee if value_type copy assignment cannot throw;
+    //  otherwise Basic Guarantee.
+    // Exception neutral
+    constexpr iterator erase(iterator pos)
+    {
+        size_type index = size_type(pos - _data);
+        for (size_type i = index; i + 1 < _size; ++i)
+            _data[i] = _data[i+1];
+        --_size;
+        return _data + index;
+    }
+
+    // push_back
+    // Throws std::length_error if size() == N.
+    // Strong Guarantee
+    // Exception neutral
+    constexpr void push_back(const value_type & item)
+    {
+        _checkSize(_size + 1);
+        _data[_size] = item;
+        ++_size;
+    }
+
+    // pop_back
+    // Pre:
+    //     size() > 0.
+    // No-Throw Guarantee
+    constexpr void pop_back() noexcept
+    {
+        --_size;
+    }
+
+    // swap
+    // Swaps all N items.
+    // Exception neutral
+    constexpr void swap(FSTFixedArray & other)
+    {
+        for (size_type i = 0; i < N; ++i)
+        {
+            value_type temp = _data[i];
+            _data[i] = other._data[i];
+            other._data[i] = temp;
+        }
+        size_type tempSize = _size;
+        _size = other._size;
+        other._size = tempSize;
+    }
+
+// ***** FSTFixedArray: internal-use functions *****
+private:
+
+    // _checkSize
+    // Return size; throw std::length_error if size > N.
+    static constexpr size_type _checkSize(size_type size)
+    {
+        if (size > N)
+            throw std::length_error("FSTFixedArray: size exceeds capacity");
+        return size;
+    }
+
+// ***** FSTFixedArray: data members *****
+private:
+
+    size_type  _size;     // Size of client's data
+    value_type _data[N];  // Our items
+
+};  // End class FSTFixedArray
+
+
+#endif  //#ifndef FILE_FSTFIXEDARRAY_H_INCLUDED
+
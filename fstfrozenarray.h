@@ -0,0 +1,387 @@
+// fstfrozenarray.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Immutable compressed snapshot of an FSTArray<int>, with random access
+
+#ifndef FILE_FSTFROZENARRAY_H_INCLUDED
+#define FILE_FSTFROZENARRAY_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::int64_t
+// For std::int32_t
+// For std::uint64_t
+// For std::uint32_t
+#include <algorithm>
+// For std::min
+// For std::max
+#include <bit>
+// For std::bit_width
+#include <limits>
+// For std::numeric_limits
+#include <stdexcept>
+// For std::out_of_range
+#include <utility>
+// For std::index_sequence
+// For std::make_index_sequence
+
+// *********************************************************************
+// class FSTFrozenArray - Class definition
+// *********************************************************************
+
+
+// class FSTFrozenArray
+// Read-only, compressed copy of an FSTArray<int>. Made by freezing an
+//  array (ctor), turned back into one by thaw.
+// Items are compressed in blocks of BLOCK = 128, each by frame of
+//  reference around a line: item j of a block is stored as
+//      item - (base + slope*j),
+//  a non-negative number packed in width bits. slope is 0 (plain frame
+//  of reference: base = block minimum), or the block's average step,
+//  whichever needs fewer bits; the line makes sorted data (IDs,
+//  timestamps) pack as tightly as its gaps rather than its range. No
+//  block needs more than 32 bits.
+// 128 items of width bits take exactly 2*width 64-bit words, so every
+//  block starts on a word boundary. Item access is O(1): a block lookup
+//  and a one- or two-word read. decodeBlock unpacks a whole block with
+//  code generated for its width -- unrolled, branch-free, every shift a
+//  constant -- and is the fast way to scan (forEach, thaw).
+// Invariants:
+//     _blocks.size() == ceil(_size / BLOCK).
+//     For each block b: b.width <= 32, and its packed items are
+//      _words[b.offset .. b.offset + 2*b.width - 1].
+//     Packed bits past item _size-1 are 0.
+class FSTFrozenArray {
+
+// ***** FSTFrozenArray: types *****
+public:
+
+    // value_type: type of data items
+    using value_type = int;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+    // word_type: storage unit
+    using word_type = std::uint64_t;
+
+    // Items per block
+    enum { BLOCK = 128 };
+
+// ***** FSTFrozenArray: internal-use types *****
+private:
+
+    // struct _Block
+    // Header of one block.
+    struct _Block {
+        std::int64_t  base;    // Line value at item 0
+        std::int32_t  slope;   // Line step per item
+        std::uint32_t width;   // Bits per packed item, 0 .. 32
+        size_type     offset;  // Index of first word in _words
+    };
+
+// ***** FSTFrozenArray: ctors *****
+public:
+
+    // Default ctor
+    // Empty frozen array.
+    // Strong Guarantee
+    FSTFrozenArray()
+        :_blocks(0),
+         _words(0),
+         _size(0)
+    {}
+
+    // Ctor from FSTArray<int> ("freeze")
+    // Strong Guarantee
+    // Exception neutral
+    explicit FSTFrozenArray(const FSTArray<int> & arr)
+        :_blocks((arr.size() + BLOCK - 1) / BLOCK),
+         _words(0),
+         _size(arr.size())
+    {
+        // Pass 1: choose each block's line & width
+        size_type totalWords = 0;
+        for (size_type b = 0; b < _blocks.size(); ++b)
+        {
+            size_type first = b * BLOCK;
+            size_type n = std::min(size_type(BLOCK), _size - first);
+            _blocks[b] = _chooseLine(&arr[first], n);
+            _blocks[b].offset = totalWords;
+            totalWords += 2 * _blocks[b].width;
+        }
+
+        // Pass 2: pack (into exactly totalWords; resize would round up)
+        _words = FSTArray<word_type>(totalWords);
+        for (size_type k = 0; k < totalWords; ++k)
+            _words[k] = 0;
+        for (size_type b = 0; b < _blocks.size(); ++b)
+        {
+            const _Block & blk = _blocks[b];
+            if (blk.width == 0)
+                continue;
+            size_type first = b * BLOCK;
+            size_type n = std::min(size_type(BLOCK), _size - first);
+            word_type * dest = &_words[blk.offset];
+            for (size_type j = 0; j < n; ++j)
+            {
+                word_type v = word_type(std::int64_t(arr[first+j])
+                                        - _line(blk, j));
+                size_type bit = j * blk.width;
+                unsigned off = unsigned(bit % 64);
+                dest[bit/64] |= v << off;
+                if (off + blk.width > 64)
+                    dest[bit/64 + 1] |= v >> (64 - off);
+            }
+        }
+    }
+
+    // Compiler-generated copy/move ctor, copy/move op=, dctor are used.
+
+// ***** FSTFrozenArray: general public operators *****
+public:
+
+    // operator[]
+    // Pre:
+    //     index < size().
+    // No-Throw Guarantee
+    value_type operator[](size_type index) const noexcept
+    {
+        const _Block & blk = _blocks[index / BLOCK];
+        size_type j = index % BLOCK;
+        return value_type(_line(blk, j) + std::int64_t(_extract(blk, j)));
+    }
+
+// ***** FSTFrozenArray: general public functions *****
+public:
+
+    // at
+    // Throws std::out_of_range if index >= size().
+    // Strong Guarantee
+    value_type at(size_type index) const
+    {
+        if (index >= _size)
+            throw std::out_of_range("FSTFrozenArray::at: index out of range");
+        return (*this)[index];
+    }
+
+    // size, empty
+    // No-Throw Guarantee
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    // bytes
+    // Return bytes of storage allocated: packed items & block headers.
+    // No-Throw Guarantee
+    [[nodiscard]] size_type bytes() const noexcept
+    {
+        return _words.capacity() * sizeof(word_type)
+             + _blocks.capacity() * sizeof(_Block);
+    }
+
+    // decodeBlock
+    // Write the items of block b to out; return how many there are
+    //  (BLOCK, except for the last block).
+    // Pre:
+    //     b < ceil(size() / BLOCK); out has room for BLOCK items.
+    // No-Throw Guarantee
+    size_type decodeBlock(size_type b,
+                          value_type * out) const noexcept
+    {
+        const _Block & blk = _blocks[b];
+        std::uint32_t packed[BLOCK];
+        _unpackAny(blk.width,
+                   blk.width == 0 ? nullptr : &_words[blk.offset],
+                   packed);
+        size_type n = std::min(size_type(BLOCK), _size - b * BLOCK);
+        for (size_type j = 0; j < n; ++j)
+            out[j] = value_type(blk.base + std::int64_t(blk.slope)
+                                           * std::int64_t(j)
+                                         + std::int64_t(packed[j]));
+        return n;
+    }
+
+    // forEach
+    // Call f(item) for each item, in order, decoding a block at a time.
+    // Requirements on Types:
+    //     F is callable with a value_type.
+    // Exception neutral
+    template <typename F>
+    void forEach(F f) const
+    {
+        value_type buf[BLOCK];
+        for (size_type b = 0; b < _blocks.size(); ++b)
+        {
+            size_type n = decodeBlock(b, buf);
+            for (size_type j = 0; j < n; ++j)
+                f(buf[j]);
+        }
+    }
+
+    // thaw
+    // Return an FSTArray<int> holding the same items.
+    // Strong Guarantee
+    // Exception neutral
+    FSTArray<int> thaw() const
+    {
+        FSTArray<int> result(_size);
+        value_type buf[BLOCK];
+        for (size_type b = 0; b < _blocks.size(); ++b)
+        {
+            size_type n = decodeBlock(b, buf);
+            std::copy(buf, buf + n, &result[b * BLOCK]);
+        }
+        return result;
+    }
+
+// ***** FSTFrozenArray: internal-use functions *****
+private:
+
+    // _line
+    // Return value of blk's line at item j.
+    static std::int64_t _line(const _Block & blk,
+                              size_type j) noexcept
+    {
+        return blk.base + std::int64_t(blk.slope) * std::int64_t(j);
+    }
+
+    // _extract
+    // Return packed value of item j of blk.
+    word_type _extract(const _Block & blk,
+                       size_type j) const noexcept
+    {
+        if (blk.width == 0)
+            return 0;
+        const word_type * src = &_words[blk.offset];
+        size_type bit = j * blk.width;
+        unsigned off = unsigned(bit % 64);
+        word_type v = src[bit/64] >> off;
+        if (off + blk.width > 64)
+            v |= src[bit/64 + 1] << (64 - off);
+        return v & ((word_type(1) << blk.width) - 1);
+    }
+
+    // _chooseLine
+    // Return header (without offset) for the n items at p: plain frame
+    //  of reference, or a sloped line, whichever packs narrower.
+    static _Block _chooseLine(const int * p,
+                              size_type n) noexcept
+    {
+        _Block flat = _fit(p, n, 0);
+        std::int64_t step = n > 1
+            ? (std::int64_t(p[n-1]) - std::int64_t(p[0]))
+                  / std::int64_t(n-1)
+            : 0;
+        if (step == 0
+            || step > std::numeric_limits<std::int32_t>::max()
+            || step < std::numeric_limits<std::int32_t>::min())
+            return flat;
+        _Block sloped = _fit(p, n, std::int32_t(step));
+        return sloped.width < flat.width ? sloped : flat;
+    }
+
+    // _fit
+    // Return header (without offset) for the n items at p on a line of
+    //  the given slope, with the least base that keeps every residual
+    //  non-negative. Width may exceed 32 for a sloped line; the caller
+    //  then uses the flat one, whose width is at most 32.
+    static _Block _fit(const int * p,
+                       size_type n,
+                       std::int32_t slope) noexcept
+    {
+        std::int64_t lo = std::numeric_limits<std::int64_t>::max();
+        std::int64_t hi = std::numeric_limits<std::int64_t>::min();
+        for (size_type j = 0; j < n; ++j)
+        {
+            std::int64_t r = std::int64_t(p[j])
+                           - std::int64_t(slope) * std::int64_t(j);
+            lo = std::min(lo, r);
+            hi = std::max(hi, r);
+        }
+        unsigned width = unsigned(std::bit_width(std::uint64_t(hi - lo)));
+        return _Block{ lo, slope, width, 0 };
+    }
+
+    // _unpackOne
+    // Return item j of a run of 64 packed items of the given width at s.
+    //  Every shift is a compile-time constant.
+    template <unsigned width, unsigned j>
+    static std::uint32_t _unpackOne(const word_type * s) noexcept
+    {
+        constexpr word_type MASK = (word_type(1) << width) - 1;
+        constexpr unsigned BIT = j * width;
+        constexpr unsigned OFF = BIT % 64;
+        word_type v = s[BIT/64] >> OFF;
+        if constexpr (OFF + width > 64)
+            v |= s[BIT/64 + 1] << (64 - OFF);
+        return std::uint32_t(v & MASK);
+    }
+
+    // _unpack
+    // Unpack the BLOCK items of a block of the given width from src to
+    //  out: two runs of 64 items, each exactly width words, fully
+    //  unrolled, with no branches.
+    template <unsigned width>
+    static void _unpack(const word_type * src,
+                        std::uint32_t * out) noexcept
+    {
+        if constexpr (width == 0)
+        {
+            for (unsigned j = 0; j < BLOCK; ++j)
+                out[j] = 0;
+        }
+        else
+        {
+            [&]<std::size_t... j>(std::index_sequence<j...>)
+            {
+                ((out[j] = _unpackOne<width, unsigned(j)>(src)), ...);
+                ((out[64+j] = _unpackOne<width, unsigned(j)>(src + width)),
+                 ...);
+            }(std::make_index_sequence<64>());
+        }
+    }
+
+    using _Unpacker = void (*)(const word_type *, std::uint32_t *);
+
+    // _makeUnpackers
+    // Return table of _unpack<0> .. _unpack<32>.
+    template <std::size_t... widths>
+    static constexpr auto _makeUnpackers(std::index_sequence<widths...>)
+    {
+        struct Table { _Unpacker f[sizeof...(widths)]; };
+        return Table{ { &_unpack<unsigned(widths)>... } };
+    }
+
+    // _unpackAny
+    // Call _unpack<width> for a width known only at run time.
+    static void _unpackAny(unsigned width,
+                           const word_type * src,
+                           std::uint32_t * out) noexcept
+    {
+        static constexpr auto table =
+            _makeUnpackers(std::make_index_sequence<33>());
+        table.f[width](src, out);
+    }
+
+// ***** FSTFrozenArray: data members *****
+private:
+
+    FSTArray<_Block>    _blocks;  // One header per block
+    FSTArray<word_type> _words;   // Packed items of all blocks
+    size_type           _size;    // Number of items
+
+};  // End class FSTFrozenArray
+
+
+#endif  //#ifndef FILE_FSTFROZENARRAY_H_INCLUDED
+
@@ -0,0 +1,213 @@
+// fsthistogram.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Log-linear (HDR-style) histogram of latencies, for profiling FSTArray
+
+#ifndef FILE_FSTHISTOGRAM_H_INCLUDED
+#define FILE_FSTHISTOGRAM_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::uint64_t
+#include <algorithm>
+// For std::fill
+// For std::min
+// For std::max
+#include <bit>
+// For std::bit_width
+
+// *********************************************************************
+// class FSTHistogram - Class definition
+// *********************************************************************
+
+
+// class FSTHistogram
+// Counts of non-negative integer values (e.g., nanoseconds), in
+//  log-linear buckets, like HdrHistogram: values below SUB are counted
+//  exactly; above that, each power-of-two range is split into SUB/2
+//  equal buckets. So a reported value is within 1/64 (about 1.6%) of
+//  the true one, over the whole 64-bit range, in a fixed 30 KB.
+// record is O(1), with no allocation, so it can sit in a timing loop.
+// Invariants:
+//     _counts.size() == BUCKETS.
+//     _total == sum of _counts.
+//     If _total > 0: _min & _max are the least & greatest values
+//      recorded, and _sum is the sum of all values recorded.
+class FSTHistogram {
+
+// ***** FSTHistogram: types *****
+public:
+
+    using value_type = std::uint64_t;
+    using size_type = std::size_t;
+
+// ***** FSTHistogram: internal-use constants *****
+private:
+
+    // Values below SUB get a bucket each; SUB = 2^SUB_BITS
+    enum { SUB_BITS = 7 };
+    enum { SUB = 1 << SUB_BITS };
+    enum { HALF = SUB / 2 };
+
+    // One linear range, then HALF buckets per further power of two
+    enum { BUCKETS = SUB + (64 - SUB_BITS) * HALF };
+
+// ***** FSTHistogram: ctors *****
+public:
+
+    // Default ctor
+    // Strong Guarantee
+    FSTHistogram()
+        :_counts(BUCKETS)
+    {
+        reset();
+    }
+
+    // Compiler-generated copy/move ctor, copy/move op=, dctor are used.
+
+// ***** FSTHistogram: general public functions *****
+public:
+
+    // record
+    // Count value, n times.
+    // No-Throw Guarantee
+    void record(value_type value,
+                value_type n=1) noexcept
+    {
+        _counts[_bucketOf(value)] += n;
+        if (_total == 0)
+        {
+            _min = value;
+            _max = value;
+        }
+        else
+        {
+            _min = std::min(_min, value);
+            _max = std::max(_max, value);
+        }
+        _total += n;
+        _sum += double(value) * double(n);
+    }
+
+    // merge
+    // Add all counts of other to *this.
+    // No-Throw Guarantee
+    void merge(const FSTHistogram & other) noexcept
+    {
+        if (other._total == 0)
+            return;
+        for (size_type i = 0; i < size_type(BUCKETS); ++i)
+            _counts[i] += other._counts[i];
+        _min = (_total == 0) ? other._min : std::min(_min, other._min);
+        _max = (_total == 0) ? other._max : std::max(_max, other._max);
+        _total += other._total;
+        _sum += other._sum;
+    }
+
+    // reset
+    // Remove all counts.
+    // No-Throw Guarantee
+    void reset() noexcept
+    {
+        std::fill(_counts.begin(), _counts.end(), value_type(0));
+        _total = 0;
+        _min = 0;
+        _max = 0;
+        _sum = 0.0;
+    }
+
+    // count, min, max, mean
+    // Return 0 if nothing was recorded.
+    // No-Throw Guarantee
+    [[nodiscard]] value_type count() const noexcept
+    {
+        return _total;
+    }
+
+    [[nodiscard]] value_type min() const noexcept
+    {
+        return _min;
+    }
+
+    [[nodiscard]] value_type max() const noexcept
+    {
+        return _max;
+    }
+
+    [[nodiscard]] double mean() const noexcept
+    {
+        return _total == 0 ? 0.0 : _sum / double(_total);
+    }
+
+    // percentile
+    // Return the p-th percentile (0 <= p <= 100) of recorded values: the
+    //  highest value in the bucket holding the sample of that rank,
+    //  clamped to [min(), max()]. So percentile(100) == max() exactly.
+    //  Returns 0 if nothing was recorded.
+    // No-Throw Guarantee
+    [[nodiscard]] value_type percentile(double p) const noexcept
+    {
+        if (_total == 0)
+            return 0;
+        // Rank of wanted sample, 1 .. _total
+        auto rank = value_type(p / 100.0 * double(_total) + 0.5);
+        rank = std::min(std::max(rank, value_type(1)), _total);
+
+        value_type seen = 0;
+        for (size_type i = 0; i < size_type(BUCKETS); ++i)
+        {
+            seen += _counts[i];
+            if (seen >= rank)
+                return std::min(std::max(_highestIn(i), _min), _max);
+        }
+        return _max;
+    }
+
+// ***** FSTHistogram: internal-use functions *****
+private:
+
+    // _bucketOf
+    // Return index of bucket counting value.
+    // No-Throw Guarantee
+    static size_type _bucketOf(value_type value) noexcept
+    {
+        if (value < value_type(SUB))
+            return size_type(value);
+        // shift >= 1; top is in [HALF, SUB)
+        int shift = int(std::bit_width(value)) - SUB_BITS;
+        auto top = size_type(value >> shift);
+        return size_type(SUB) + size_type(shift-1) * size_type(HALF)
+             + (top - size_type(HALF));
+    }
+
+    // _highestIn
+    // Return the highest value counted by bucket i.
+    // No-Throw Guarantee
+    static value_type _highestIn(size_type i) noexcept
+    {
+        if (i < size_type(SUB))
+            return value_type(i);
+        int shift = int((i - SUB) / HALF) + 1;
+        auto top = value_type((i - SUB) % HALF + HALF);
+        return ((top + 1) << shift) - 1;
+    }
+
+// ***** FSTHistogram: data members *****
+private:
+
+    FSTArray<value_type> _counts;  // Count for each bucket
+    value_type           _total;   // Number of values recorded
+    value_type           _min;     // Least value recorded
+    value_type           _max;     // Greatest value recorded
+    double               _sum;     // Sum of values recorded
+
+};  // End class FSTHistogram
+
+
+#endif  //#ifndef FILE_FSTHISTOGRAM_H_INCLUDED
+
@@ -0,0 +1,685 @@
+// fstpackedarray.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Bit-packed arrays: N-bit unsigned integers, and bits, built on
+//  FSTArray
+
+#ifndef FILE_FSTPACKEDARRAY_H_INCLUDED
+#define FILE_FSTPACKEDARRAY_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+// For std::ptrdiff_t
+#include <cstdint>
+// For std::uint64_t
+// For std::uint32_t
+#include <bit>
+// For std::popcount
+// For std::countr_zero
+#include <iterator>
+// For std::random_access_iterator_tag
+#include <stdexcept>
+// For std::out_of_range
+#include <type_traits>
+// For std::conditional_t
+// For std::enable_if_t
+#include <utility>
+// For std::swap
+
+// *********************************************************************
+// class FSTPackedIter - Class definition
+// *********************************************************************
+
+
+// class FSTPackedIter
+// Random-access iterator for FSTPackedArray: an array pointer & an
+//  index. Dereferencing gives a proxy (non-const) or a value (const).
+//  Like std::vector<bool>'s iterators, these are not true random-access
+//  iterators, since the reference type is not a real reference; they
+//  work with algorithms that only read & assign through them.
+// Invariants:
+//     _arr == nullptr, or _arr points to the array this iterator was
+//      obtained from.
+// Requirements on Types:
+//     Container is FSTPackedArray<...>, possibly const.
+template <typename Container, bool isConst>
+class FSTPackedIter {
+
+    // Other instantiation, for iterator -> const_iterator conversion
+    template <typename C, bool K>
+    friend class FSTPackedIter;
+
+// ***** FSTPackedIter: types *****
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename Container::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::conditional_t<isConst,
+                                         value_type,
+                                         typename Container::reference>;
+    using size_type = std::size_t;
+    using container_ptr = std::conditional_t<isConst,
+                                             const Container *,
+                                             Container *>;
+
+// ***** FSTPackedIter: ctors *****
+public:
+
+    // Default ctor
+    // No-Throw Guarantee
+    FSTPackedIter() noexcept
+        :_arr(nullptr),
+         _index(0)
+    {}
+
+    // Ctor from array & index
+    // Used by FSTPackedArray only.
+    // No-Throw Guarantee
+    FSTPackedIter(container_ptr arr,
+                  size_type index) noexcept
+        :_arr(arr),
+         _index(index)
+    {}
+
+    // Converting ctor: iterator -> const_iterator
+    // No-Throw Guarantee
+    template <bool otherConst,
+              typename = std::enable_if_t<isConst && !otherConst>>
+    FSTPackedIter(const FSTPackedIter<Container, otherConst> & other)
+        noexcept
+        :_arr(other._arr),
+         _index(other._index)
+    {}
+
+// ***** FSTPackedIter: general public functions *****
+public:
+
+    // index
+    // Return position in the array.
+    // No-Throw Guarantee
+    size_type index() const noexcept
+    {
+        return _index;
+    }
+
+// ***** FSTPackedIter: operators *****
+public:
+
+    // No-Throw Guarantee for all of these
+
+    reference operator*() const noexcept
+    {
+        return (*_arr)[_index];
+    }
+
+    reference operator[](difference_type n) const noexcept
+    {
+        return (*_arr)[size_type(difference_type(_index) + n)];
+    }
+
+    FSTPackedIter & operator++() noexcept
+    {
+        ++_index;
+        return *this;
+    }
+
+    FSTPackedIter operator++(int) noexcept
+    {
+        auto save = *this;
+        ++_index;
+        return save;
+    }
+
+    FSTPackedIter & operator--() noexcept
+    {
+        --_index;
+        return *this;
+    }
+
+    FSTPackedIter operator--(int) noexcept
+    {
+        auto save = *this;
+        --_index;
+        return save;
+    }
+
+    FSTPackedIter & operator+=(difference_type n) noexcept
+    {
+        _index = size_type(difference_type(_index) + n);
+        return *this;
+    }
+
+    FSTPackedIter & operator-=(difference_type n) noexcept
+    {
+        _index = size_type(difference_type(_index) - n);
+        return *this;
+    }
+
+    friend FSTPackedIter operator+(FSTPackedIter it,
+                                   difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    friend FSTPackedIter operator+(difference_type n,
+                                   FSTPackedIter it) noexcept
+    {
+        return it += n;
+    }
+
+    friend FSTPackedIter operator-(FSTPackedIter it,
+                                   difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    // Difference & comparisons work between iterator & const_iterator.
+    template <bool otherConst>
+    difference_type operator-(
+        const FSTPackedIter<Container, otherConst> & other) const noexcept
+    {
+        return difference_type(_index) - difference_type(other._index);
+    }
+
+    template <bool otherConst>
+    bool operator==(
+        const FSTPackedIter<Container, otherConst> & other) const noexcept
+    {
+        return _index == other._index;
+    }
+
+    template <bool otherConst>
+    bool operator!=(
+        const FSTPackedIter<Container, otherConst> & other) const noexcept
+    {
+        return _index != other._index;
+    }
+
+    template <bool otherConst>
+    bool operator<(
+        const FSTPackedIter<Container, otherConst> & other) const noexcept
+    {
+        return _index < other._index;
+    }
+
+// ***** FSTPackedIter: data members *****
+private:
+
+    container_ptr _arr;    // Array we iterate over
+    size_type     _index;  // Item we refer to
+
+};  // End class FSTPackedIter
+
+
+// *********************************************************************
+// class FSTPackedArray - Class definition
+// *********************************************************************
+
+
+// class FSTPackedArray
+// Resizable array of unsigned integers of bits bits each, packed into
+//  64-bit words: 64/bits items per word, low item first. Items never
+//  straddle words, so for bits not dividing 64, the top 64 % bits bits
+//  of each word are unused. With bits == 1 this is a bit array; see
+//  FSTBitArray below.
+// Same interface as FSTArray (resize, insert, erase, push_back, ...),
+//  with a proxy reference type, plus whole-array routines that work a
+//  word at a time: popcount, count, find, unpack. These use std::popcount
+//  & SWAR (SIMD within a register) tricks on plain 64-bit words, so they
+//  compile to tight loops the optimizer can vectorize; no instruction
+//  set is required.
+// New items (resize, ctor) are 0. Values stored are cut to their low
+//  bits bits.
+// Invariants:
+//     _words.size() == number of words holding items 0 .. _size-1.
+//     Item slots at positions >= _size in those words are 0; unused
+//      top bits of every word are 0.
+//
+// bits = bits per item, 1 .. 32
+template <unsigned bits>
+class FSTPackedArray {
+
+    static_assert(bits >= 1 && bits <= 32,
+                  "FSTPackedArray bits must be in 1 .. 32");
+
+// ***** FSTPackedArray: types *****
+public:
+
+    // value_type: type of items; bool for 1-bit items
+    using value_type = std::conditional_t<bits == 1, bool, std::uint32_t>;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+    // word_type: storage unit
+    using word_type = std::uint64_t;
+
+    // class reference
+    // Proxy for one item: converts to value_type, and assigns to the
+    //  item.
+    class reference {
+    public:
+
+        reference(FSTPackedArray & arr, size_type index) noexcept
+            :_arr(arr),
+             _index(index)
+        {}
+
+        operator value_type() const noexcept
+        {
+            return _arr.get(_index);
+        }
+
+        reference & operator=(value_type v) noexcept
+        {
+            _arr.set(_index, v);
+            return *this;
+        }
+
+        reference & operator=(const reference & other) noexcept
+        {
+            _arr.set(_index, value_type(other));
+            return *this;
+        }
+
+    private:
+
+        FSTPackedArray & _arr;
+        size_type        _index;
+
+    };  // End class reference
+
+    // iterator, const_iterator: random-access proxy iterators
+    using iterator = FSTPackedIter<FSTPackedArray, false>;
+    using const_iterator = FSTPackedIter<FSTPackedArray, true>;
+
+// ***** FSTPackedArray: internal-use constants *****
+private:
+
+    static constexpr unsigned  PER_WORD = 64 / bits;  // Items per word
+    static constexpr word_type MASK = (word_type(1) << bits) - 1;
+    static constexpr unsigned  TOP_SHIFT = (PER_WORD - 1) * bits;
+    static constexpr word_type USED =            // Bits holding items
+        PER_WORD * bits == 64 ? ~word_type(0)
+                              : (word_type(1) << (PER_WORD * bits)) - 1;
+
+    // _broadcast
+    // Return a word with every item slot holding v.
+    static constexpr word_type _broadcast(word_type v) noexcept
+    {
+        word_type w = 0;
+        for (unsigned i = 0; i < PER_WORD; ++i)
+            w |= v << (i * bits);
+        return w;
+    }
+
+    static constexpr word_type LOW_ONES = _broadcast(1);
+    static constexpr word_type HIGH_BITS = _broadcast(word_type(1)
+                                                      << (bits-1));
+
+// ***** FSTPackedArray: ctors *****
+public:
+
+    // Default ctor & ctor from size
+    // All items are 0.
+    // Strong Guarantee
+    explicit FSTPackedArray(size_type size=0)
+        :_words(_wordsFor(size)),
+         _size(size)
+    {
+        for (size_type k = 0; k < _words.size(); ++k)
+            _words[k] = 0;
+    }
+
+    // Compiler-generated copy/move ctor, copy/move op=, dctor are used.
+
+// ***** FSTPackedArray: general public operators *****
+public:
+
+    // operator[] - non-const & const
+    // Pre:
+    //     index < size().
+    // No-Throw Guarantee
+    reference operator[](size_type index) noexcept
+    {
+        return reference(*this, index);
+    }
+
+    value_type operator[](size_type index) const noexcept
+    {
+        return get(index);
+    }
+
+// ***** FSTPackedArray: general public functions *****
+public:
+
+    // get, set
+    // Read/write item at index. set keeps the low bits bits of v.
+    // Pre:
+    //     index < size().
+    // No-Throw Guarantee
+    value_type get(size_type index) const noexcept
+    {
+        word_type w = _words[index / PER_WORD];
+        return value_type((w >> _shiftOf(index)) & MASK);
+    }
+
+    void set(size_type index,
+             value_type v) noexcept
+    {
+        word_type & w = _words[index / PER_WORD];
+        unsigned shift = _shiftOf(index);
+        w = (w & ~(MASK << shift)) | ((word_type(v) & MASK) << shift);
+    }
+
+    // at - const
+    // Throws std::out_of_range if index >= size().
+    // Strong Guarantee
+    value_type at(size_type index) const
+    {
+        if (index >= _size)
+            throw std::out_of_range("FSTPackedArray::at: index out of range");
+        return get(index);
+    }
+
+    // size, empty, capacity
+    // capacity is in items.
+    // No-Throw Guarantee
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return _words.capacity() * PER_WORD;
+    }
+
+    // bytes
+    // Return bytes of storage allocated for items.
+    // No-Throw Guarantee
+    [[nodiscard]] size_type bytes() const noexcept
+    {
+        return _words.capacity() * sizeof(word_type);
+    }
+
+    // begin, end - non-const & const
+    // No-Throw Guarantee
+    iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, _size);
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, _size);
+    }
+
+    // resize
+    // New items are 0.
+    // Strong Guarantee
+    // Exception neutral
+    void resize(size_type newsize)
+    {
+        size_type oldWords = _words.size();
+        size_type newWords = _wordsFor(newsize);
+        if (newsize < _size)
+            _clearFrom(newsize);
+        _words.resize(newWords);  // Only this can throw; not if smaller
+        for (size_type k = oldWords; k < newWords; ++k)
+            _words[k] = 0;
+        _size = newsize;
+    }
+
+    // insert
+    // Pre:
+    //     pos is in [begin(), end()].
+    // Strong Guarantee
+    // Exception neutral
+    iterator insert(const_iterator pos,
+                    value_type v)
+    {
+        size_type p = pos.index();
+        resize(_size + 1);
+        size_type wp = p / PER_WORD;
+        unsigned ip = unsigned(p % PER_WORD);
+
+        // Whole words above wp: shift up one item, carrying in the top
+        //  item of the word below
+        for (size_type k = _words.size() - 1; k > wp; --k)
+            _words[k] = ((_words[k] << bits) & USED)
+                      | ((_words[k-1] >> TOP_SHIFT) & MASK);
+
+        // Word wp: shift items at ip and above
+        word_type low = _lowMask(ip);
+        word_type w = _words[wp];
+        _words[wp] = (w & low) | (((w & ~low) << bits) & USED);
+        set(p, v);
+        return iterator(this, p);
+    }
+
+    // erase
+    // Pre:
+    //     pos is in [begin(), end()).
+    // No-Throw Guarantee
+    iterator erase(const_iterator pos) noexcept
+    {
+        size_type p = pos.index();
+        size_type wp = p / PER_WORD;
+        unsigned ip = unsigned(p % PER_WORD);
+        size_type last = _words.size() - 1;
+
+        // Word wp: drop item ip; shift items above it down
+        word_type low = _lowMask(ip);
+        word_type w = _words[wp];
+        word_type high = (w & ~low & ~(MASK << (ip * bits))) >> bits;
+        _words[wp] = (w & low) | high;
+
+        // Each word takes the bottom item of the next into its top slot
+        for (size_type k = wp; k < last; ++k)
+        {
+            _words[k] |= (_words[k+1] & MASK) << TOP_SHIFT;
+            _words[k+1] >>= bits;
+        }
+
+        --_size;
+        _words.resize(_wordsFor(_size));  // Smaller: never throws
+        return iterator(this, p);
+    }
+
+    // push_back
+    // Strong Guarantee
+    // Exception neutral
+    void push_back(value_type v)
+    {
+        resize(_size + 1);
+        set(_size - 1, v);
+    }
+
+    // pop_back
+    // Pre:
+    //     size() > 0.
+    // No-Throw Guarantee
+    void pop_back() noexcept
+    {
+        resize(_size - 1);  // Smaller: never throws
+    }
+
+    // swap
+    // No-Throw Guarantee
+    void swap(FSTPackedArray & other) noexcept
+    {
+        _words.swap(other._words);
+        std::swap(_size, other._size);
+    }
+
+// ***** FSTPackedArray: whole-array routines *****
+public:
+
+    // popcount
+    // Return the number of 1 bits in all items (for bits == 1, the
+    //  number of true items).
+    // No-Throw Guarantee
+    [[nodiscard]] size_type popcount() const noexcept
+    {
+        size_type total = 0;
+        for (size_type k = 0; k < _words.size(); ++k)
+            total += size_type(std::popcount(_words[k]));
+        return total;
+    }
+
+    // count
+    // Return the number of items equal to v.
+    // No-Throw Guarantee
+    [[nodiscard]] size_type count(value_type v) const noexcept
+    {
+        if (_size == 0)
+            return 0;
+        word_type pattern = _broadcast(word_type(v) & MASK);
+        size_type last = _words.size() - 1;
+        size_type total = 0;
+        for (size_type k = 0; k < last; ++k)
+            total += size_type(std::popcount(_zeroFields(_words[k]
+                                                         ^ pattern)));
+        word_type tail = _zeroFields(_words[last] ^ pattern)
+                       & _lowMask(unsigned(_size - last * PER_WORD));
+        return total + size_type(std::popcount(tail));
+    }
+
+    // find
+    // Return index of first item equal to v at or after from, or size()
+    //  if none.
+    // No-Throw Guarantee
+    [[nodiscard]] size_type find(value_type v,
+                                 size_type from=0) const noexcept
+    {
+        if (from >= _size)
+            return _size;
+        word_type pattern = _broadcast(word_type(v) & MASK);
+        for (size_type k = from / PER_WORD; k < _words.size(); ++k)
+        {
+            word_type hits = _zeroFields(_words[k] ^ pattern);
+            if (k == from / PER_WORD)
+                hits &= ~_lowMask(unsigned(from % PER_WORD));
+            if (hits != 0)
+            {
+                size_type index = k * PER_WORD
+                                + size_type(std::countr_zero(hits)) / bits;
+                return index < _size ? index : _size;
+            }
+        }
+        return _size;
+    }
+
+    // unpack
+    // Write items first .. first+n-1 to out, one per element.
+    // Pre:
+    //     first + n <= size(); out has room for n values.
+    // No-Throw Guarantee
+    template <typename OutType>
+    void unpack(size_type first,
+                size_type n,
+                OutType * out) const noexcept
+    {
+        size_type i = first;
+        size_type end = first + n;
+        // Leading items, up to a word boundary
+        for (; i < end && i % PER_WORD != 0; ++i)
+            *out++ = OutType(get(i));
+        // Whole words: fixed trip count, so the loop unrolls
+        for (; i + PER_WORD <= end; i += PER_WORD)
+        {
+            word_type w = _words[i / PER_WORD];
+            for (unsigned j = 0; j < PER_WORD; ++j)
+                out[j] = OutType((w >> (j * bits)) & MASK);
+            out += PER_WORD;
+        }
+        for (; i < end; ++i)
+            *out++ = OutType(get(i));
+    }
+
+// ***** FSTPackedArray: internal-use functions *****
+private:
+
+    // _wordsFor
+    // Return number of words holding n items.
+    static constexpr size_type _wordsFor(size_type n) noexcept
+    {
+        return (n + PER_WORD - 1) / PER_WORD;
+    }
+
+    // _shiftOf
+    // Return bit position of item index within its word.
+    static constexpr unsigned _shiftOf(size_type index) noexcept
+    {
+        return unsigned(index % PER_WORD) * bits;
+    }
+
+    // _lowMask
+    // Return mask of the bits of item slots 0 .. n-1 of a word
+    //  (n <= PER_WORD).
+    static constexpr word_type _lowMask(unsigned n) noexcept
+    {
+        return n * bits >= 64 ? ~word_type(0)
+                              : (word_type(1) << (n * bits)) - 1;
+    }
+
+    // _zeroFields
+    // Return the high bit of each item slot of x that is 0 (SWAR zero
+    //  test: exact, with no carries between slots).
+    static constexpr word_type _zeroFields(word_type x) noexcept
+    {
+        constexpr word_type m = ~HIGH_BITS & USED;  // Low bits-1 bits
+                                                    //  of each slot
+        word_type t = ((x & m) + m) | x;
+        return ~t & HIGH_BITS;
+    }
+
+    // _clearFrom
+    // Zero item slots newsize .. _size-1.
+    void _clearFrom(size_type newsize) noexcept
+    {
+        if (newsize % PER_WORD != 0)
+            _words[newsize / PER_WORD] &=
+                _lowMask(unsigned(newsize % PER_WORD));
+        // Whole words past the new end are zeroed too, before resize
+        //  drops them, so the invariant holds word by word
+        size_type from = _wordsFor(newsize);
+        size_type to = _wordsFor(_size);
+        for (size_type k = from; k < to; ++k)
+            _words[k] = 0;
+    }
+
+// ***** FSTPackedArray: data members *****
+private:
+
+    FSTArray<word_type> _words;  // Packed items
+    size_type           _size;   // Number of items
+
+};  // End class FSTPackedArray
+
+
+// FSTBitArray
+// Array of bits: one bit per bool item.
+using FSTBitArray = FSTPackedArray<1>;
+
+
+#endif  //#ifndef FILE_FSTPACKEDARRAY_H_INCLUDED
+
@@ -0,0 +1,403 @@
+// fstrcuarray.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Read-copy-update wrapper for an FSTArray shared by many reader threads
+//  & one writer
+
+#ifndef FILE_FSTRCUARRAY_H_INCLUDED
+#define FILE_FSTRCUARRAY_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::uint64_t
+#include <atomic>
+// For std::atomic
+// For std::atomic_thread_fence
+#include <memory>
+// For std::unique_ptr
+#include <mutex>
+// For std::mutex
+// For std::lock_guard
+#include <stdexcept>
+// For std::length_error
+#include <thread>
+// For std::this_thread::yield
+#include <utility>
+// For std::move
+
+// *********************************************************************
+// class FSTRcuArray - Class definition
+// *********************************************************************
+
+
+// class FSTRcuArray
+// FSTArray read by many threads while a writer changes it, without
+//  locks: readers see immutable versions; the writer copies the current
+//  version, changes the copy, & publishes it. Old versions are deleted
+//  once no reader can still see them (quiescent-state-based reclamation).
+// Readers: each reader thread makes a Reader (reader()), & then
+//     view()        Returns the current version. A plain acquire load:
+//                    no locks, no read-modify-write, no fences.
+//     quiescent()   Says that this thread holds nothing it got from
+//                    view(). Call it between units of work (e.g., per
+//                    request); a reference from view() is valid until
+//                    the next quiescent() or offline().
+//     offline(), online()
+//                   Bracket times the thread will not read (e.g.,
+//                    blocking), so that it does not hold back
+//                    reclamation.
+// Writer: update(f) calls f on a copy of the current version, then
+//  publishes it; insert, erase, resize, push_back & pop_back are
+//  one-change shorthands. Use update to batch several changes into one
+//  copy. Readers never wait for the writer, and the writer never waits
+//  for readers, except in synchronize.
+// Reclamation: publishing starts a new epoch. A retired version is
+//  deleted when each online reader has been quiescent in a later epoch:
+//  at the next update, or synchronize, which waits for it.
+// Invariants:
+//     _current points to the published version, made by new.
+//     _retired holds versions replaced by later ones, each with the
+//      epoch in which it was replaced, in increasing epoch order.
+//     _slots[i].epoch: 0 if slot i's reader is offline or the slot is
+//      free; otherwise an epoch the reader saw at its last quiescent
+//      state.
+// Requirements on Types:
+//     value_type is as for FSTArray.
+//
+// value_type = value type of array elements
+template <typename valType>
+class FSTRcuArray {
+
+// ***** FSTRcuArray: types *****
+public:
+
+    // value_type: type of data items
+    using value_type = valType;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+    // version_type: what readers see
+    using version_type = FSTArray<value_type>;
+
+    class Reader;
+
+// ***** FSTRcuArray: internal-use types *****
+private:
+
+    // struct _Slot
+    // One reader's state, on its own cache line, so readers' quiescent
+    //  stores do not contend.
+    struct alignas(64) _Slot {
+        std::atomic<std::uint64_t> epoch{0};
+        std::atomic<bool>          inUse{false};
+    };
+
+    // struct _Retired
+    // Old version, & the epoch that replaced it.
+    struct _Retired {
+        std::uint64_t        epoch;
+        const version_type * version;
+    };
+
+// ***** FSTRcuArray: ctors, op=, dctor *****
+public:
+
+    // Ctor from initial contents & maximum number of Readers at once
+    // Strong Guarantee
+    // Exception neutral
+    explicit FSTRcuArray(version_type initial=version_type(),
+                         size_type maxReaders=128)
+        :_current(nullptr),
+         _epoch(1),
+         _slots(new _Slot[maxReaders]),
+         _slotCount(maxReaders),
+         _retired(0)
+    {
+        _current.store(new version_type(std::move(initial)),
+                       std::memory_order_release);
+    }
+
+    // No copying or moving: Readers refer to this object
+    FSTRcuArray(const FSTRcuArray &) = delete;
+    FSTRcuArray & operator=(const FSTRcuArray &) = delete;
+
+    // Dctor
+    // Pre:
+    //     No Reader of this object exists.
+    ~FSTRcuArray()
+    {
+        delete _current.load(std::memory_order_relaxed);
+        for (size_type i = 0; i < _retired.size(); ++i)
+            delete _retired[i].version;
+    }
+
+// ***** FSTRcuArray: general public functions *****
+public:
+
+    // reader
+    // Return a Reader for the calling thread, online.
+    // Throws std::length_error if maxReaders Readers exist.
+    Reader reader()
+    {
+        for (size_type i = 0; i < _slotCount; ++i)
+        {
+            bool expected = false;
+            if (!_slots[i].inUse.load(std::memory_order_relaxed)
+                && _slots[i].inUse.compare_exchange_strong(expected, true))
+            {
+                Reader r(this, &_slots[i]);
+                r.online();
+                return r;
+            }
+        }
+        throw std::length_error("FSTRcuArray: too many readers");
+    }
+
+    // current
+    // Return the current version, for the writer's thread (readers use
+    //  Reader::view).
+    // No-Throw Guarantee
+    const version_type & current() const noexcept
+    {
+        return *_current.load(std::memory_order_acquire);
+    }
+
+    // update
+    // Copy the current version, call f(copy), & publish the copy. Then
+    //  delete retired versions whose grace period has ended. Writers are
+    //  serialized.
+    // Strong Guarantee: if f throws, nothing is published.
+    // Exception neutral
+    template <typename F>
+    void update(F f)
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        const version_type * old = _current.load(std::memory_order_relaxed);
+        std::unique_ptr<version_type> next(new version_type(*old));
+        f(*next);
+        _retired.push_back(_Retired{ 0, old });  // Room now: may throw
+
+        _current.store(next.release(), std::memory_order_seq_cst);
+        _retired[_retired.size()-1].epoch =
+            _epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        _reclaim();
+    }
+
+    // insert, erase, resize, push_back, pop_back
+    // As for FSTArray, each published as one update. insert & erase take
+    //  an index, since iterators belong to one version.
+    // Strong Guarantee
+    // Exception neutral
+    void insert(size_type index,
+                const value_type & item)
+    {
+        update([&](version_type & a) { a.insert(a.begin() + index, item); });
+    }
+
+    void erase(size_type index)
+    {
+        update([&](version_type & a) { a.erase(a.begin() + index); });
+    }
+
+    void resize(size_type newsize)
+    {
+        update([&](version_type & a) { a.resize(newsize); });
+    }
+
+    void push_back(const value_type & item)
+    {
+        update([&](version_type & a) { a.push_back(item); });
+    }
+
+    void pop_back()
+    {
+        update([&](version_type & a) { a.pop_back(); });
+    }
+
+    // synchronize
+    // Wait until every retired version is deleted: each online reader
+    //  has been quiescent since the last update.
+    void synchronize()
+    {
+        for (;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_writeMutex);
+                _reclaim();
+                if (_retired.empty())
+                    return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // retiredCount
+    // Return the number of versions awaiting deletion.
+    // No-Throw Guarantee
+    size_type retiredCount() noexcept
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        return _retired.size();
+    }
+
+// ***** FSTRcuArray: internal-use functions *****
+private:
+
+    // _reclaim
+    // Delete retired versions replaced in an epoch every online reader
+    //  has been quiescent in. Caller holds _writeMutex.
+    void _reclaim() noexcept
+    {
+        std::uint64_t oldest = _epoch.load(std::memory_order_seq_cst);
+        for (size_type i = 0; i < _slotCount; ++i)
+        {
+            std::uint64_t e = _slots[i].epoch.load(std::memory_order_seq_cst);
+            if (e != 0 && e < oldest)
+                oldest = e;
+        }
+        size_type done = 0;
+        while (done < _retired.size() && _retired[done].epoch <= oldest)
+        {
+            delete _retired[done].version;
+            ++done;
+        }
+        if (done == 0)
+            return;
+        for (size_type i = done; i < _retired.size(); ++i)
+            _retired[i-done] = _retired[i];
+        _retired.resize(_retired.size() - done);
+    }
+
+// ***** FSTRcuArray: data members *****
+private:
+
+    std::atomic<const version_type *> _current;    // Published version
+    std::atomic<std::uint64_t>        _epoch;      // Current epoch, >= 1
+    std::unique_ptr<_Slot[]>          _slots;      // One per Reader
+    size_type                         _slotCount;  // Size of _slots
+    std::mutex                        _writeMutex; // Serializes writers
+    FSTArray<_Retired>                _retired;    // Awaiting deletion
+
+};  // End class FSTRcuArray
+
+
+// *********************************************************************
+// class FSTRcuArray::Reader - Class definition
+// *********************************************************************
+
+
+// class FSTRcuArray::Reader
+// One reader thread's handle on an FSTRcuArray (see above). Use from one
+//  thread at a time. Movable, not copyable.
+// Invariants:
+//     _owner == nullptr (moved-from), or _slot is a slot of *_owner
+//      marked in use.
+template <typename valType>
+class FSTRcuArray<valType>::Reader {
+
+    friend class FSTRcuArray<valType>;
+
+// ***** Reader: ctors, op=, dctor *****
+public:
+
+    // Move ctor
+    // No-Throw Guarantee
+    Reader(Reader && other) noexcept
+        :_owner(other._owner),
+         _slot(other._slot)
+    {
+        other._owner = nullptr;
+        other._slot = nullptr;
+    }
+
+    // Move op=
+    // No-Throw Guarantee
+    Reader & operator=(Reader && other) noexcept
+    {
+        std::swap(_owner, other._owner);
+        std::swap(_slot, other._slot);
+        return *this;
+    }
+
+    Reader(const Reader &) = delete;
+    Reader & operator=(const Reader &) = delete;
+
+    // Dctor
+    // Goes offline & frees the slot.
+    ~Reader()
+    {
+        if (_owner == nullptr)
+            return;
+        offline();
+        _slot->inUse.store(false, std::memory_order_release);
+    }
+
+// ***** Reader: general public functions *****
+public:
+
+    // view
+    // Return the current version.
+    // Pre:
+    //     Online.
+    // No-Throw Guarantee
+    const version_type & view() const noexcept
+    {
+        return *_owner->_current.load(std::memory_order_acquire);
+    }
+
+    // quiescent
+    // Declare that no reference from view() is still in use.
+    // Pre:
+    //     Online.
+    // No-Throw Guarantee
+    void quiescent() noexcept
+    {
+        _slot->epoch.store(_owner->_epoch.load(std::memory_order_acquire),
+                           std::memory_order_release);
+    }
+
+    // offline, online
+    // Stop & start reading; offline is also quiescent.
+    // No-Throw Guarantee
+    void offline() noexcept
+    {
+        _slot->epoch.store(0, std::memory_order_release);
+    }
+
+    void online() noexcept
+    {
+        _slot->epoch.store(_owner->_epoch.load(std::memory_order_seq_cst),
+                           std::memory_order_seq_cst);
+        // The store alone does not keep the acquire load in a later
+        //  view() from going first (store buffering; e.g., with RCpc
+        //  acquire loads), so a writer could miss us & delete what we
+        //  read. With this fence, and the writer's seq_cst store of
+        //  _current & loads of epochs, either _reclaim sees our epoch
+        //  or view() sees the new version.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+// ***** Reader: internal-use functions *****
+private:
+
+    Reader(FSTRcuArray * owner,
+           _Slot * slot) noexcept
+        :_owner(owner),
+         _slot(slot)
+    {}
+
+// ***** Reader: data members *****
+private:
+
+    FSTRcuArray * _owner;  // Array we read
+    _Slot *       _slot;   // Our slot in _owner
+
+};  // End class FSTRcuArray::Reader
+
+
+#endif  //#ifndef FILE_FSTRCUARRAY_H_INCLUDED
+
@@ -0,0 +1,311 @@
+// fstregistry.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Global registry of live FSTArray objects, for memory-footprint
+//  diagnostics
+// Used by fstarray.h when FSTARRAY_REGISTRY is defined.
+
+#ifndef FILE_FSTREGISTRY_H_INCLUDED
+#define FILE_FSTREGISTRY_H_INCLUDED
+
+#include <cstddef>
+// For std::size_t
+#include <algorithm>
+// For std::partial_sort
+// For std::min
+// For std::max
+#include <mutex>
+// For std::mutex
+// For std::lock_guard
+#include <ostream>
+// For std::ostream
+#include <iomanip>
+// For std::setw
+#include <vector>
+// For std::vector
+#include <string>
+// For std::string
+#include <cstdlib>
+// For std::free
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+// For abi::__cxa_demangle
+#endif
+
+// *********************************************************************
+// Registry entries
+// *********************************************************************
+
+
+// struct FSTRegistryType
+// What the registry needs to know about one FSTArray instantiation:
+//  type-erased accessors, filled in by FSTArray<T>.
+struct FSTRegistryType {
+    const char * name;                        // Name of value type
+    std::size_t  elementBytes;                // sizeof(value_type)
+    std::size_t  (*size)(const void *);       // Return size()
+    std::size_t  (*capacity)(const void *);   // Return capacity()
+    bool         (*shrink)(void *,
+                           std::size_t);      // Reduce capacity to at
+                                              //  most the given value;
+                                              //  return false on failure
+};
+
+
+// struct FSTRegistryNode
+// Link in the registry's list of live arrays; a data member of each
+//  FSTArray in registry mode.
+struct FSTRegistryNode {
+    void *                  owner = nullptr;  // Array holding this node
+    const FSTRegistryType * type = nullptr;   // Its accessors
+    FSTRegistryNode *       prev = nullptr;
+    FSTRegistryNode *       next = nullptr;
+};
+
+
+// *********************************************************************
+// class FSTRegistry - Class definition
+// *********************************************************************
+
+
+// class FSTRegistry
+// Process-wide list of live FSTArray objects (registry mode only), and
+//  reports of the memory they hold: total slack (capacity not in use),
+//  a histogram of size/capacity ratios, and the arrays wasting the most.
+//  shrinkIdle releases slack from arrays that are mostly empty.
+// Arrays add themselves on construction and remove themselves on
+//  destruction, under a mutex. Reports & shrinkIdle read (and shrink)
+//  arrays of every thread: call them only when no other thread is
+//  modifying registered arrays.
+// The registry's own storage is std::vector, so that making a report
+//  does not register arrays.
+// Invariants:
+//     _head is the first node of a doubly linked list of the nodes of
+//      all live registered arrays, or nullptr.
+//     _count is the length of that list.
+class FSTRegistry {
+
+// ***** FSTRegistry: types *****
+public:
+
+    using size_type = std::size_t;
+
+    // Number of size/capacity ratio buckets: [0, 0.1), ..., [0.9, 1]
+    enum { RATIO_BUCKETS = 10 };
+
+    // struct Entry
+    // Snapshot of one array.
+    struct Entry {
+        const void * owner;
+        const char * typeName;
+        size_type    size;
+        size_type    capacity;
+        size_type    slackBytes;
+    };
+
+    // struct Summary
+    // Snapshot of all arrays.
+    struct Summary {
+        size_type          arrays = 0;         // Live arrays
+        size_type          usedBytes = 0;      // Bytes of items in use
+        size_type          capacityBytes = 0;  // Bytes allocated
+        size_type          slackBytes = 0;     // capacity - used
+        size_type          ratioHistogram[RATIO_BUCKETS] = {};
+                                               // Arrays by size/capacity
+        std::vector<Entry> topOffenders;       // Most slack first
+    };
+
+// ***** FSTRegistry: ctors, dctor *****
+private:
+
+    // Default ctor; use global()
+    // No-Throw Guarantee
+    FSTRegistry() noexcept
+        :_head(nullptr),
+         _count(0)
+    {}
+
+public:
+
+    // Uncopyable
+    FSTRegistry(const FSTRegistry &) = delete;
+    FSTRegistry & operator=(const FSTRegistry &) = delete;
+
+// ***** FSTRegistry: general public functions *****
+public:
+
+    // global
+    // Return the process-wide registry.
+    // No-Throw Guarantee
+    static FSTRegistry & global() noexcept
+    {
+        static FSTRegistry registry;
+        return registry;
+    }
+
+    // add, remove
+    // Link/unlink node. Called by FSTArray ctors & dctor.
+    // No-Throw Guarantee (terminates if the mutex cannot be locked)
+    void add(FSTRegistryNode & node) noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        node.prev = nullptr;
+        node.next = _head;
+        if (_head != nullptr)
+            _head->prev = &node;
+        _head = &node;
+        ++_count;
+    }
+
+    void remove(FSTRegistryNode & node) noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (node.prev != nullptr)
+            node.prev->next = node.next;
+        else
+            _head = node.next;
+        if (node.next != nullptr)
+            node.next->prev = node.prev;
+        node.prev = node.next = nullptr;
+        --_count;
+    }
+
+    // count
+    // Return number of live registered arrays.
+    // No-Throw Guarantee
+    size_type count() const noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _count;
+    }
+
+    // summary
+    // Return totals, ratio histogram, and the top arrays by slack bytes.
+    // Strong Guarantee
+    Summary summary(size_type top=10) const
+    {
+        Summary s;
+        std::vector<Entry> all;
+        std::lock_guard<std::mutex> lock(_mutex);
+        all.reserve(_count);
+        for (FSTRegistryNode * n = _head; n != nullptr; n = n->next)
+        {
+            size_type size = n->type->size(n->owner);
+            size_type cap = n->type->capacity(n->owner);
+            size_type bytes = n->type->elementBytes;
+            ++s.arrays;
+            s.usedBytes += size * bytes;
+            s.capacityBytes += cap * bytes;
+            if (cap == 0)
+                continue;  // Moved-from; holds no memory
+            size_type bucket = size * RATIO_BUCKETS / cap;
+            ++s.ratioHistogram[std::min(bucket,
+                                        size_type(RATIO_BUCKETS-1))];
+            all.push_back(Entry{ n->owner, n->type->name, size, cap,
+                                 (cap - size) * bytes });
+        }
+        s.slackBytes = s.capacityBytes - s.usedBytes;
+
+        top = std::min(top, all.size());
+        std::partial_sort(all.begin(), all.begin() + top, all.end(),
+            [](const Entry & a, const Entry & b)
+            { return a.slackBytes > b.slackBytes; });
+        s.topOffenders.assign(all.begin(), all.begin() + top);
+        return s;
+    }
+
+    // report
+    // Print summary(top) in readable form.
+    // Basic Guarantee (output may be partial)
+    void report(std::ostream & out,
+                size_type top=10) const
+    {
+        Summary s = summary(top);
+        out << "FSTArray registry: " << s.arrays << " live arrays\n"
+            << "  bytes in use:    " << s.usedBytes << "\n"
+            << "  bytes allocated: " << s.capacityBytes << "\n"
+            << "  slack bytes:     " << s.slackBytes;
+        if (s.capacityBytes != 0)
+            out << " (" << 100 * s.slackBytes / s.capacityBytes << "%)";
+        out << "\n  size/capacity:\n";
+        for (size_type b = 0; b < size_type(RATIO_BUCKETS); ++b)
+        {
+            out << "    " << std::setw(3) << 10*b << "-" << std::setw(3)
+                << 10*(b+1) << "%  " << std::setw(8)
+                << s.ratioHistogram[b] << "\n";
+        }
+        out << "  top offenders (slack bytes, size/capacity, type):\n";
+        for (const Entry & e : s.topOffenders)
+        {
+            out << "    " << std::setw(12) << e.slackBytes << "  "
+                << e.size << "/" << e.capacity << "  "
+                << _demangle(e.typeName) << " at " << e.owner << "\n";
+        }
+        out.flush();
+    }
+
+    // shrinkIdle
+    // Shrink every array whose size is below maxRatio of its capacity
+    //  to max(2*size, minCapacity) -- leaving room to grow back without
+    //  reallocating at once -- if that is smaller. Arrays whose
+    //  reallocation fails are left as they were.
+    // Returns number of bytes released.
+    // No-Throw Guarantee
+    size_type shrinkIdle(double maxRatio=0.25,
+                         size_type minCapacity=16) noexcept
+    {
+        size_type released = 0;
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (FSTRegistryNode * n = _head; n != nullptr; n = n->next)
+        {
+            size_type size = n->type->size(n->owner);
+            size_type cap = n->type->capacity(n->owner);
+            size_type target = std::max(2 * size, minCapacity);
+            if (double(size) >= maxRatio * double(cap) || target >= cap)
+                continue;
+            if (n->type->shrink(n->owner, target))
+            {
+                size_type newCap = n->type->capacity(n->owner);
+                released += (cap - newCap) * n->type->elementBytes;
+            }
+        }
+        return released;
+    }
+
+// ***** FSTRegistry: internal-use functions *****
+private:
+
+    // _demangle
+    // Return readable form of a typeid name, where the compiler's ABI
+    //  library can make one; otherwise return name.
+    // Strong Guarantee
+    static std::string _demangle(const char * name)
+    {
+#if __has_include(<cxxabi.h>)
+        int status = 0;
+        char * readable = abi::__cxa_demangle(name, nullptr, nullptr,
+                                              &status);
+        if (status == 0 && readable != nullptr)
+        {
+            std::string result(readable);
+            std::free(readable);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+// ***** FSTRegistry: data members *****
+private:
+
+    mutable std::mutex _mutex;  // Guards the list
+    FSTRegistryNode *  _head;   // First node, or nullptr
+    size_type          _count;  // Number of nodes
+
+};  // End class FSTRegistry
+
+
+#endif  //#ifndef FILE_FSTREGISTRY_H_INCLUDED
+
@@ -0,0 +1,322 @@
+// fstshardedarray.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Per-thread sharded FSTArray accumulator, merged into one FSTArray
+
+#ifndef FILE_FSTSHARDEDARRAY_H_INCLUDED
+#define FILE_FSTSHARDEDARRAY_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include "fstarray_sort.h"
+// For fst_sort_detail::runParallel, fst_sort_detail::threadCount
+#include <cstddef>
+// For std::size_t
+#include <algorithm>
+// For std::copy
+// For std::min
+// For std::max
+// For std::lower_bound
+// For std::make_heap
+// For std::push_heap
+// For std::pop_heap
+#include <functional>
+// For std::less
+#include <memory>
+// For std::unique_ptr
+#include <stdexcept>
+// For std::out_of_range
+#include <thread>
+// For std::thread::hardware_concurrency
+
+// *********************************************************************
+// class FSTShardedArray - Class definition
+// *********************************************************************
+
+
+// class FSTShardedArray
+// Accumulates items from many threads with no locking: each thread
+//  appends to its own shard, an FSTArray on its own cache lines, so
+//  appends from different threads never share a line. Afterwards, the
+//  shards are combined into one FSTArray, with one allocation:
+//     concat()        Shard 0's items, then shard 1's, etc.
+//     mergeSorted()   Sorted merge, if each shard is sorted.
+//  Both copy in parallel for large results.
+// Threads choose shards by index (e.g., a worker number): shard(i) is
+//  for the use of one thread at a time. Functions that look at every
+//  shard (size, concat, mergeSorted, clear) must not run during appends.
+// Invariants:
+//     _shards points to _count shards; _count > 0.
+// Requirements on Types:
+//     value_type is as for FSTArray.
+//
+// value_type = value type of array elements
+template <typename valType>
+class FSTShardedArray {
+
+// ***** FSTShardedArray: types *****
+public:
+
+    // value_type: type of data items
+    using value_type = valType;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+    // shard_type: what each thread appends to
+    using shard_type = FSTArray<value_type>;
+
+// ***** FSTShardedArray: internal-use types *****
+private:
+
+    // struct _Shard
+    // One shard, starting a cache line; the array's size & pointer are
+    //  then on a line no other shard's are.
+    struct alignas(64) _Shard {
+        shard_type items{0};
+    };
+
+// ***** FSTShardedArray: ctors, op=, dctor *****
+public:
+
+    // Ctor from number of shards
+    // 0 means one per hardware thread.
+    // Strong Guarantee
+    // Exception neutral
+    explicit FSTShardedArray(size_type shards=0)
+        :_shards(nullptr),
+         _count(shards != 0 ? shards : _hardwareThreads())
+    {
+        _shards.reset(new _Shard[_count]);
+    }
+
+    // No copying: shards are for threads, not values
+    FSTShardedArray(const FSTShardedArray &) = delete;
+    FSTShardedArray & operator=(const FSTShardedArray &) = delete;
+
+    // Compiler-generated dctor is used.
+
+// ***** FSTShardedArray: general public functions *****
+public:
+
+    // shard
+    // Return shard index, for one thread to append to.
+    // Pre:
+    //     index < shardCount().
+    // No-Throw Guarantee
+    shard_type & shard(size_type index) noexcept
+    {
+        return _shards[index].items;
+    }
+
+    const shard_type & shard(size_type index) const noexcept
+    {
+        return _shards[index].items;
+    }
+
+    // push_back
+    // Append item to shard index.
+    // Throws std::out_of_range if index >= shardCount().
+    // Strong Guarantee
+    // Exception neutral
+    void push_back(size_type index,
+                   const value_type & item)
+    {
+        if (index >= _count)
+            throw std::out_of_range("FSTShardedArray: no such shard");
+        _shards[index].items.push_back(item);
+    }
+
+    // shardCount, size, empty
+    // size is the total over all shards.
+    // No-Throw Guarantee
+    [[nodiscard]] size_type shardCount() const noexcept
+    {
+        return _count;
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        size_type total = 0;
+        for (size_type i = 0; i < _count; ++i)
+            total += _shards[i].items.size();
+        return total;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    // clear
+    // Empty every shard (shards keep their buffers, per their shrink
+    //  policy).
+    // No-Throw Guarantee
+    void clear() noexcept
+    {
+        for (size_type i = 0; i < _count; ++i)
+            _shards[i].items.resize(0);
+    }
+
+    // concat
+    // Return all items, shard by shard, in one FSTArray. Copies use up
+    //  to maxThreads threads (0 means hardware concurrency).
+    // Strong Guarantee
+    // Exception neutral
+    FSTArray<value_type> concat(unsigned maxThreads=0) const
+    {
+        size_type total = size();
+        FSTArray<value_type> result(total);
+        if (total == 0)
+            return result;
+        value_type * out = &result[0];
+
+        // Split the result into parts of about equal size; each thread
+        //  copies whole shards, & pieces of those straddling a boundary
+        size_type parts = fst_sort_detail::threadCount(total, maxThreads);
+        fst_sort_detail::runParallel(parts, [&](size_type p)
+        {
+            size_type lo = total / parts * p;
+            size_type hi = p + 1 == parts ? total : total / parts * (p+1);
+            size_type start = 0;  // Offset of shard i in the result
+            for (size_type i = 0; i < _count && start < hi; ++i)
+            {
+                const shard_type & s = _shards[i].items;
+                size_type end = start + s.size();
+                size_type from = std::max(start, lo);
+                size_type to = std::min(end, hi);
+                if (from < to)
+                    std::copy(&s[0] + (from - start), &s[0] + (to - start),
+                              out + from);
+                start = end;
+            }
+        });
+        return result;
+    }
+
+    // mergeSorted
+    // Return all items, in order, in one FSTArray: a k-way merge, split
+    //  among up to maxThreads threads (0 means hardware concurrency) by
+    //  value. Equal items come in shard order.
+    // Requirements on Types:
+    //     Compare is a strict weak order on value_type.
+    // Pre:
+    //     Each shard is sorted by comp.
+    // Strong Guarantee
+    // Exception neutral
+    template <typename Compare=std::less<value_type>>
+    FSTArray<value_type> mergeSorted(Compare comp=Compare(),
+                                     unsigned maxThreads=0) const
+    {
+        size_type total = size();
+        FSTArray<value_type> result(total);
+        if (total == 0)
+            return result;
+
+        // Splitters: evenly spaced items of the largest shard. Part p
+        //  takes, from each shard, the items in [splitter p-1, splitter
+        //  p); cut[p*_count + i] is where part p starts in shard i.
+        size_type parts = fst_sort_detail::threadCount(total, maxThreads);
+        size_type largest = 0;
+        for (size_type i = 1; i < _count; ++i)
+            if (_shards[i].items.size() > _shards[largest].items.size())
+                largest = i;
+        const shard_type & big = _shards[largest].items;
+        FSTArray<size_type> cut((parts + 1) * _count);
+        for (size_type i = 0; i < _count; ++i)
+        {
+            const shard_type & s = _shards[i].items;
+            cut[i] = 0;
+            cut[parts*_count + i] = s.size();
+            for (size_type p = 1; p < parts; ++p)
+            {
+                const value_type & splitter = big[big.size() / parts * p];
+                cut[p*_count + i] = s.empty() ? 0 : size_type(
+                    std::lower_bound(&s[0], &s[0] + s.size(), splitter,
+                                     comp) - &s[0]);
+            }
+        }
+
+        // Part p's output starts after all items of earlier parts
+        FSTArray<size_type> offset(parts + 1);
+        offset[0] = 0;
+        for (size_type p = 0; p < parts; ++p)
+        {
+            size_type n = 0;
+            for (size_type i = 0; i < _count; ++i)
+                n += cut[(p+1)*_count + i] - cut[p*_count + i];
+            offset[p+1] = offset[p] + n;
+        }
+
+        value_type * out = &result[0];
+        fst_sort_detail::runParallel(parts, [&](size_type p)
+        {
+            _mergePart(&cut[p*_count], &cut[(p+1)*_count],
+                       out + offset[p], comp);
+        });
+        return result;
+    }
+
+// ***** FSTShardedArray: internal-use functions *****
+private:
+
+    // _hardwareThreads
+    // Return number of hardware threads, at least 1.
+    static size_type _hardwareThreads() noexcept
+    {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // _mergePart
+    // Merge items [first[i], last[i]) of each shard i to out, with a
+    //  heap of shard indices ordered by each shard's next item (ties by
+    //  shard index).
+    template <typename Compare>
+    void _mergePart(const size_type * first,
+                    const size_type * last,
+                    value_type * out,
+                    Compare & comp) const
+    {
+        FSTArray<size_type> next(_count);  // Position in each shard
+        FSTArray<size_type> heap(0);
+        heap.reserve(_count);
+        for (size_type i = 0; i < _count; ++i)
+        {
+            next[i] = first[i];
+            if (first[i] != last[i])
+                heap.push_back(i);
+        }
+        // after: "a comes after b" -- heap order, smallest on top
+        auto after = [&](size_type a, size_type b)
+        {
+            const value_type & x = _shards[a].items[next[a]];
+            const value_type & y = _shards[b].items[next[b]];
+            if (comp(y, x))
+                return true;
+            return !comp(x, y) && b < a;
+        };
+        std::make_heap(heap.begin(), heap.end(), after);
+        while (!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), after);
+            size_type i = heap[heap.size()-1];
+            *out++ = _shards[i].items[next[i]];
+            if (++next[i] == last[i])
+                heap.pop_back();
+            else
+                std::push_heap(heap.begin(), heap.end(), after);
+        }
+    }
+
+// ***** FSTShardedArray: data members *****
+private:
+
+    std::unique_ptr<_Shard[]> _shards;  // The shards
+    size_type                 _count;   // Number of shards
+
+};  // End class FSTShardedArray
+
+
+#endif  //#ifndef FILE_FSTSHARDEDARRAY_H_INCLUDED
+
@@ -0,0 +1,668 @@
+// fstsharedarray.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// FSTArray-like array stored in POSIX shared memory, for zero-copy
+//  exchange between processes
+
+#ifndef FILE_FSTSHAREDARRAY_H_INCLUDED
+#define FILE_FSTSHAREDARRAY_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <cstdint>
+// For std::uint64_t
+#include <cstring>
+// For std::memcpy
+// For std::memset
+#include <atomic>
+// For std::atomic
+// For std::atomic_thread_fence
+#include <new>
+// For placement new
+#include <iterator>
+// For std::distance
+#include <stdexcept>
+// For std::length_error
+// For std::logic_error
+// For std::runtime_error
+#include <string>
+// For std::string
+#include <system_error>
+// For std::system_error
+#include <thread>
+// For std::this_thread::yield
+#include <type_traits>
+// For std::is_trivially_copyable_v
+// For std::is_void_v
+// For std::invoke_result_t
+#include <utility>
+// For std::swap
+#include <sys/mman.h>
+// For shm_open, shm_unlink, mmap, munmap
+// For memfd_create (Linux)
+#include <sys/stat.h>
+// For fstat
+#include <fcntl.h>
+// For O_CREAT etc.
+#include <unistd.h>
+// For ftruncate, close, getpid
+#include <cerrno>
+// For errno
+
+// *********************************************************************
+// class FSTSharedArray - Class definition
+// *********************************************************************
+
+
+// class FSTSharedArray
+// Resizable array of trivially copyable items, held in a POSIX shared-
+//  memory segment, so that other processes can map it & read the items
+//  in place: begin() & end() point into the segment, with no copying.
+//  Same interface as FSTArray, except that capacity is fixed when the
+//  segment is made, and growing past it throws std::length_error.
+// Making & mapping segments:
+//     create(name, capacity)     New named segment (shm_open); this
+//                                 object owns the name & unlinks it.
+//     createAnonymous(capacity)  New unnamed segment (memfd on Linux);
+//                                 share it by passing fd() to another
+//                                 process (fork, or SCM_RIGHTS).
+//     open(name), fromFd(fd)     Map an existing segment, read-only.
+// The segment holds a header (sizes, sequence number) followed by the
+//  items. Nothing in it is a pointer: items are found at an offset from
+//  wherever the segment is mapped, so every process may map it at a
+//  different address.
+// Single writer, many readers: one process, the one that made the
+//  segment, changes it; others only read. The writer brackets each
+//  change with a sequence lock (write, or the member functions that
+//  change the array, which do so themselves). Readers get consistent
+//  data with read or snapshot, which retry if a change overlapped them.
+//  Plain begin()/end() reads are not protected; use them when the writer
+//  is known to be idle.
+// Invariants:
+//     _base points to a mapping of _bytes bytes of the segment on _fd,
+//      or is nullptr (moved-from object).
+//     Header: _header()->size <= _header()->capacity;
+//      _header()->seq is odd exactly while the writer is in a change.
+//     _writeDepth > 0 only if _writable.
+// Requirements on Types:
+//     value_type is trivially copyable.
+//
+// value_type = value type of array elements
+template <typename valType>
+class FSTSharedArray {
+
+    static_assert(std::is_trivially_copyable_v<valType>,
+                  "FSTSharedArray requires a trivially copyable item type");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "FSTSharedArray requires lock-free 64-bit atomics");
+
+// ***** FSTSharedArray: types *****
+public:
+
+    // value_type: type of data items
+    using value_type = valType;
+    // size_type: type of sizes & indices
+    using size_type = std::size_t;
+
+    // iterator, const_iterator: random-access iterator types
+    using iterator = value_type *;
+    using const_iterator = const value_type *;
+
+// ***** FSTSharedArray: internal-use types *****
+private:
+
+    // struct _Header
+    // Start of the segment. Only fixed-width fields & lock-free atomics,
+    //  so that every process sees the same layout.
+    struct _Header {
+        std::uint64_t              magic;       // MAGIC: segment is ours
+        std::uint64_t              itemSize;    // sizeof(value_type)
+        std::uint64_t              capacity;    // Max number of items
+        std::uint64_t              dataOffset;  // Byte offset of item 0
+        std::atomic<std::uint64_t> seq;         // Sequence lock
+        std::atomic<std::uint64_t> size;        // Number of items
+    };
+
+    static constexpr std::uint64_t MAGIC = 0x46535453484152ULL;  // FSTSHAR
+
+    // Items start on a cache line of their own
+    static constexpr size_type DATA_OFFSET = (sizeof(_Header) + 63) / 64 * 64;
+
+// ***** FSTSharedArray: ctors, op=, dctor *****
+public:
+
+    // create
+    // Make a named segment for capacity items, & map it read-write; the
+    //  array is empty. name is as for shm_open ("/something"). The name
+    //  is unlinked by this object's dctor; processes that opened it keep
+    //  their mappings.
+    // Throws std::system_error on failure.
+    static FSTSharedArray create(const std::string & name,
+                                 size_type capacity)
+    {
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+            _throwErrno("cannot create " + name);
+        try
+        {
+            FSTSharedArray result(fd, capacity);
+            result._name = name;
+            return result;
+        }
+        catch (...)
+        {
+            ::shm_unlink(name.c_str());
+            throw;
+        }
+    }
+
+    // createAnonymous
+    // Make an unnamed segment for capacity items, & map it read-write.
+    // Throws std::system_error on failure.
+    static FSTSharedArray createAnonymous(size_type capacity)
+    {
+#ifdef __linux__
+        int fd = ::memfd_create("fstsharedarray", MFD_CLOEXEC);
+        if (fd < 0)
+            _throwErrno("cannot create anonymous segment");
+#else
+        std::string name = "/fstsharedarray." + std::to_string(::getpid())
+                         + "." + std::to_string(_counter()++);
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+            _throwErrno("cannot create anonymous segment");
+        ::shm_unlink(name.c_str());
+#endif
+        return FSTSharedArray(fd, capacity);
+    }
+
+    // open
+    // Map the named segment read-only.
+    // Throws std::system_error if it cannot be opened, std::runtime_error
+    //  if it is not an FSTSharedArray segment of this value_type.
+    static FSTSharedArray open(const std::string & name)
+    {
+        int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            _throwErrno("cannot open " + name);
+        return FSTSharedArray(fd);
+    }
+
+    // fromFd
+    // Map the segment on fd read-only. Takes ownership of fd.
+    // Throws as open.
+    static FSTSharedArray fromFd(int fd)
+    {
+        return FSTSharedArray(fd);
+    }
+
+    // No copying: a copy would be a second writer
+    FSTSharedArray(const FSTSharedArray &) = delete;
+    FSTSharedArray & operator=(const FSTSharedArray &) = delete;
+
+    // Move ctor
+    // No-Throw Guarantee
+    FSTSharedArray(FSTSharedArray && other) noexcept
+        :_fd(other._fd),
+         _base(other._base),
+         _bytes(other._bytes),
+         _writable(other._writable),
+         _writeDepth(0),
+         _name(std::move(other._name))
+    {
+        other._fd = -1;
+        other._base = nullptr;
+        other._bytes = 0;
+        other._name.clear();
+    }
+
+    // Move op=
+    // No-Throw Guarantee
+    FSTSharedArray & operator=(FSTSharedArray && other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    // Dctor
+    // Unmaps the segment; unlinks its name if this object made it.
+    ~FSTSharedArray()
+    {
+        if (_base != nullptr)
+            ::munmap(_base, _bytes);
+        if (_fd >= 0)
+            ::close(_fd);
+        if (!_name.empty())
+            ::shm_unlink(_name.c_str());
+    }
+
+// ***** FSTSharedArray: general public operators *****
+public:
+
+    // operator[] - non-const & const
+    // Pre:
+    //     index < size(). For non-const: writable().
+    // No-Throw Guarantee
+    value_type & operator[](size_type index) noexcept
+    {
+        return _data()[index];
+    }
+
+    const value_type & operator[](size_type index) const noexcept
+    {
+        return _data()[index];
+    }
+
+// ***** FSTSharedArray: general public functions *****
+public:
+
+    // size, empty, capacity
+    // No-Throw Guarantee
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_type(_header()->size.load(std::memory_order_acquire));
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return size_type(_header()->capacity);
+    }
+
+    // writable
+    // Return whether this object is the writer.
+    // No-Throw Guarantee
+    [[nodiscard]] bool writable() const noexcept
+    {
+        return _writable;
+    }
+
+    // fd
+    // Return the segment's file descriptor, for passing to a reader
+    //  process (which should dup it before fromFd, or own its copy).
+    // No-Throw Guarantee
+    int fd() const noexcept
+    {
+        return _fd;
+    }
+
+    // version
+    // Return the sequence number: even, & larger after each change;
+    //  odd while a change is in progress.
+    // No-Throw Guarantee
+    std::uint64_t version() const noexcept
+    {
+        return _header()->seq.load(std::memory_order_acquire);
+    }
+
+    // begin, end - non-const & const
+    // Pre, for non-const: writable().
+    // No-Throw Guarantee
+    iterator begin() noexcept
+    {
+        return _data();
+    }
+    const_iterator begin() const noexcept
+    {
+        return _data();
+    }
+
+    iterator end() noexcept
+    {
+        return _data() + size();
+    }
+    const_iterator end() const noexcept
+    {
+        return _data() + size();
+    }
+
+    // write
+    // Call f(*this) as one change: readers see all of it or none of it.
+    //  Calls may nest.
+    // Throws std::logic_error if !writable().
+    // Exception neutral; if f throws, the change ends, with whatever f
+    //  did visible.
+    template <typename F>
+    void write(F f)
+    {
+        _checkWritable();
+        _beginWrite();
+        try
+        {
+            f(*this);
+        }
+        catch (...)
+        {
+            _endWrite();
+            throw;
+        }
+        _endWrite();
+    }
+
+    // read
+    // Call f(cbegin, cend) until no change overlaps the call, & return
+    //  its result from that call. f may see inconsistent items in a call
+    //  that is retried, so it should only read them, & must not loop on
+    //  what it sees.
+    // Exception neutral
+    template <typename F>
+    auto read(F f) const
+    {
+        using Result = std::invoke_result_t<F, const_iterator,
+                                            const_iterator>;
+        const _Header * h = _header();
+        for (;;)
+        {
+            std::uint64_t s = h->seq.load(std::memory_order_acquire);
+            if (s % 2 != 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            const_iterator first = _data();
+            const_iterator last = first + size_type(
+                h->size.load(std::memory_order_relaxed));
+            if constexpr (std::is_void_v<Result>)
+            {
+                f(first, last);
+                if (_validate(s))
+                    return;
+            }
+            else
+            {
+                Result r = f(first, last);
+                if (_validate(s))
+                    return r;
+            }
+        }
+    }
+
+    // snapshot
+    // Set out to a consistent copy of the items.
+    // Strong Guarantee
+    // Exception neutral
+    template <typename Policy>
+    void snapshot(FSTArray<value_type, Policy> & out) const
+    {
+        const size_type GREW = size_type(-1);
+        for (;;)
+        {
+            size_type room = size();
+            FSTArray<value_type, Policy> copy(room);
+            size_type n = read([&](const_iterator first, const_iterator last)
+            {
+                size_type count = size_type(last - first);
+                if (count > room)
+                    return GREW;
+                if (count != 0)
+                    std::memcpy(static_cast<void *>(&copy[0]), first,
+                                count * sizeof(value_type));
+                return count;
+            });
+            if (n == GREW)
+                continue;  // Writer grew the array; make more room
+            copy.resize(n);
+            out.swap(copy);
+            return;
+        }
+    }
+
+    // resize
+    // New items are zero.
+    // Throws std::logic_error if !writable(), std::length_error if
+    //  newsize > capacity().
+    // Strong Guarantee
+    void resize(size_type newsize)
+    {
+        _checkWritable();
+        _checkSize(newsize);
+        _beginWrite();
+        size_type oldsize = size();
+        if (newsize > oldsize)
+            std::memset(static_cast<void *>(_data() + oldsize), 0,
+                        (newsize - oldsize) * sizeof(value_type));
+        _setSize(newsize);
+        _endWrite();
+    }
+
+    // assign
+    // Set the items to a copy of [first, last).
+    // Throws as resize.
+    // Strong Guarantee if FwdIter operations cannot throw; otherwise
+    //  Basic Guarantee.
+    // Exception neutral
+    template <typename FwdIter>
+    void assign(FwdIter first,
+                FwdIter last)
+    {
+        _checkWritable();
+        size_type n = size_type(std::distance(first, last));
+        _checkSize(n);
+        write([&](FSTSharedArray &)
+        {
+            value_type * dest = _data();
+            for (; first != last; ++first)
+                *dest++ = *first;
+            _setSize(n);
+        });
+    }
+
+    // push_back
+    // Throws as resize, if size() == capacity().
+    // Strong Guarantee
+    void push_back(const value_type & item)
+    {
+        _checkWritable();
+        size_type n = size();
+        _checkSize(n + 1);
+        _beginWrite();
+        _data()[n] = item;
+        _setSize(n + 1);
+        _endWrite();
+    }
+
+    // pop_back
+    // Pre:
+    //     size() > 0; writable().
+    // No-Throw Guarantee
+    void pop_back() noexcept
+    {
+        _beginWrite();
+        _setSize(size() - 1);
+        _endWrite();
+    }
+
+    // swap
+    // Swaps which segments the two objects refer to.
+    // No-Throw Guarantee
+    void swap(FSTSharedArray & other) noexcept
+    {
+        std::swap(_fd, other._fd);
+        std::swap(_base, other._base);
+        std::swap(_bytes, other._bytes);
+        std::swap(_writable, other._writable);
+        std::swap(_writeDepth, other._writeDepth);
+        _name.swap(other._name);
+    }
+
+// ***** FSTSharedArray: internal-use functions *****
+private:
+
+    // Ctor from fd & capacity: size segment, map read-write, set header.
+    //  Takes ownership of fd.
+    FSTSharedArray(int fd,
+                   size_type capacity)
+        :_fd(fd),
+         _base(nullptr),
+         _bytes(DATA_OFFSET + capacity * sizeof(value_type)),
+         _writable(true),
+         _writeDepth(0)
+    {
+        if (capacity > (size_type(-1) - DATA_OFFSET) / sizeof(value_type))
+        {
+            ::close(fd);
+            throw std::length_error("FSTSharedArray: capacity too large");
+        }
+        if (::ftruncate(_fd, off_t(_bytes)) != 0)
+            _fail("cannot size segment");
+        _map(PROT_READ | PROT_WRITE);
+        _Header * h = new (_base) _Header;
+        h->magic = MAGIC;
+        h->itemSize = sizeof(value_type);
+        h->capacity = capacity;
+        h->dataOffset = DATA_OFFSET;
+        h->seq.store(0, std::memory_order_relaxed);
+        h->size.store(0, std::memory_order_release);
+    }
+
+    // Ctor from fd: map existing segment read-only & check header.
+    //  Takes ownership of fd.
+    explicit FSTSharedArray(int fd)
+        :_fd(fd),
+         _base(nullptr),
+         _bytes(0),
+         _writable(false),
+         _writeDepth(0)
+    {
+        struct stat st;
+        if (::fstat(_fd, &st) != 0)
+            _fail("cannot stat segment");
+        _bytes = size_type(st.st_size);
+        if (_bytes < DATA_OFFSET)
+            _bad();
+        _map(PROT_READ);
+        const _Header * h = _header();
+        if (h->magic != MAGIC || h->itemSize != sizeof(value_type)
+            || h->dataOffset != DATA_OFFSET
+            || h->capacity > (_bytes - DATA_OFFSET) / sizeof(value_type))
+            _bad();
+    }
+
+    // _map
+    // Map all _bytes of _fd with the given protection.
+    void _map(int prot)
+    {
+        void * p = ::mmap(nullptr, _bytes, prot, MAP_SHARED, _fd, 0);
+        if (p == MAP_FAILED)
+            _fail("cannot map segment");
+        _base = static_cast<unsigned char *>(p);
+    }
+
+    _Header * _header() const noexcept
+    {
+        return reinterpret_cast<_Header *>(_base);
+    }
+
+    value_type * _data() const noexcept
+    {
+        return reinterpret_cast<value_type *>(_base + DATA_OFFSET);
+    }
+
+    void _setSize(size_type n) noexcept
+    {
+        _header()->size.store(n, std::memory_order_relaxed);
+    }
+
+    // _beginWrite, _endWrite
+    // Open & close a change: seq is odd between the outermost pair.
+    void _beginWrite() noexcept
+    {
+        if (_writeDepth++ != 0)
+            return;
+        _Header * h = _header();
+        h->seq.store(h->seq.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void _endWrite() noexcept
+    {
+        if (--_writeDepth != 0)
+            return;
+        _Header * h = _header();
+        h->seq.store(h->seq.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+    }
+
+    // _validate
+    // Return whether no change began since seq was s.
+    bool _validate(std::uint64_t s) const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _header()->seq.load(std::memory_order_relaxed) == s;
+    }
+
+    void _checkWritable() const
+    {
+        if (!_writable)
+            throw std::logic_error("FSTSharedArray: array is read-only");
+    }
+
+    void _checkSize(size_type n) const
+    {
+        if (n > capacity())
+            throw std::length_error("FSTSharedArray: size exceeds capacity");
+    }
+
+    // _fail, _bad
+    // Release what the ctor got, & throw.
+    [[noreturn]] void _fail(const std::string & what)
+    {
+        int err = errno;
+        _release();
+        errno = err;
+        _throwErrno(what);
+    }
+
+    [[noreturn]] void _bad()
+    {
+        _release();
+        throw std::runtime_error("FSTSharedArray: not a segment of this type");
+    }
+
+    void _release() noexcept
+    {
+        if (_base != nullptr)
+            ::munmap(_base, _bytes);
+        ::close(_fd);
+        _base = nullptr;
+        _fd = -1;
+    }
+
+    [[noreturn]] static void _throwErrno(const std::string & what)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "FSTSharedArray: " + what);
+    }
+
+#ifndef __linux__
+    static std::atomic<unsigned> & _counter() noexcept
+    {
+        static std::atomic<unsigned> counter(0);
+        return counter;
+    }
+#endif
+
+// ***** FSTSharedArray: data members *****
+private:
+
+    int             _fd;          // Segment's file descriptor
+    unsigned char * _base;        // Our mapping of the segment
+    size_type       _bytes;       // Size of mapping
+    bool            _writable;    // We are the writer
+    int             _writeDepth;  // Nesting of changes in progress
+    std::string     _name;        // Name to unlink, if we made it
+
+};  // End class FSTSharedArray
+
+
+#endif  //#ifndef FILE_FSTSHAREDARRAY_H_INCLUDED
+
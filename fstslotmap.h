@@ -0,0 +1,283 @@
+// fstslotmap.h
+// Started: 2026-10-19
+// Updated: 2026-10-19
+//
+// For CS 311 Fall 2021
+// Slot map built on FSTArray: stable generational handles, O(1) erase
+
+#ifndef FILE_FSTSLOTMAP_H_INCLUDED
+#define FILE_FSTSLOTMAP_H_INCLUDED
+
+#include "fstarray.h"
+// For class template FSTArray
+#include <cstddef>
+// For std::size_t
+#include <stdexcept>
+// For std::out_of_range
+
+// *********************************************************************
+// class FSTSlotMap - Class definition
+// *********************************************************************
+
+
+// class FSTSlotMap
+// Unordered container handing out generational handles to its items.
+// Items are kept densely packed in an FSTArray, so iteration is over
+//  contiguous memory. Erase moves the last item into the hole
+//  (swap-and-pop), which is O(1) and leaves every other handle valid.
+//  A handle to an erased item never becomes valid again, even after its
+//  slot is reused, since reuse bumps the slot's generation.
+// Dense indices (positions in [begin(), end())) and iterators ARE
+//  invalidated by insert & erase; handles are the stable name.
+// Invariants:
+//     _values.size() == _denseToSlot.size().
+//     For each dense index d: _slots[_denseToSlot[d]].dense == d.
+//     Slots not referenced by _denseToSlot form a singly linked free
+//      list through Slot::dense, starting at _freeHead, ending in NONE.
+//
+// value_type = value type of items
+template <typename valType>
+class FSTSlotMap {
+
+// ***** FSTSlotMap: types *****
+public:
+
+    // value_type: type of data items
+    using value_type = valType;
+    // size_type: type of sizes, indices & generations
+    using size_type = std::size_t;
+
+    // iterator, const_iterator: over the dense items, in no set order
+    using iterator = typename FSTArray<value_type>::iterator;
+    using const_iterator = typename FSTArray<value_type>::const_iterator;
+
+    // struct Handle
+    // Stable name for an item: slot index & generation.
+    struct Handle {
+        size_type index;
+        size_type generation;
+
+        bool operator==(const Handle & other) const noexcept
+        {
+            return index == other.index && generation == other.generation;
+        }
+
+        bool operator!=(const Handle & other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
+// ***** FSTSlotMap: internal-use types & constants *****
+private:
+
+    // struct Slot
+    // One entry of the slot table. When in use, dense is the item's
+    //  position in _values; when free, dense is the next free slot.
+    struct Slot {
+        size_type dense;
+        size_type generation;
+    };
+
+    // End of free list
+    static constexpr size_type NONE = size_type(-1);
+
+// ***** FSTSlotMap: ctors, op=, dctor *****
+public:
+
+    // Default ctor
+    // Strong Guarantee
+    FSTSlotMap()
+        :_values(0),
+         _denseToSlot(0),
+         _slots(0),
+         _freeHead(NONE)
+    {}
+
+    // Compiler-generated copy/move ctor, copy/move op=, dctor are used.
+    // They carry the Strong / No-Throw Guarantees of FSTArray.
+
+// ***** FSTSlotMap: general public operators *****
+public:
+
+    // operator[] - non-const & const
+    // Pre:
+    //     contains(h).
+    // No-Throw Guarantee
+    value_type & operator[](Handle h)
+    {
+        return _values[_slots[h.index].dense];
+    }
+
+    const value_type & operator[](Handle h) const
+    {
+        return _values[_slots[h.index].dense];
+    }
+
+// ***** FSTSlotMap: general public functions *****
+public:
+
+    // size
+    // No-Throw Guarantee
+    size_type size() const noexcept
+    {
+        return _values.size();
+    }
+
+    // empty
+    // No-Throw Guarantee
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    // begin, end - non-const & const
+    // Range of all items, contiguous, in no particular order.
+    // No-Throw Guarantee
+    iterator begin() noexcept
+    {
+        return _values.begin();
+    }
+    const_iterator begin() const noexcept
+    {
+        return _values.begin();
+    }
+
+    iterator end() noexcept
+    {
+        return _values.end();
+    }
+    const_iterator end() const noexcept
+    {
+        return _values.end();
+    }
+
+    // handleAt
+    // Return handle of the item at the given dense index.
+    // Pre:
+    //     denseIndex < size().
+    // No-Throw Guarantee
+    Handle handleAt(size_type denseIndex) const noexcept
+    {
+        size_type slot = _denseToSlot[denseIndex];
+        return Handle{ slot, _slots[slot].generation };
+    }
+
+    // contains
+    // Return true if h names an item currently in *this. A free slot
+    //  can match a handle's generation (e.g., a handle from another
+    //  map), so the slot must also be live: its item must map back to it.
+    // No-Throw Guarantee
+    bool contains(Handle h) const noexcept
+    {
+        if (h.index >= _slots.size()
+         || _slots[h.index].generation != h.generation)
+            return false;
+        size_type d = _slots[h.index].dense;
+        return d < _values.size() && _denseToSlot[d] == h.index;
+    }
+
+    // at - non-const & const
+    // Like operator[], but throws std::out_of_range if !contains(h).
+    // Strong Guarantee
+    value_type & at(Handle h)
+    {
+        if (!contains(h))
+            throw std::out_of_range("FSTSlotMap::at: stale handle");
+        return (*this)[h];
+    }
+
+    const value_type & at(Handle h) const
+    {
+        if (!contains(h))
+            throw std::out_of_range("FSTSlotMap::at: stale handle");
+        return (*this)[h];
+    }
+
+    // insert
+    // Add item; return its handle.
+    // Amortized O(1).
+    // Strong Guarantee
+    // Exception neutral
+    Handle insert(const value_type & item)
+    {
+        bool newSlot = (_freeHead == NONE);
+        size_type slot = newSlot ? _slots.size() : _freeHead;
+        if (newSlot)
+            _slots.push_back(Slot{ NONE, 0 });
+
+        try {
+            _values.push_back(item);
+            try {
+                _denseToSlot.push_back(slot);
+            }
+            catch (...) {
+                _values.pop_back();
+                throw;
+            }
+        }
+        catch (...) {
+            // A slot we added is unused; drop it again
+            if (newSlot)
+                _slots.pop_back();
+            throw;
+        }
+
+        if (!newSlot)
+            _freeHead = _slots[slot].dense;
+        _slots[slot].dense = _values.size() - 1;
+        return Handle{ slot, _slots[slot].generation };
+    }
+
+    // erase
+    // Remove the item named by h. The last item moves into its place.
+    // O(1).
+    // Throws std::out_of_range if !contains(h).
+    // Strong Guarantee
+    // Exception neutral
+    void erase(Handle h)
+    {
+        if (!contains(h))
+            throw std::out_of_range("FSTSlotMap::erase: stale handle");
+
+        size_type hole = _slots[h.index].dense;
+        size_type last = _values.size() - 1;
+        if (hole != last)
+        {
+            // Only this copy can throw; nothing has changed before it
+            _values[hole] = _values[last];
+            size_type movedSlot = _denseToSlot[last];
+            _denseToSlot[hole] = movedSlot;
+            _slots[movedSlot].dense = hole;
+        }
+        _values.pop_back();
+        _denseToSlot.pop_back();
+
+        ++_slots[h.index].generation;
+        _slots[h.index].dense = _freeHead;
+        _freeHead = h.index;
+    }
+
+    // swap
+    // No-Throw Guarantee
+    void swap(FSTSlotMap & other) noexcept
+    {
+        _values.swap(other._values);
+        _denseToSlot.swap(other._denseToSlot);
+        _slots.swap(other._slots);
+        std::swap(_freeHead, other._freeHead);
+    }
+
+// ***** FSTSlotMap: data members *****
+private:
+
+    FSTArray<value_type> _values;       // Items, densely packed
+    FSTArray<size_type>  _denseToSlot;  // Slot of each dense item
+    FSTArray<Slot>       _slots;        // Slot table, indexed by handle
+    size_type            _freeHead;     // First free slot, or NONE
+
+};  // End class FSTSlotMap
+
+
+#endif  //#ifndef FILE_FSTSLOTMAP_H_INCLUDED
+
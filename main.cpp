@@ -2,16 +2,39 @@
 using std::cout;
 using std::endl;
 // fstarray_test.cpp doctest.h fstarray.h
+// Registry demo: every FSTArray in this program is tracked
+#define FSTARRAY_REGISTRY
 #include "fstarray.h"
+#include <vector>
+#include <string>
 
 int main() {
     FSTArray<int> a(10);
     FSTArray<int> b(a);
-    for(auto i=0; i< a.size(); i++){
+    for(std::size_t i=0; i< a.size(); i++){
         std::cout <<i<<std::endl;
         std::cout << a[i]<<std::endl;
         std::cout << b[i]<<std::endl;
     }
 
+    // A burst: arrays grow big, then mostly drain. Their capacity stays.
+    std::vector<FSTArray<double>> queues(100);
+    for (std::size_t k = 0; k < queues.size(); ++k) {
+        for (int i = 0; i < 5000; ++i)
+            queues[k].push_back(i * 0.5);
+        queues[k].resize(k % 7 == 0 ? 4000 : 20);
+    }
+    FSTArray<std::string> names;
+    for (int i = 0; i < 1000; ++i)
+        names.push_back("name " + std::to_string(i));
+    names.resize(3);
+
+    cout << "\nAfter the burst:\n";
+    FSTRegistry::global().report(cout, 5);
+
+    std::size_t released = FSTRegistry::global().shrinkIdle();
+    cout << "\nshrinkIdle released " << released << " bytes\n\n";
+    FSTRegistry::global().report(cout, 5);
+
     return 0;
 }